@@ -17,11 +17,20 @@
  *   - TZ/DST must NOT affect scheduling here.
  *   - TZ/DST are console/UI concerns only.
  *
- * Updated: 2026-02-16
+ * Awake Idle:
+ *   - Awake but not allowed to sleep (console, door moving, debounce):
+ *     SLEEP_MODE_IDLE between passes, never a spin.
+ *   - Each pass computes its next deadline from the device timers,
+ *     the LED and the debouncer; Timer0, INT1 and console RX end the
+ *     idle early.
+ *   - The RTC is read once per wake, then at most every RTC_POLL_MS.
+ *
+ * Updated: 2026-10-16
  */
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include <util/delay.h>
 #include <avr/io.h>
 #include <avr/wdt.h>
@@ -36,15 +45,19 @@
 #include "uptime.h"
 #include "rtc.h"
 #include "solar.h"
+#include "solar_service.h"
+#include "solar_table.h"
 #include "platform/uart.h"
 #include "system_sleep.h"
 
-/* DST/TZ must not be used for scheduling here. */
-// #include "time_dst.h"
+/* DST/TZ must not be used for scheduling here: date math only. */
+#include "time_dst.h"   /* date_step() */
 
 #include "scheduler.h"
 #include "state_reducer.h"
 #include "schedule_apply.h"
+#include "wake_stats.h"
+#include "energy_stats.h"
 
 #include "devices/devices.h"
 #include "devices/led_state_machine.h"
@@ -72,6 +85,67 @@ ISR(INT1_vect)
 }
 
 
+/* ============================================================================
+ * AWAKE IDLE
+ * ========================================================================== */
+
+#define RTC_POLL_MS        1000u    /* awake: RTC read at most this often */
+#define DOOR_DEBOUNCE_MS     20u
+
+static inline void deadline_min(uint32_t *deadline, uint32_t t)
+{
+    if ((int32_t)(t - *deadline) < 0)
+        *deadline = t;
+}
+
+/*
+ * When the loop next has work while it cannot sleep.
+ */
+static uint32_t awake_deadline(uint32_t now_ms,
+                               uint32_t rtc_poll_ms,
+                               bool     debounce_active,
+                               uint32_t debounce_start_ms)
+{
+    uint32_t deadline = rtc_poll_ms;
+    uint32_t dev_ms;
+
+    /* Door travel / settle, LED carrier and blink edges */
+    if (devices_next_deadline(now_ms, &dev_ms))
+        deadline_min(&deadline, dev_ms);
+
+    if (debounce_active)
+        deadline_min(&deadline, debounce_start_ms + DOOR_DEBOUNCE_MS);
+
+    /* Held switch: INT1 stays masked until the loop sees the release */
+    if (gpio_door_sw_is_asserted())
+        deadline_min(&deadline, now_ms + DOOR_DEBOUNCE_MS);
+
+    return deadline;
+}
+
+/*
+ * SLEEP_MODE_IDLE until the deadline, a door edge or console input.
+ * An ISR landing between a check and system_idle() costs at most
+ * one Timer0 tick.
+ */
+static void idle_until(uint32_t deadline_ms, bool console)
+{
+    if (console)
+        uart_rx_wake_arm();
+
+    while (!uptime_reached(deadline_ms)) {
+
+        if (g_door_event)
+            break;
+
+        if (console && uart_rx_ready())
+            break;
+
+        system_idle();
+    }
+}
+
+
 /* ============================================================================
  * TIME HELPERS
  * ========================================================================== */
@@ -142,6 +216,7 @@ int main(void)
         led_state_machine_set(LED_BLINK, LED_RED);
         for (;;) {
             led_state_machine_tick(uptime_millis());
+            system_idle();
         }
     }
 
@@ -154,7 +229,11 @@ int main(void)
 
     device_init();
     scheduler_init();
-    (void)config_load(&g_cfg);
+
+    /* Saved location without its solar cache: built once devices idle */
+    if (config_load(&g_cfg) &&
+        solar_table_cache_needed(g_cfg.latitude_e4, g_cfg.longitude_e4))
+        solar_service_queue_build(g_cfg.latitude_e4, g_cfg.longitude_e4);
 
     led_state_machine_set(LED_BLINK, LED_GREEN, 4);
 
@@ -165,6 +244,11 @@ int main(void)
     uint16_t last_minute = 0xFFFF;
     uint32_t last_etag   = 0;
 
+    /* Last reduction, kept so clean devices are not re-reduced */
+    struct reduced_state rs;
+    memset(&rs, 0, sizeof(rs));
+    uint16_t last_eff_minute = 0xFFFF;
+
     struct solar_times sol;
     bool have_sol = false;
 
@@ -176,6 +260,10 @@ int main(void)
     int cached_y = 0, cached_mo = 0, cached_d = 0;
     int cached_h = 0, cached_m = 0, cached_s = 0;
 
+    bool     rtc_due     = true;    /* read on the next pass */
+    bool     rtc_set     = true;
+    uint32_t rtc_poll_ms = 0;
+
     for (;;) {
 
         uint32_t now_ms = uptime_millis();
@@ -196,12 +284,15 @@ int main(void)
                 in_config_mode = raw;
 
                 if (in_config_mode) {
+                    wake_stats_record(WAKE_CAUSE_CONFIG);
+                    energy_load_on(ENERGY_CONSOLE);
                     console_init();
                     reset_cause_debug_print();
                 } else {
                     mini_printf("Exiting console\n\n");
                     console_flush();
                     console_terminal_shutdown();
+                    energy_load_off(ENERGY_CONSOLE);
                 }
             }
         }
@@ -221,7 +312,7 @@ int main(void)
         }
 
         if (door_debounce_active) {
-            if ((uint32_t)(now_ms - door_debounce_start_ms) >= 20u) {
+            if ((uint32_t)(now_ms - door_debounce_start_ms) >= DOOR_DEBOUNCE_MS) {
                 door_debounce_active = 0u;
                 if (gpio_door_sw_is_asserted()) {
                     door_sm_toggle();
@@ -235,33 +326,68 @@ int main(void)
         }
 
         /* ------------------------------------------------------
-         * RTC required
+         * RTC (UTC authoritative): every wake, then polled
          * ------------------------------------------------------ */
 
-        if (rtc_time_is_set()) {
-            if (!rtc_valid) rtc_valid = true;
+        bool rtc_fresh = rtc_due ||
+                         (int32_t)(now_ms - rtc_poll_ms) >= 0 ||
+                         schedule_etag() != last_etag;
+
+        if (rtc_fresh) {
+
+            rtc_due     = false;
+            rtc_poll_ms = now_ms + RTC_POLL_MS;
+
+            bool was_set = rtc_set;
+            rtc_set = rtc_time_is_set();
+
+            if (rtc_set) {
+                if (!rtc_valid) rtc_valid = true;
+
+                rtc_get_time(&cached_y,
+                             &cached_mo,
+                             &cached_d,
+                             &cached_h,
+                             &cached_m,
+                             &cached_s);
+
+                /* Power-down time since the last read, day roll-up */
+                energy_rtc_sync(rtc_epoch_from_ymdhms(cached_y, cached_mo,
+                                                      cached_d, cached_h,
+                                                      cached_m, cached_s,
+                                                      0, false),
+                                now_ms);
+            } else if (was_set) {
+                led_state_machine_set(LED_BLINK, LED_RED);
+            }
         }
-        else
-        {
-            led_state_machine_set(LED_BLINK, LED_RED);
+
+        /* RTC required */
+        if (!rtc_set) {
+            idle_until(awake_deadline(now_ms, rtc_poll_ms,
+                                      door_debounce_active,
+                                      door_debounce_start_ms),
+                       in_config_mode);
             continue;
         }
 
-        /* ------------------------------------------------------
-         * Always refresh RTC (UTC authoritative)
-         * ------------------------------------------------------ */
+        uint16_t now_minute = minute_of_day(cached_h, cached_m);
 
-        rtc_get_time(&cached_y,
-                     &cached_mo,
-                     &cached_d,
-                     &cached_h,
-                     &cached_m,
-                     &cached_s);
+        /* Console may change the window; no-op unless it did */
+        scheduler_set_coalesce(g_cfg.coalesce_minutes,
+                               g_cfg.coalesce_early ? SCHED_COALESCE_EARLY
+                                                    : SCHED_COALESCE_LATE);
 
-        uint16_t now_minute = minute_of_day(cached_h, cached_m);
         uint32_t cur_etag   = schedule_etag();
 
-        bool minute_changed = (now_minute != last_minute);
+        /*
+         * Consecutive wakes can share a minute-of-day a day apart
+         * (tomorrow's first wake == today's): the date counts too.
+         */
+        bool minute_changed = (now_minute != last_minute ||
+                               cached_y   != last_y      ||
+                               cached_mo  != last_mo     ||
+                               cached_d   != last_d);
         bool schedule_dirty = (cur_etag != last_etag);
 
         /* ------------------------------------------------------
@@ -273,38 +399,80 @@ int main(void)
             last_minute = now_minute;
             last_etag   = cur_etag;
 
-            /* ---- Solar recompute if date changed ---- */
+            /* ---- Solar recompute if date or needed refs changed ---- */
 
-            if (cached_y != last_y ||
-                cached_mo != last_mo ||
-                cached_d != last_d) {
+            bool date_changed = (cached_y  != last_y  ||
+                                 cached_mo != last_mo ||
+                                 cached_d  != last_d);
 
-                have_sol = false;
+            /* Wake counters are kept per UTC day */
+            if (date_changed && last_y != -1)
+                wake_stats_new_day();
+
+            if (date_changed ||
+                scheduler_solar_pending(cached_y, cached_mo, cached_d)) {
 
-                if (g_cfg.latitude_e4 != 0 ||
-                    g_cfg.longitude_e4 != 0) {
+                /* Only the quantities some event references */
+                uint16_t sol_need = scheduler_solar_needs();
 
-                    double lat = (double)g_cfg.latitude_e4  / 10000.0;
-                    double lon = (double)g_cfg.longitude_e4 / 10000.0;
+                have_sol = false;
+
+                if (sol_need &&
+                    (g_cfg.latitude_e4 != 0 ||
+                     g_cfg.longitude_e4 != 0)) {
 
                     /*
                      * Scheduling must be DST-invariant.
                      *
-                     * Request solar times in UTC by forcing tz = 0.
+                     * Solar service (memoized table / compute) is UTC.
                      * (Any TZ/DST adjustments belong in console/UI only.)
                      */
-                    have_sol = solar_compute(
+                    have_sol = solar_service_get(
                         cached_y, cached_mo, cached_d,
-                        lat, lon,
-                        0,
+                        g_cfg.latitude_e4, g_cfg.longitude_e4,
+                        sol_need,
                         &sol
-                    );
+                    ) != 0;
                 }
 
                 scheduler_update_day(
                     cached_y, cached_mo, cached_d,
                     have_sol ? &sol : NULL,
-                    have_sol
+                    have_sol,
+                    sol_need
+                );
+
+                /*
+                 * Yesterday (carry-over after a reset) and tomorrow
+                 * (wrap target) with their own solar times.
+                 */
+                struct solar_times sol_prev, sol_next;
+                bool have_prev = false, have_next = false;
+
+                if (sol_need &&
+                    (g_cfg.latitude_e4 != 0 ||
+                     g_cfg.longitude_e4 != 0)) {
+
+                    int py = cached_y, pmo = cached_mo, pd = cached_d;
+                    int ny = cached_y, nmo = cached_mo, nd = cached_d;
+
+                    date_step(&py, &pmo, &pd, -1);
+                    date_step(&ny, &nmo, &nd, +1);
+
+                    have_prev = solar_service_get(
+                        py, pmo, pd,
+                        g_cfg.latitude_e4, g_cfg.longitude_e4,
+                        sol_need, &sol_prev) != 0;
+
+                    have_next = solar_service_get(
+                        ny, nmo, nd,
+                        g_cfg.latitude_e4, g_cfg.longitude_e4,
+                        sol_need, &sol_next) != 0;
+                }
+
+                scheduler_update_neighbors(
+                    have_prev ? &sol_prev : NULL, have_prev,
+                    have_next ? &sol_next : NULL, have_next
                 );
 
                 last_y  = cached_y;
@@ -324,51 +492,123 @@ int main(void)
 
             /* ---- Apply schedule ---- */
 
-            struct reduced_state rs;
+            /* EARLY coalescing runs the rest of the group now */
+            uint16_t eff_minute = scheduler_effective_minute(now_minute);
+
+            /*
+             * Only devices whose reduction can differ:
+             *  - edited / solar-affected / new day (scheduler dirty set)
+             *  - an event of theirs fell due since the last pass
+             */
+            uint8_t dirty = scheduler_take_dirty();
+
+            if (minute_changed) {
+                dirty |= (last_eff_minute == 0xFFFF)
+                    ? (uint8_t)SCHED_DIRTY_ALL
+                    : scheduler_devices_due(last_eff_minute, eff_minute);
+            }
+
+            last_eff_minute = eff_minute;
 
             size_t used = 0;
-            const Event *events = config_events_get(&used);
+            (void)config_events_get(&used);
 
-            if (events && used > 0) {
+            if (used > 0 && dirty) {
 
-                state_reducer_run(
-                    events,
-                    MAX_EVENTS,
-                    have_sol ? &sol : NULL,
-                    now_minute,
+                /* Compiled once per (date, ETag); per-device search only */
+                const uint8_t *dev_start = NULL;
+                const struct ResolvedEvent *by_dev =
+                    scheduler_timeline_by_device(&dev_start);
+
+                state_reducer_run_indexed(
+                    by_dev,
+                    dev_start,
+                    scheduler_carry_over(),
+                    dirty,
+                    eff_minute,
                     midnight_epoch,
                     &rs
                 );
 
-                schedule_apply(&rs);
+                for (uint8_t id = 0; id < STATE_REDUCER_MAX_DEVICES; id++) {
+                    if (dirty & (1u << id))
+                        schedule_apply_device(id, &rs);
+                }
             }
         }
 
         /* ------------------------------------------------------
-         * Sleep only in RUN mode
+         * Solar cache build owed by 'save' (devices were busy) or
+         * boot. Blocks for seconds: only with devices idle, and the
+         * RTC is read again after it
          * ------------------------------------------------------ */
 
-        if (in_config_mode)
+        if (!devices_busy() && solar_service_build_queued()) {
+            rtc_due = true;
             continue;
+        }
+
+        /* ------------------------------------------------------
+         * Sleep only in RUN mode; otherwise idle to the deadline
+         * ------------------------------------------------------ */
 
-        if (devices_busy() ||
+        if (in_config_mode ||
+            devices_busy() ||
             door_debounce_active ||
-            g_door_event)
+            g_door_event) {
+
+            idle_until(awake_deadline(now_ms, rtc_poll_ms,
+                                      door_debounce_active,
+                                      door_debounce_start_ms),
+                       in_config_mode);
             continue;
+        }
+
+        /* The alarm minute must come from this pass's RTC read */
+        if (!rtc_fresh) {
+            rtc_due = true;
+            continue;
+        }
 
         uint16_t next_min;
         uint16_t wake_min;
+        bool     tomorrow;
+        enum wake_cause planned;
 
-        if (scheduler_next_event_minute(now_minute, &next_min))
+        if (scheduler_next_wake_minute(now_minute, &next_min, &tomorrow) &&
+            !(tomorrow && next_min > now_minute)) {
             wake_min = next_min;
-        else
-            wake_min = next_minute(now_minute);
+            planned  = WAKE_CAUSE_EVENT;
+        } else if (tomorrow) {
+            /*
+             * Tomorrow's first wake is later in the day than now: the
+             * alarm matches HH:MM only and would fire today. Sleep to
+             * 00:00; the new day re-arms for it.
+             */
+            wake_min = 0;
+            planned  = WAKE_CAUSE_DAY;
+        } else {
+            /*
+             * Nothing scheduled (or nothing resolvable): housekeeping
+             * only. Sleep to the next UTC day boundary, where the date
+             * change recomputes solar and the plan; the door switch
+             * still wakes us through INT1.
+             */
+            wake_min = 0;
+            planned  = WAKE_CAUSE_DAY;
+        }
 
         (void)rtc_alarm_set_minute_of_day(wake_min);
         system_sleep_until(wake_min);
 
-        if (gpio_rtc_int_is_asserted())
+        rtc_due = true;
+
+        if (gpio_rtc_int_is_asserted()) {
             rtc_alarm_clear_flag();
+            wake_stats_record(planned);
+        } else {
+            wake_stats_record(WAKE_CAUSE_EXTERNAL);
+        }
 
         EIFR |= (uint8_t)((1u << INTF0) | (1u << INTF1));
 
@@ -9,8 +9,12 @@
  *  - Deterministic behavior
  *  - EEPROM contents are untrusted
  *  - Config is self-describing (magic + version + checksum)
+ *  - Image: header (struct config up to events, verbatim), then the
+ *    event table packed EVENT_PACKED_BYTES per slot, then the checksum.
+ *    128 slots = 768 bytes (unpacked they would need 1408)
+ *  - Loaded and saved slot by slot: no second struct config on the stack
  *
- * Updated: 2026-01-05
+ * Updated: 2026-10-16
  */
 
 #include "config.h"
@@ -18,12 +22,19 @@
 #include <avr/eeprom.h>
 #include <stddef.h>
 
+/* Identity is written from constants, not from the caller's copy */
+static_assert(offsetof(struct config, magic) == 0, "magic first");
+static_assert(offsetof(struct config, version) == sizeof(uint32_t), "version after magic");
+
+#define CONFIG_HDR_REST  (offsetof(struct config, version) + 1)
+
 /* --------------------------------------------------------------------------
  * EEPROM storage
  * -------------------------------------------------------------------------- */
 
-/* Single-slot EEPROM storage for full config */
-static struct config EEMEM ee_cfg;
+static uint8_t  EEMEM ee_cfg_hdr[CONFIG_HDR_BYTES];
+static uint8_t  EEMEM ee_cfg_events[MAX_EVENTS][EVENT_PACKED_BYTES];
+static uint16_t EEMEM ee_cfg_checksum;
 
 /* --------------------------------------------------------------------------
  * Public API
@@ -31,26 +42,30 @@ static struct config EEMEM ee_cfg;
 
 bool config_load(struct config *cfg)
 {
-    struct config tmp;
-
-    /* Read raw config from EEPROM */
-    eeprom_read_block(&tmp, &ee_cfg, sizeof(tmp));
+    /* Read raw header straight into cfg; replaced by defaults on failure */
+    eeprom_read_block(cfg, ee_cfg_hdr, CONFIG_HDR_BYTES);
 
     /* Validate identity */
-    if (tmp.magic != CONFIG_MAGIC ||
-        tmp.version != CONFIG_VERSION) {
+    if (cfg->magic != CONFIG_MAGIC ||
+        cfg->version != CONFIG_VERSION) {
 
         /* Fresh EEPROM or incompatible layout */
         config_defaults(cfg);
         return false;
     }
 
+    uint16_t computed = config_fletcher16(cfg, CONFIG_HDR_BYTES);
+
+    for (uint8_t i = 0; i < MAX_EVENTS; i++) {
+        uint8_t b[EVENT_PACKED_BYTES];
+
+        eeprom_read_block(b, ee_cfg_events[i], EVENT_PACKED_BYTES);
+        computed = config_fletcher16_continue(computed, b, EVENT_PACKED_BYTES);
+        config_event_unpack(b, i, &cfg->events[i]);
+    }
+
     /* Validate checksum */
-    uint16_t stored = tmp.checksum;
-    uint16_t computed = config_fletcher16(
-        &tmp,
-        offsetof(struct config, checksum)
-    );
+    uint16_t stored = eeprom_read_word(&ee_cfg_checksum);
 
     if (stored != computed) {
         /* Corrupt EEPROM contents */
@@ -59,25 +74,38 @@ bool config_load(struct config *cfg)
     }
 
     /* Accept config */
-    *cfg = tmp;
+    cfg->checksum = stored;
     return true;
 }
 
 void config_save(const struct config *cfg)
 {
-    struct config tmp = *cfg;
+    const uint32_t magic   = CONFIG_MAGIC;
+    const uint8_t  version = CONFIG_VERSION;
 
     /* Ensure identity is correct */
-    tmp.magic   = CONFIG_MAGIC;
-    tmp.version = CONFIG_VERSION;
-
-    /* Compute checksum */
-    tmp.checksum = 0;
-    tmp.checksum = config_fletcher16(
-        &tmp,
-        offsetof(struct config, checksum)
-    );
-
-    /* Write atomically */
-    eeprom_update_block(&tmp, &ee_cfg, sizeof(tmp));
+    eeprom_update_block(&magic, &ee_cfg_hdr[offsetof(struct config, magic)],
+                        sizeof(magic));
+    eeprom_update_byte(&ee_cfg_hdr[offsetof(struct config, version)], version);
+
+    const uint8_t *rest = (const uint8_t *)cfg + CONFIG_HDR_REST;
+    eeprom_update_block(rest, &ee_cfg_hdr[CONFIG_HDR_REST],
+                        CONFIG_HDR_BYTES - CONFIG_HDR_REST);
+
+    /* Checksum the image exactly as written */
+    uint16_t sum = config_fletcher16(&magic, sizeof(magic));
+    sum = config_fletcher16_continue(sum, &version, sizeof(version));
+    sum = config_fletcher16_continue(sum, rest, CONFIG_HDR_BYTES - CONFIG_HDR_REST);
+
+    for (uint8_t i = 0; i < MAX_EVENTS; i++) {
+        uint8_t b[EVENT_PACKED_BYTES];
+
+        /* Mutators only admit packable events */
+        (void)config_event_pack(&cfg->events[i], b);
+
+        eeprom_update_block(b, ee_cfg_events[i], EVENT_PACKED_BYTES);
+        sum = config_fletcher16_continue(sum, b, EVENT_PACKED_BYTES);
+    }
+
+    eeprom_update_word(&ee_cfg_checksum, sum);
 }
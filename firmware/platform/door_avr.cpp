@@ -9,9 +9,10 @@
  *  - Direction via INA / INB
  *  - Power gated via EN (used as digital enable, no PWM)
  *  - No timing, no state, no policy
+ *  - Motor on/off is reported to energy_stats
  *  - Masked PORTA writes only
  *
- * Updated: 2026-02-03
+ * Updated: 2026-10-16
  */
 
 #include <avr/io.h>
@@ -19,6 +20,7 @@
 
 #include "door_hw.h"
 #include "gpio_avr.h"
+#include "energy_stats.h"
 
 /* --------------------------------------------------------------------------
  * Internal helpers (masked writes only)
@@ -87,12 +89,14 @@ void door_hw_enable(void)
 {
     door_hw_init_once();
     set_bits(1u << DOOR_EN_BIT);
+    energy_load_on(ENERGY_DOOR_MOTOR);
 }
 
 void door_hw_disable(void)
 {
     door_hw_init_once();
     clear_bits(1u << DOOR_EN_BIT);
+    energy_load_off(ENERGY_DOOR_MOTOR);
 }
 
 void door_hw_stop(void)
@@ -103,4 +107,5 @@ void door_hw_stop(void)
     clear_bits((1u << DOOR_EN_BIT) |
                (1u << DOOR_INA_BIT) |
                (1u << DOOR_INB_BIT));
+    energy_load_off(ENERGY_DOOR_MOTOR);
 }
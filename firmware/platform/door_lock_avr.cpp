@@ -22,6 +22,7 @@
  *  - Blocking operation is REQUIRED and intentional
  *  - No timers, no interrupts, no background state
  *  - No dependency on scheduler cadence or main loop health
+ *  - Pulse on-time is reported to energy_stats
  *
  * SAFETY GUARANTEES
  * -----------------
@@ -44,7 +45,7 @@
  *  - H-bridge thermal failure
  *  - Board damage from software hangs
  *
- * Updated: 2026-02-03
+ * Updated: 2026-10-16
  */
 
 #include <avr/io.h>
@@ -54,6 +55,7 @@
 #include "door_lock.h"
 #include "gpio_avr.h"
 #include "config.h"
+#include "energy_stats.h"
 
 /*
  * HARD SAFETY LIMIT (milliseconds)
@@ -152,6 +154,7 @@ static void lock_pulse(uint8_t ina, uint8_t inb)
      * and pulse duration is known.
      */
     set_bits(1u << LOCK_EN_BIT);
+    energy_load_on(ENERGY_LOCK);
 
     /* Blocking delay: intentional and required for safety */
     while (ms--)
@@ -159,6 +162,7 @@ static void lock_pulse(uint8_t ina, uint8_t inb)
 
     /* Always shut down power before returning */
     door_lock_stop();
+    energy_load_off(ENERGY_LOCK);
 }
 
 void door_lock_engage(void)
@@ -21,16 +21,18 @@
  *  - Only one relay coil may be energized at a time
  *  - Pulse-driven, no holding current
  *  - Pulse width ~20 ms (datasheet max operate/reset ~10 ms)
+ *  - Coil on-time is reported to energy_stats
  *
  * Safety rules:
  *  - Masked bit operations ONLY
  *  - Never write whole PORTD or DDRD
  *  - Never touch PD0/PD1 (I2C)
  *
- * Updated: 2025-12-29
+ * Updated: 2026-10-16
  */
 
 #include "relay_hw.h"
+#include "energy_stats.h"
 
 #include <avr/io.h>
 #include <util/delay.h>
@@ -77,12 +79,14 @@ static inline void relay_pulse(uint8_t bit)
 
     /* Energize selected coil */
     PORTD |= (1 << bit);
+    energy_load_on(ENERGY_RELAY);
 
     /* Pulse width per relay datasheet */
     _delay_ms(RELAY_PULSE_MS);
 
     /* De-energize coil */
     PORTD &= ~(1 << bit);
+    energy_load_off(ENERGY_RELAY);
 }
 
 /* --------------------------------------------------------------------------
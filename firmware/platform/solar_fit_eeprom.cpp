@@ -0,0 +1,28 @@
+/*
+ * solar_fit_eeprom.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: EEPROM-backed storage for the harmonic solar model
+ *
+ * Notes:
+ *  - EEPROM contents are untrusted (solar_fit.cpp verifies them)
+ *
+ * Updated: 2026-10-16
+ */
+
+#include "solar_fit.h"
+
+#include <avr/eeprom.h>
+
+/* Single-slot EEPROM storage for the model */
+static struct solar_fit_model EEMEM ee_fit;
+
+void solar_fit_store_read(struct solar_fit_model *m)
+{
+    eeprom_read_block(m, &ee_fit, sizeof(*m));
+}
+
+void solar_fit_store_write(const struct solar_fit_model *m)
+{
+    eeprom_update_block(m, &ee_fit, sizeof(*m));
+}
@@ -0,0 +1,52 @@
+/*
+ * solar_table_eeprom.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: EEPROM-backed storage for the solar table
+ *
+ * Notes:
+ *  - EEPROM contents are untrusted (solar_table.cpp verifies them)
+ *  - eeprom_update_* only rewrites bytes that changed
+ *  - 2210 bytes; ATmega1284P has 4 KB EEPROM
+ *
+ * Updated: 2026-10-16
+ */
+
+#include "solar_table.h"
+
+#include <avr/eeprom.h>
+
+/* --------------------------------------------------------------------------
+ * EEPROM storage
+ * -------------------------------------------------------------------------- */
+
+static struct solar_table_hdr EEMEM ee_st_hdr;
+static uint8_t EEMEM ee_st_data[SOLAR_TABLE_DATA_BYTES];
+
+/* --------------------------------------------------------------------------
+ * Storage hooks
+ * -------------------------------------------------------------------------- */
+
+void solar_table_store_read_hdr(struct solar_table_hdr *hdr)
+{
+    eeprom_read_block(hdr, &ee_st_hdr, sizeof(*hdr));
+}
+
+void solar_table_store_write_hdr(const struct solar_table_hdr *hdr)
+{
+    eeprom_update_block(hdr, &ee_st_hdr, sizeof(*hdr));
+}
+
+void solar_table_store_read_day(uint16_t index, uint8_t buf[SOLAR_TABLE_DAY_BYTES])
+{
+    eeprom_read_block(buf,
+                      &ee_st_data[index * SOLAR_TABLE_DAY_BYTES],
+                      SOLAR_TABLE_DAY_BYTES);
+}
+
+void solar_table_store_write_day(uint16_t index, const uint8_t buf[SOLAR_TABLE_DAY_BYTES])
+{
+    eeprom_update_block(buf,
+                        &ee_st_data[index * SOLAR_TABLE_DAY_BYTES],
+                        SOLAR_TABLE_DAY_BYTES);
+}
@@ -6,14 +6,16 @@
  *
  * Wake source:
  *   RTC INT → PD2 (INT0)
+ *   Awake idle: any interrupt, Timer0 at the latest
  *
  * Design:
  *  - No policy
  *  - No scheduling
  *  - No RTC interaction
  *  - No logging
+ *  - Time in each sleep mode is reported to energy_stats
  *
- * Updated: 2026-02-08
+ * Updated: 2026-10-16
  */
 
 #include "system_sleep.h"
@@ -22,6 +24,7 @@
 #include <avr/interrupt.h>
 
 #include "gpio_avr.h"
+#include "energy_stats.h"
 
 /*
  * Initialize RTC wake line (PD2 / INT0).
@@ -46,6 +49,20 @@
  }
 
 
+/*
+ * Stop the CPU until the next interrupt; Timer0 bounds it to 1 ms.
+ */
+ void system_idle(void)
+ {
+     set_sleep_mode(SLEEP_MODE_IDLE);
+     sleep_enable();
+     sleep_cpu();
+     sleep_disable();
+
+     energy_idle_tick();
+ }
+
+
 /*
  * Enter PWR_DOWN until interrupt occurs.
  */
@@ -77,6 +94,8 @@
      cli();
      sleep_disable();
 
+     energy_power_down();
+
      /* Leave INT0/INT1 masked.
         Higher-level code decides when to re-arm. */
 
@@ -9,10 +9,14 @@
  *   Baud  = 38400
  *   Mode  = Normal speed (16x)
  *   Frame = 8N1
+ *
+ * Notes:
+ *   RX is polled; RXCIE0 is only armed as a one-shot idle wake
  */
 
 #include "uart.h"
 #include <avr/io.h>
+#include <avr/interrupt.h>
 
 #define BAUD_RATE 38400UL
 #define UBRR_VALUE ((F_CPU / (16UL * BAUD_RATE)) - 1)
@@ -55,6 +59,25 @@ void uart_shutdown(void)
     /* Leave frame format as-is. No need to touch UCSR0C. */
 }
 
+/*
+ * RX wake is one-shot: the ISR only disables itself, so the byte is
+ * still in UDR0 (RXC0 set) for the polled uart_getc().
+ */
+ISR(USART0_RX_vect)
+{
+    UCSR0B &= (uint8_t)~(1u << RXCIE0);
+}
+
+void uart_rx_wake_arm(void)
+{
+    UCSR0B |= (uint8_t)(1u << RXCIE0);
+}
+
+bool uart_rx_ready(void)
+{
+    return (UCSR0A & (1 << RXC0)) != 0;
+}
+
 int uart_getc(void)
 {
     if (!(UCSR0A & (1 << RXC0)))
@@ -9,13 +9,20 @@
  *  - Deterministic behavior
  *  - No network dependencies
  *
- * Updated: 2025-12-29
+ * Updated: 2026-10-16
  */
 
 #pragma once
+#include <stdbool.h>
+
 void uart_init(void);
 void uart_shutdown(void);
 
 int  uart_getc(void);
+
+/* One-shot RX wake: the next received byte ends SLEEP_MODE_IDLE.
+   The byte stays in UDR0 for uart_getc(). */
+void uart_rx_wake_arm(void);
+bool uart_rx_ready(void);
 void uart_putc(char c);
 void uart_flush_tx(void);
@@ -9,7 +9,7 @@
  *  - Deterministic behavior
  *  - No network dependencies
  *
- * Updated: 2025-12-29
+ * Updated: 2026-10-16
  */
 
 #include "uptime.h"
@@ -52,6 +52,11 @@ uint32_t uptime_millis(void)
     return ms;
 }
 
+bool uptime_reached(uint32_t deadline_ms)
+{
+    return (int32_t)(uptime_millis() - deadline_ms) >= 0;
+}
+
 uint32_t uptime_seconds(void)
 {
     return uptime_millis() / 1000;
@@ -15,14 +15,16 @@
  *  - Scheduler runs in UTC.
  *  - Solar scheduling uses UTC (tz = 0 when calling solar_compute).
  *
- *  - tz and honor_dst are for console/UI presentation only:
+ *  - tz and honor_dst are for console/UI presentation:
  *      display LOCAL time
  *      accept LOCAL time input (convert to UTC before writing RTC)
+ *    and for local wall-clock events (REF_LOCAL_MIDNIGHT), which the
+ *    scheduler maps to UTC once per day
  *
  *  - rtc_set_epoch is stored in UTC epoch seconds (2000 base) and is used
  *    only for drift tracking (time since last manual set).
  *
- * Updated: 2026-02-16
+ * Updated: 2026-10-16
  */
 
 #pragma once
@@ -30,10 +32,11 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include "config_events.h"
+#include "energy_stats.h"
 
 /* Config identity */
 #define CONFIG_MAGIC   0x434F4F50UL  /* 'COOP' */
-#define CONFIG_VERSION 2
+#define CONFIG_VERSION 5       /* 5: per-state currents for energy accounting */
 
 struct config {
     /* Identity */
@@ -51,15 +54,16 @@ struct config {
      * Example:
      *   Arkansas (CST) = -6
      *
-     * This value is used for console/UI conversion only.
-     * It must NOT affect scheduler or RTC storage.
+     * Used for console/UI conversion and for resolving local
+     * wall-clock events. It must NOT affect RTC storage.
      */
     int32_t tz;
 
     /*
-     * Apply US DST rule for console/UI presentation only.
+     * Apply US DST rule for console/UI presentation and local
+     * wall-clock events.
      *
-     * Must NOT affect scheduler or RTC storage.
+     * Must NOT affect RTC storage.
      */
     uint8_t honor_dst;          /* 0 or 1 */
 
@@ -77,21 +81,49 @@ struct config {
     uint16_t door_settle_ms;    /* delay after close before locking */
     uint16_t lock_settle_ms;    /* time after unlock before motion */
 
-    uint8_t _pad1[2];           /* align events */
+    /*
+     * Wake coalescing (scheduler).
+     *
+     * Events within coalesce_minutes of the first event of a group
+     * share one wake. Uses the former alignment pad: 0 (off, late)
+     * in configs saved before it existed.
+     */
+    uint8_t coalesce_minutes;   /* 0 = off, max 60 */
+    uint8_t coalesce_early;     /* 0 = wake at group's last event,
+                                   1 = wake at its first and pre-execute */
+
+    /*
+     * Board current per power state (energy_state), microamps.
+     * Estimates only: the console 'energy' command turns the time
+     * counters into mAh/day with them.
+     */
+    uint32_t energy_ua[ENERGY_STATE_COUNT];
 
-    /* Scheduler intent */
+    /*
+     * Scheduler intent.
+     *
+     * Unpacked working set in SRAM. EEPROM stores the fields above as
+     * is, then each slot in EVENT_PACKED_BYTES (config_event_pack()).
+     */
     struct Event events[MAX_EVENTS];
 
     /* Integrity */
-    uint16_t checksum;          /* Fletcher-16 over all fields above */
+    uint16_t checksum;          /* Fletcher-16 over the stored image
+                                   (fields above events, packed events) */
 };
 
+/* Bytes of struct config stored verbatim (everything before events) */
+#define CONFIG_HDR_BYTES offsetof(struct config, events)
+
 /* API */
 bool config_load(struct config *cfg);
 void config_save(const struct config *cfg);
 void config_defaults(struct config *cfg);
 
-/* Checksum helper */
+/* Checksum helpers */
 uint16_t config_fletcher16(const void *data, size_t len);
 
+/* Continue a checksum over more data (prev = result so far, 0 to start) */
+uint16_t config_fletcher16_continue(uint16_t prev, const void *data, size_t len);
+
 extern struct config g_cfg;
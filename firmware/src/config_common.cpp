@@ -9,7 +9,7 @@
  *  - Must not include AVR- or platform-specific headers
  *  - All fields initialized explicitly
  *
- * Updated: 2025-12-30
+ * Updated: 2026-10-16
  */
 
 #include "config.h"
@@ -22,10 +22,19 @@ struct config g_cfg;
  * Used for config persistence integrity (host + AVR)
  */
 uint16_t config_fletcher16(const void *data, size_t len)
+{
+    return config_fletcher16_continue(0, data, len);
+}
+
+/*
+ * Both running sums are < 255, so the previous result is the whole
+ * state: checksumming A then B in two calls equals one call over A+B.
+ */
+uint16_t config_fletcher16_continue(uint16_t prev, const void *data, size_t len)
 {
     const uint8_t *p = (const uint8_t *)data;
-    uint16_t sum1 = 0;
-    uint16_t sum2 = 0;
+    uint16_t sum1 = prev & 0xFF;
+    uint16_t sum2 = prev >> 8;
 
     while (len--) {
         sum1 = (sum1 + *p++) % 255;
@@ -58,5 +67,20 @@ void config_defaults(struct config *cfg)
       cfg->door_settle_ms = 2000;   /* allow gravity + obstruction to clear */
       cfg->lock_settle_ms = 500;    /* time after unlock before motion */
 
+    /* ---- Scheduler ---- */
+
+    cfg->coalesce_minutes = 0;      /* one wake per event */
+    cfg->coalesce_early   = 0;
+
+    /* ---- Energy model (uA; measure and 'set current' to refine) ---- */
+
+    cfg->energy_ua[ENERGY_PWR_DOWN]   = 30;
+    cfg->energy_ua[ENERGY_IDLE]       = 1200;
+    cfg->energy_ua[ENERGY_ACTIVE]     = 4000;
+    cfg->energy_ua[ENERGY_DOOR_MOTOR] = 900000;
+    cfg->energy_ua[ENERGY_LOCK]       = 600000;
+    cfg->energy_ua[ENERGY_RELAY]      = 75000;
+    cfg->energy_ua[ENERGY_CONSOLE]    = 1000;
+
     /* ---- Any future fields MUST be initialized here ---- */
 }
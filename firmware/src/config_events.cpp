@@ -12,10 +12,20 @@
  * - Inactive slots are fully zeroed (`refnum == 0` implies all fields cleared).
  *
  * @par Scheduler contract
- * Any mutation of the event table MUST call `schedule_touch()` to invalidate
+ * Any mutation of the event table MUST call `schedule_touch()` (or
+ * `schedule_touch_devices()` with the affected devices) to invalidate
  * scheduler caches and next-event reductions.
  *
- * Updated: 2026-01-08
+ * @par Device index
+ * Every mutation also rebuilds the per-device slot index so the reducer
+ * only visits the events of each device.
+ *
+ * @par Packed form
+ * EEPROM stores each slot in EVENT_PACKED_BYTES (config_event_pack());
+ * the mutators refuse events that would not survive the round trip, so
+ * a saved table always loads back identical.
+ *
+ * Updated: 2026-10-16
  */
 
 #include <string.h>
@@ -24,6 +34,86 @@
 #include "config.h"
 #include "scheduler.h"   /* schedule_touch() */
 
+/*
+ * Per-device slot index (CSR layout):
+ *   slots of device d are s_idx_slot[s_idx_start[d] .. s_idx_start[d+1]-1]
+ */
+static uint8_t s_idx_slot[MAX_EVENTS];
+static uint8_t s_idx_start[EVENT_INDEX_MAX_DEVICES + 1];
+static bool    s_idx_valid = false;
+
+/** @brief Dirty bit for a device (IDs outside the index affect none). */
+static uint8_t device_bit(uint8_t device_id)
+{
+    return (device_id < EVENT_INDEX_MAX_DEVICES)
+               ? (uint8_t)(1u << device_id) : 0u;
+}
+
+/**
+ * @brief Season fields are all zero, or two real month/day pairs.
+ *
+ * @details
+ * Feb 29 is accepted (leap-year seasons); non-leap years simply never
+ * see that date.
+ */
+static bool season_valid(const Event *ev)
+{
+    static const uint8_t mdays[12] = { 31,29,31,30,31,30,31,31,30,31,30,31 };
+
+    if (ev->from_mo == 0)
+        return ev->from_d == 0 && ev->to_mo == 0 && ev->to_d == 0;
+
+    return ev->from_mo <= 12 && ev->to_mo >= 1 && ev->to_mo <= 12 &&
+           ev->from_d >= 1 && ev->from_d <= mdays[ev->from_mo - 1] &&
+           ev->to_d   >= 1 && ev->to_d   <= mdays[ev->to_mo - 1];
+}
+
+/**
+ * @brief True if ev survives config_event_pack() / config_event_unpack().
+ */
+static bool event_packable(const Event *ev)
+{
+    /* Callers need not set refnum; pack as a used slot */
+    Event e = *ev;
+    e.refnum = 1;
+
+    uint8_t tmp[EVENT_PACKED_BYTES];
+    return config_event_pack(&e, tmp);
+}
+
+/**
+ * @brief Rebuilds the per-device index from the table (counting sort).
+ *
+ * @details
+ * O(MAX_EVENTS); runs on mutation only, never per wake. Slots stay in
+ * ascending order within a device.
+ */
+static void index_rebuild(void)
+{
+    uint8_t n[EVENT_INDEX_MAX_DEVICES];
+    memset(n, 0, sizeof(n));
+
+    for (size_t i = 0; i < MAX_EVENTS; i++) {
+        const Event *ev = &g_cfg.events[i];
+        if (ev->refnum != 0 && ev->device_id < EVENT_INDEX_MAX_DEVICES)
+            n[ev->device_id]++;
+    }
+
+    s_idx_start[0] = 0;
+    for (uint8_t d = 0; d < EVENT_INDEX_MAX_DEVICES; d++)
+        s_idx_start[d + 1] = (uint8_t)(s_idx_start[d] + n[d]);
+
+    memcpy(n, s_idx_start, sizeof(n));
+
+    for (size_t i = 0; i < MAX_EVENTS; i++) {
+        const Event *ev = &g_cfg.events[i];
+        if (ev->refnum != 0 && ev->device_id < EVENT_INDEX_MAX_DEVICES)
+            s_idx_slot[n[ev->device_id]++] = (uint8_t)i;
+    }
+
+    s_idx_valid = true;
+}
+
 
 /**
  * @brief Returns a pointer to the full sparse event table.
@@ -62,18 +152,19 @@ const Event *config_events_get(size_t *count)
  * @param[in] ev Event definition to insert.
  *
  * @retval true  Event inserted successfully.
- * @retval false `ev` is NULL or the table is full.
+ * @retval false `ev` is NULL, not packable, or the table is full.
  *
  * @details
  * Assigns a stable identity (`refnum`) to the inserted event. The `refnum`
  * is computed as `(index + 1)` and is guaranteed non-zero.
  *
  * @note
- * This function mutates schedule intent and MUST call `schedule_touch()`.
+ * This function mutates schedule intent and MUST call
+ * `schedule_touch_devices()` for the device(s) it affects.
  */
 bool config_events_add(const Event *ev)
 {
-    if (!ev)
+    if (!ev || !event_packable(ev))
         return false;
 
     for (size_t i = 0; i < MAX_EVENTS; i++) {
@@ -85,8 +176,9 @@ bool config_events_add(const Event *ev)
             /* Assign stable identity. */
             g_cfg.events[i].refnum = (refnum_t)(i + 1);
 
-            /* Schedule definition changed. */
-            schedule_touch();
+            /* Schedule definition changed (this device only). */
+            index_rebuild();
+            schedule_touch_devices(device_bit(ev->device_id));
 
             return true;
         }
@@ -103,26 +195,32 @@ bool config_events_add(const Event *ev)
  * @param[in] ev  New event definition.
  *
  * @retval true  Event updated.
- * @retval false Invalid arguments or `ref` not found.
+ * @retval false Invalid arguments, not packable, or `ref` not found.
  *
  * @details
  * The event identity (`refnum`) is preserved across update.
  *
  * @note
- * This function mutates schedule intent and MUST call `schedule_touch()`.
+ * This function mutates schedule intent and MUST call
+ * `schedule_touch_devices()` for the device(s) it affects.
  */
 bool config_events_update_by_refnum(refnum_t ref, const Event *ev)
 {
-    if (!ev || ref == 0)
+    if (!ev || ref == 0 || !event_packable(ev))
         return false;
 
     for (size_t i = 0; i < MAX_EVENTS; i++) {
         if (g_cfg.events[i].refnum == ref) {
 
+            /* Old and new device both change (device may move). */
+            uint8_t mask = (uint8_t)(device_bit(g_cfg.events[i].device_id) |
+                                     device_bit(ev->device_id));
+
             g_cfg.events[i] = *ev;
             g_cfg.events[i].refnum = ref;
 
-            schedule_touch();
+            index_rebuild();
+            schedule_touch_devices(mask);
             return true;
         }
     }
@@ -145,7 +243,8 @@ bool config_events_update_by_refnum(refnum_t ref, const Event *ev)
  * future inserts.
  *
  * @note
- * This function mutates schedule intent and MUST call `schedule_touch()`.
+ * This function mutates schedule intent and MUST call
+ * `schedule_touch_devices()` for the device(s) it affects.
  */
 bool config_events_delete_by_refnum(refnum_t ref)
 {
@@ -155,10 +254,13 @@ bool config_events_delete_by_refnum(refnum_t ref)
     for (size_t i = 0; i < MAX_EVENTS; i++) {
         if (g_cfg.events[i].refnum == ref) {
 
+            uint8_t mask = device_bit(g_cfg.events[i].device_id);
+
             /* Fully clear slot to preserve inactive-slot invariant. */
             memset(&g_cfg.events[i], 0, sizeof(g_cfg.events[i]));
 
-            schedule_touch();
+            index_rebuild();
+            schedule_touch_devices(mask);
             return true;
         }
     }
@@ -182,5 +284,145 @@ void config_events_clear(void)
     /* Zero entire table to preserve inactive-slot invariant. */
     memset(g_cfg.events, 0, sizeof(g_cfg.events));
 
+    index_rebuild();
     schedule_touch();
 }
+
+
+/**
+ * @brief Returns the used slots of one device, ascending.
+ *
+ * @param[in]  device_id Device to look up.
+ * @param[out] count     Receives the number of slots (required).
+ *
+ * @return Pointer into the index; valid until the next mutation.
+ *
+ * @note
+ * Builds the index on first use (boot config_load does not go through
+ * the mutators).
+ */
+const uint8_t *config_events_device_slots(uint8_t device_id, uint8_t *count)
+{
+    if (!s_idx_valid)
+        index_rebuild();
+
+    if (device_id >= EVENT_INDEX_MAX_DEVICES) {
+        if (count)
+            *count = 0;
+        return s_idx_slot;
+    }
+
+    if (count)
+        *count = (uint8_t)(s_idx_start[device_id + 1] - s_idx_start[device_id]);
+
+    return &s_idx_slot[s_idx_start[device_id]];
+}
+
+
+/**
+ * @brief Marks the device index stale after a wholesale table load.
+ *
+ * @note
+ * Does not call `schedule_touch()`; the loader decides that.
+ */
+void config_events_reindex(void)
+{
+    s_idx_valid = false;
+}
+
+
+/**
+ * @brief Encodes one slot for EEPROM (layout in config_events.h).
+ *
+ * @param[in]  ev  Event to encode; `refnum == 0` packs as unused.
+ * @param[out] out EVENT_PACKED_BYTES bytes.
+ *
+ * @retval false A field is outside its bit width; `out` is zeroed.
+ */
+bool config_event_pack(const Event *ev, uint8_t out[EVENT_PACKED_BYTES])
+{
+    memset(out, 0, EVENT_PACKED_BYTES);
+
+    if (!ev)
+        return false;
+
+    if (ev->refnum == 0)
+        return true;
+
+    /* Local midnight is REF_MIDNIGHT + the local bit */
+    uint8_t local = (ev->when.ref == REF_LOCAL_MIDNIGHT);
+    uint8_t ref   = local ? (uint8_t)REF_MIDNIGHT : (uint8_t)ev->when.ref;
+
+    if (ref > 0x0F ||
+        ev->when.offset_minutes < EVENT_OFFSET_MIN ||
+        ev->when.offset_minutes > EVENT_OFFSET_MAX ||
+        ev->device_id > EVENT_DEVICE_MAX ||
+        (uint8_t)ev->action > 1 ||
+        ev->weekdays > EVENT_DAYS_ALL ||
+        !season_valid(ev))
+        return false;
+
+    uint32_t lo = (uint32_t)ref
+                | ((uint32_t)((uint16_t)ev->when.offset_minutes & 0x0FFFu) << 4)
+                | ((uint32_t)ev->device_id << 16)
+                | ((uint32_t)ev->action << 19)
+                | (1UL << 20)
+                | ((uint32_t)ev->weekdays << 21)
+                | ((uint32_t)ev->from_mo << 28);
+
+    uint16_t hi = (uint16_t)(ev->from_d
+                | ((uint16_t)ev->to_mo << 5)
+                | ((uint16_t)ev->to_d << 9)
+                | ((uint16_t)local << 14));
+
+    out[0] = (uint8_t)(lo);
+    out[1] = (uint8_t)(lo >> 8);
+    out[2] = (uint8_t)(lo >> 16);
+    out[3] = (uint8_t)(lo >> 24);
+    out[4] = (uint8_t)(hi);
+    out[5] = (uint8_t)(hi >> 8);
+
+    return true;
+}
+
+
+/**
+ * @brief Decodes one slot read from EEPROM.
+ *
+ * @param[in]  in   EVENT_PACKED_BYTES bytes.
+ * @param[in]  slot Table index; sets `refnum = slot + 1` for used slots.
+ * @param[out] out  Decoded event, zeroed if the slot is unused.
+ */
+void config_event_unpack(const uint8_t in[EVENT_PACKED_BYTES],
+                         uint8_t slot, Event *out)
+{
+    memset(out, 0, sizeof(*out));
+
+    uint32_t lo = (uint32_t)in[0]
+                | ((uint32_t)in[1] << 8)
+                | ((uint32_t)in[2] << 16)
+                | ((uint32_t)in[3] << 24);
+    uint16_t hi = (uint16_t)(in[4] | (in[5] << 8));
+
+    if (!(lo & (1UL << 20)))
+        return;
+
+    /* Sign-extend the 12-bit offset */
+    int16_t off = (int16_t)((lo >> 4) & 0x0FFFu);
+    if (off & 0x0800)
+        off = (int16_t)(off - 0x1000);
+
+    out->when.ref            = (enum TimeRef)(lo & 0x0Fu);
+    out->when.offset_minutes = off;
+    out->device_id           = (uint8_t)((lo >> 16) & 0x07u);
+    out->action              = (enum Action)((lo >> 19) & 0x01u);
+    out->weekdays            = (uint8_t)((lo >> 21) & EVENT_DAYS_ALL);
+    out->from_mo             = (uint8_t)((lo >> 28) & 0x0Fu);
+    out->from_d              = (uint8_t)(hi & 0x1Fu);
+    out->to_mo               = (uint8_t)((hi >> 5) & 0x0Fu);
+    out->to_d                = (uint8_t)((hi >> 9) & 0x1Fu);
+    out->refnum              = (refnum_t)(slot + 1);
+
+    if (((hi >> 14) & 0x01u) && out->when.ref == REF_MIDNIGHT)
+        out->when.ref = REF_LOCAL_MIDNIGHT;
+}
@@ -10,8 +10,11 @@
  *  - refnum is the stable external identifier
  *  - Callers must iterate 0..MAX_EVENTS-1 and skip unused slots
  *  - Scheduler treats the table as read-only
+ *  - A per-device slot index is kept in step by the mutators
+ *  - The table lives unpacked in SRAM (g_cfg.events); EEPROM holds it
+ *    bit-packed, EVENT_PACKED_BYTES per slot (config_eeprom.cpp)
  *
- * Updated: 2026-01-08
+ * Updated: 2026-10-16
  * ========================================================================== */
 
 #pragma once
@@ -22,7 +25,13 @@
 
 #include "events.h"
 
-#define MAX_EVENTS 16
+#define MAX_EVENTS 128
+
+/* Slot indices and refnums are uint8_t */
+static_assert(MAX_EVENTS <= 255, "MAX_EVENTS must fit refnum_t");
+
+/* Device IDs covered by the per-device index (0..N-1) */
+#define EVENT_INDEX_MAX_DEVICES 8
 /* Accessor
  * Returns pointer to config-backed sparse event table (size MAX_EVENTS).
  * If count != NULL, *count is set to number of USED slots.
@@ -41,3 +50,45 @@ bool config_events_delete_by_refnum(refnum_t ref);
 
 /* Utilities */
 void config_events_clear(void);
+
+/* Per-device index
+ * Returns the slots (ascending) of the used events for device_id;
+ * *count receives how many. Devices without events, or IDs outside
+ * 0..EVENT_INDEX_MAX_DEVICES-1, return count 0.
+ *
+ * Maintained by the mutators above. Call config_events_reindex()
+ * after the table is replaced wholesale (config_load).
+ */
+const uint8_t *config_events_device_slots(uint8_t device_id, uint8_t *count);
+void config_events_reindex(void);
+
+/* Packed EEPROM encoding
+ *
+ * One slot = 48 bits, little-endian:
+ *   bits  0..3   when.ref            (TimeRef; REF_LOCAL_MIDNIGHT
+ *                                     is stored as REF_MIDNIGHT)
+ *   bits  4..15  when.offset_minutes (two's complement)
+ *   bits 16..18  device_id
+ *   bit  19      action
+ *   bit  20      used
+ *   bits 21..27  weekdays
+ *   bits 28..31  from_mo
+ *   bits 32..36  from_d
+ *   bits 37..40  to_mo
+ *   bits 41..45  to_d
+ *   bit  46      local (REF_LOCAL_MIDNIGHT)
+ *   bit  47      zero
+ *
+ * refnum is not stored: it is always slot + 1. An unused slot packs to
+ * all zero bytes and unpacks to a zeroed Event.
+ */
+#define EVENT_PACKED_BYTES 6
+
+#define EVENT_OFFSET_MIN  (-2048)
+#define EVENT_OFFSET_MAX  2047
+#define EVENT_DEVICE_MAX  7
+
+/* False if ev cannot be represented (mutators reject such events) */
+bool config_event_pack(const Event *ev, uint8_t out[EVENT_PACKED_BYTES]);
+void config_event_unpack(const uint8_t in[EVENT_PACKED_BYTES],
+                         uint8_t slot, Event *out);
@@ -32,6 +32,8 @@
 #include "rtc.h"
 #include "uptime.h"
 #include "config.h"
+#include "scheduler.h"
+#include "config_events.h"
 
 #include <string.h>
 
@@ -61,6 +63,10 @@ void console_init(void)
 
     // Load configuration
     bool cfg_ok = config_load(&g_cfg);
+
+    /* Reloaded event table: device index and timeline are stale */
+    config_events_reindex();
+    schedule_touch();
     if (!cfg_ok) {
         mini_printf("WARNING: CONFIG INVALID, USING DEFAULTS\n");
     }
@@ -53,6 +53,10 @@
 #include "next_event.h"
 
 #include "solar.h"
+#include "solar_table.h"
+#include "solar_fit.h"
+#include "solar_baked.h"
+#include "solar_service.h"
 #include "rtc.h"
 #include "config.h"
 #include "uptime.h"
@@ -63,6 +67,8 @@
 #include "devices/door_state_machine.h"
 #include "state_reducer.h"
 #include "system_sleep.h"
+#include "wake_stats.h"
+#include "energy_stats.h"
 
 #define DOOR_SW_BIT     PD3
 #define RTC_INT_BIT     PD2
@@ -116,6 +122,8 @@ static void cmd_door(int argc, char **argv);
 static void cmd_lock(int argc, char **argv);
 static void cmd_event(int argc, char **argv);
 static void cmd_sleep(int argc, char **argv);
+static void cmd_wakes(int argc, char **argv);
+static void cmd_energy(int argc, char **argv);
 
 
 // -----------------------------------------------------------------------------
@@ -137,6 +145,10 @@ static void ensure_cfg_loaded(void)
 
     config_load(&g_cfg);
     g_cfg_loaded = true;
+
+    /* Event table replaced: device index and timeline are stale */
+    config_events_reindex();
+    schedule_touch();
 }
 
 
@@ -364,7 +376,8 @@ static void when_print(const struct When *w, int tod_minute)
         console_puts("DISABLED");
         return;
 
-    case REF_MIDNIGHT: {
+    case REF_MIDNIGHT:
+    case REF_LOCAL_MIDNIGHT: {
         int hh24 = tod_minute / 60;
         int mm   = tod_minute % 60;
 
@@ -375,6 +388,9 @@ static void when_print(const struct When *w, int tod_minute)
             hh12 = 12;
 
         mini_printf("%02d:%02d %s", hh12, mm, ampm);
+
+        if (w->ref == REF_LOCAL_MIDNIGHT)
+            console_puts(" local");
         return;
     }
 
@@ -394,6 +410,26 @@ static void when_print(const struct When *w, int tod_minute)
         mini_printf("Dusk %c%d", sign, mins);
         return;
 
+    case REF_SOLAR_NAUT_RISE:
+        mini_printf("NautDawn %c%d", sign, mins);
+        return;
+
+    case REF_SOLAR_NAUT_SET:
+        mini_printf("NautDusk %c%d", sign, mins);
+        return;
+
+    case REF_SOLAR_ASTRO_RISE:
+        mini_printf("AstroDawn %c%d", sign, mins);
+        return;
+
+    case REF_SOLAR_ASTRO_SET:
+        mini_printf("AstroDusk %c%d", sign, mins);
+        return;
+
+    case REF_SOLAR_NOON:
+        mini_printf("Noon %c%d", sign, mins);
+        return;
+
     default:
         console_puts("?");
         return;
@@ -419,11 +455,154 @@ static bool parse_signed_int(const char *s, int *out)
     return true;
 }
 
+/*
+ * Calendar qualifiers (trailing tokens of `event add`):
+ *   days=mo,we,fr  days=mo-fr  days=weekdays  days=weekends
+ *   dates=MM/DD-MM/DD   (inclusive, may wrap the year end)
+ * Weekdays and dates are UTC, like the rest of the scheduler.
+ */
+static const char k_day_names[7][3] = {
+    "su", "mo", "tu", "we", "th", "fr", "sa"
+};
+
+static int day_index(const char *s, size_t n)
+{
+    if (n != 2)
+        return -1;
+
+    for (int i = 0; i < 7; i++) {
+        if (tolower((unsigned char)s[0]) == k_day_names[i][0] &&
+            tolower((unsigned char)s[1]) == k_day_names[i][1])
+            return i;
+    }
+
+    return -1;
+}
+
+static bool parse_days(const char *s, uint8_t *out)
+{
+    if (!strcmp(s, "weekdays")) {
+        *out = EVENT_DAY_MON | EVENT_DAY_TUE | EVENT_DAY_WED |
+               EVENT_DAY_THU | EVENT_DAY_FRI;
+        return true;
+    }
+
+    if (!strcmp(s, "weekends")) {
+        *out = EVENT_DAY_SAT | EVENT_DAY_SUN;
+        return true;
+    }
+
+    uint8_t mask = 0;
+
+    while (*s) {
+        const char *comma = strchr(s, ',');
+        size_t len = comma ? (size_t)(comma - s) : strlen(s);
+
+        const char *dash = (const char *)memchr(s, '-', len);
+        int a, b;
+
+        if (dash) {
+            a = day_index(s, (size_t)(dash - s));
+            b = day_index(dash + 1, len - (size_t)(dash - s) - 1);
+        } else {
+            a = b = day_index(s, len);
+        }
+
+        if (a < 0 || b < 0)
+            return false;
+
+        /* Range may wrap the week (fr-mo) */
+        for (int i = a; ; i = (i + 1) % 7) {
+            mask |= (uint8_t)(1u << i);
+            if (i == b)
+                break;
+        }
+
+        s += len;
+        if (*s == ',')
+            s++;
+    }
+
+    if (mask == 0)
+        return false;
+
+    *out = (mask == EVENT_DAYS_ALL) ? 0 : mask;
+    return true;
+}
+
+/* MM/DD */
+static bool parse_month_day(const char *s, const char **end,
+                            uint8_t *mo, uint8_t *d)
+{
+    char *e = NULL;
+    long m = strtol(s, &e, 10);
+
+    if (e == s || *e != '/' || m < 1 || m > 12)
+        return false;
+
+    s = e + 1;
+    long dd = strtol(s, &e, 10);
+
+    if (e == s || dd < 1 || dd > days_in_month(2028, (int)m))  /* leap: 02/29 ok */
+        return false;
+
+    *mo  = (uint8_t)m;
+    *d   = (uint8_t)dd;
+    *end = e;
+    return true;
+}
+
+static bool parse_qualifier(const char *tok, Event *ev)
+{
+    if (!strncmp(tok, "days=", 5))
+        return parse_days(tok + 5, &ev->weekdays);
+
+    if (!strncmp(tok, "dates=", 6)) {
+        const char *s = tok + 6;
+
+        if (!parse_month_day(s, &s, &ev->from_mo, &ev->from_d) || *s != '-')
+            return false;
+
+        if (!parse_month_day(s + 1, &s, &ev->to_mo, &ev->to_d) || *s != '\0')
+            return false;
+
+        return true;
+    }
+
+    return false;
+}
+
+static void quals_print(const Event *ev)
+{
+    if (ev->weekdays) {
+        console_puts("  days=");
+
+        bool first = true;
+        for (int i = 0; i < 7; i++) {
+            if (!(ev->weekdays & (1u << i)))
+                continue;
+            if (!first)
+                console_putc(',');
+            console_puts(k_day_names[i]);
+            first = false;
+        }
+    }
+
+    if (ev->from_mo) {
+        mini_printf("  dates=%02u/%02u-%02u/%02u",
+                    (unsigned)ev->from_mo, (unsigned)ev->from_d,
+                    (unsigned)ev->to_mo, (unsigned)ev->to_d);
+    }
+}
+
 static bool compute_today_solar(struct solar_times *out)
 {
     if (!out)
         return false;
 
+    /* Callers read valid_mask even on failure */
+    memset(out, 0, sizeof(*out));
+
     int y, mo, d, h;
 
     if (!rtc_time_is_set())
@@ -432,22 +611,40 @@ static bool compute_today_solar(struct solar_times *out)
     /* RTC now returns UTC */
     rtc_get_time(&y, &mo, &d, &h, NULL, NULL);
 
-    double lat = (double)g_cfg.latitude_e4 / 10000.0;
-    double lon = (double)g_cfg.longitude_e4 / 10000.0;
-
     /*
      * Scheduling must be DST-invariant.
      * Always request solar times in UTC.
+     *
+     * Shared, memoized service: the main loop has usually computed
+     * today already. Twilight / noon refs are included when an event
+     * uses them; out->valid_mask tells resolve_when() what is usable,
+     * so events may resolve even when this returns false.
      */
-    return solar_compute(
+    uint16_t got = solar_service_get(
         y,
         mo,
         d,
-        lat,
-        lon,
-        0,
+        g_cfg.latitude_e4,
+        g_cfg.longitude_e4,
+        SOLAR_Q_STD_CIV | scheduler_solar_needs(),
         out
     );
+
+    return (got & SOLAR_Q_STD_CIV) == SOLAR_Q_STD_CIV;
+}
+
+/* Today's (UTC) offsets for local wall-clock events (zero if RTC unset) */
+static void today_utc_offset(struct day_utc_offset *out)
+{
+    if (!rtc_time_is_set()) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+
+    int y, mo, d;
+    rtc_get_time(&y, &mo, &d, NULL, NULL, NULL);
+
+    day_utc_offset_get(y, mo, d, out);
 }
 
 // -----------------------------------------------------------------------------
@@ -520,11 +717,74 @@ static void cmd_time(int, char **)
     console_putc('\n');
 }
 
-static void cmd_solar(int argc, char **argv)
+/* UTC minute-of-day on (y, mo, d) → local minute-of-day (DST per day) */
+static uint16_t solar_local_minute(int y, int mo, int d, uint16_t utc_min)
 {
-    (void)argc;
-    (void)argv;
+    int m = (int)utc_min + utc_offset_minutes(y, mo, d, utc_min / 60);
+
+    return (uint16_t)((m + 2 * 1440) % 1440);
+}
+
+/*
+ * solar <days>
+ *
+ * Multi-day forecast via solar_compute_range(), computed in chunks so
+ * RAM stays bounded regardless of the day count. Local times, DST
+ * applied per day.
+ */
+#define SOLAR_FORECAST_MAX_DAYS 60
+#define SOLAR_FORECAST_CHUNK    8
+
+static void solar_forecast(int y, int mo, int d, int ndays)
+{
+    console_puts("Date          Rise      Set       Dawn      Dusk      Day\n");
+
+    while (ndays > 0) {
+
+        uint8_t n = (ndays > SOLAR_FORECAST_CHUNK)
+                  ? SOLAR_FORECAST_CHUNK : (uint8_t)ndays;
+
+        struct solar_times sol[SOLAR_FORECAST_CHUNK];
+        bool ok[SOLAR_FORECAST_CHUNK];
+
+        /* UTC, like every other scheduler-facing solar call */
+        solar_compute_range(y, mo, d, n,
+                            g_cfg.latitude_e4, g_cfg.longitude_e4,
+                            0, sol, ok);
+
+        for (uint8_t i = 0; i < n; i++) {
+
+            mini_printf("%u-%02u-%02u  ", y, mo, d);
 
+            if (!ok[i]) {
+                console_puts("(no sunrise/sunset)\n");
+            } else {
+                print_hhmm(solar_local_minute(y, mo, d, sol[i].sunrise_std));
+                console_puts("  ");
+                print_hhmm(solar_local_minute(y, mo, d, sol[i].sunset_std));
+                console_puts("  ");
+                print_hhmm(solar_local_minute(y, mo, d, sol[i].sunrise_civ));
+                console_puts("  ");
+                print_hhmm(solar_local_minute(y, mo, d, sol[i].sunset_civ));
+                mini_printf("  %u:%02u\n",
+                            sol[i].day_length / 60, sol[i].day_length % 60);
+            }
+
+            if (++d > days_in_month(y, mo)) {
+                d = 1;
+                if (++mo > 12) {
+                    mo = 1;
+                    y++;
+                }
+            }
+        }
+
+        ndays -= n;
+    }
+}
+
+static void cmd_solar(int argc, char **argv)
+{
     ensure_cfg_loaded();
 
     if (!rtc_time_is_set()) {
@@ -535,17 +795,23 @@ static void cmd_solar(int argc, char **argv)
     int y, mo, d, h;
     rtc_get_time(&y, &mo, &d, &h, NULL, NULL);
 
-    float lat = g_cfg.latitude_e4 * 1e-4f;
-    float lon = g_cfg.longitude_e4 * 1e-4f;
+    if (argc == 2) {
+        int days;
+
+        if (!parse_signed_int(argv[1], &days) ||
+            days < 1 || days > SOLAR_FORECAST_MAX_DAYS) {
+            mini_printf("usage: solar [1..%u]\n", SOLAR_FORECAST_MAX_DAYS);
+            return;
+        }
+
+        solar_forecast(y, mo, d, days);
+        return;
+    }
 
     struct solar_times sol;
 
     /* Solar times returned in UTC minutes */
-    if (!solar_compute(y, mo, d,
-                       lat,
-                       lon,
-                       0,
-                       &sol)) {
+    if (!compute_today_solar(&sol)) {
         console_puts("SOLAR: UNAVAILABLE\n");
         return;
     }
@@ -578,12 +844,214 @@ static void cmd_solar(int argc, char **argv)
     console_putc('\n');
 }
 
+/* --------------------------------------------------------------------------
+ * schedule project <days>
+ *
+ * Replays the main loop over future UTC days with the real scheduler:
+ * each day is loaded the way the main loop loads a new date (own solar
+ * times for it and its neighbours, qualifiers compiled), so the
+ * timeline, wake plan and carry-over are that day's compiled plan.
+ * Wakes follow scheduler_next_wake_minute() from wake to wake, and the
+ * reducer runs once per wake at its effective minute, exactly as the
+ * device would. Cost is one compile per day and one reduction per
+ * wake, never a per-minute scan.
+ *
+ * The scheduler is pointed back at today when done (the main loop
+ * sees the ETag move and re-reduces, with no change of state).
+ * -------------------------------------------------------------------------- */
 
-static void cmd_schedule(int argc, char **argv)
+#define SCHEDULE_PROJECT_MAX_DAYS 31
+
+/* Point the scheduler at UTC day (y, mo, d), as the main loop does */
+static void schedule_load_day(int y, int mo, int d)
 {
-    (void)argc;
-    (void)argv;
+    uint16_t need = scheduler_solar_needs();
+    bool have_loc = (g_cfg.latitude_e4 != 0 || g_cfg.longitude_e4 != 0);
+
+    struct solar_times sol, sol_prev, sol_next;
+    bool have_sol = false, have_prev = false, have_next = false;
+
+    if (need && have_loc) {
+
+        int py = y, pmo = mo, pd = d;
+        int ny = y, nmo = mo, nd = d;
+
+        date_step(&py, &pmo, &pd, -1);
+        date_step(&ny, &nmo, &nd, +1);
+
+        have_sol  = solar_service_get(y, mo, d,
+                                      g_cfg.latitude_e4, g_cfg.longitude_e4,
+                                      need, &sol) != 0;
+        have_prev = solar_service_get(py, pmo, pd,
+                                      g_cfg.latitude_e4, g_cfg.longitude_e4,
+                                      need, &sol_prev) != 0;
+        have_next = solar_service_get(ny, nmo, nd,
+                                      g_cfg.latitude_e4, g_cfg.longitude_e4,
+                                      need, &sol_next) != 0;
+    }
+
+    scheduler_update_day(y, mo, d, have_sol ? &sol : NULL, have_sol, need);
+    scheduler_update_neighbors(have_prev ? &sol_prev : NULL, have_prev,
+                               have_next ? &sol_next : NULL, have_next);
+}
+
+/* "YYYY-MM-DD HH:MM" local, for UTC minute-of-day on (y, mo, d) */
+static void print_local_stamp(int y, int mo, int d, uint16_t utc_min)
+{
+    int m = (int)utc_min + utc_offset_minutes(y, mo, d, utc_min / 60);
+
+    if (m < 0) {
+        m += 1440;
+        date_step(&y, &mo, &d, -1);
+    } else if (m >= 1440) {
+        m -= 1440;
+        date_step(&y, &mo, &d, +1);
+    }
+
+    mini_printf("%u-%02u-%02u ", y, mo, d);
+    print_hhmm((uint16_t)m);
+}
+
+/*
+ * Reduce every device at the wake's effective minute and track the
+ * ones whose action changed (printed if print). Returns the count.
+ */
+static uint8_t project_reduce(uint16_t wake, struct reduced_state *rs,
+                              bool *have, enum Action *act, bool print)
+{
+    const uint8_t *start = NULL;
+    const struct ResolvedEvent *by_dev = scheduler_timeline_by_device(&start);
 
+    /* Phase identity ('when') is not used here */
+    state_reducer_run_indexed(by_dev, start, scheduler_carry_over(),
+                              SCHED_DIRTY_ALL,
+                              scheduler_effective_minute(wake),
+                              0, rs);
+
+    uint8_t n = 0;
+
+    for (uint8_t id = 0; id < STATE_REDUCER_MAX_DEVICES; id++) {
+
+        if (!rs->has_action[id])
+            continue;
+
+        if (have[id] && act[id] == rs->action[id])
+            continue;
+
+        have[id] = true;
+        act[id]  = rs->action[id];
+
+        if (!print)
+            continue;
+
+        const char *dev = "?";
+        const char *state = "?";
+
+        device_name(id, &dev);
+        device_get_state_string(id,
+                                (act[id] == ACTION_ON) ? DEV_STATE_ON
+                                                       : DEV_STATE_OFF,
+                                &state);
+
+        mini_printf("  %s %s", dev, state);
+        n++;
+    }
+
+    return n;
+}
+
+static void schedule_project(int ndays)
+{
+    int y, mo, d, h, m;
+    rtc_get_time(&y, &mo, &d, &h, &m, NULL);
+
+    /* Same window the main loop uses */
+    scheduler_set_coalesce(g_cfg.coalesce_minutes,
+                           g_cfg.coalesce_early ? SCHED_COALESCE_EARLY
+                                                : SCHED_COALESCE_LATE);
+
+    mini_printf("Projection, %u days (local time, window %u min, %s):\n",
+                (unsigned)ndays,
+                (unsigned)g_cfg.coalesce_minutes,
+                g_cfg.coalesce_early ? "early" : "late");
+
+    const int sy = y, smo = mo, sd = d;
+
+    struct reduced_state rs;
+    bool        have[STATE_REDUCER_MAX_DEVICES];
+    enum Action act[STATE_REDUCER_MAX_DEVICES];
+
+    memset(have, 0, sizeof(have));
+    memset(act, 0, sizeof(act));
+
+    /* Current state: the baseline, not printed */
+    uint16_t cur = (uint16_t)(h * 60 + m);
+
+    schedule_load_day(y, mo, d);
+    (void)project_reduce(cur, &rs, have, act, false);
+
+    unsigned wakes = 0, day_wakes = 0;
+
+    /* Wake owed at the start of the day: wrap target or 00:00 */
+    bool     pending = false;
+    bool     pending_day = false;
+    uint16_t pending_min = 0;
+
+    for (int day = 0; day < ndays; day++) {
+
+        if (day > 0) {
+            date_step(&y, &mo, &d, +1);
+            schedule_load_day(y, mo, d);
+            cur = 0;
+        }
+
+        for (;;) {
+
+            uint16_t w;
+            bool     tomorrow;
+
+            if (pending) {
+                w = pending_min;
+                pending = false;
+
+                if (pending_day)
+                    day_wakes++;
+            } else if (!scheduler_next_wake_minute(cur, &w, &tomorrow)) {
+                /* Nothing resolvable: main loop sleeps to 00:00 UTC */
+                pending     = true;
+                pending_day = true;
+                pending_min = 0;
+                break;
+            } else if (tomorrow) {
+                /* Wrapped: tomorrow's first event, via 00:00 if later */
+                pending     = true;
+                pending_day = (w > cur);
+                pending_min = pending_day ? 0 : w;
+                break;
+            }
+
+            wakes++;
+            cur = w;
+
+            print_local_stamp(y, mo, d, w);
+            console_puts("  wake");
+
+            if (project_reduce(w, &rs, have, act, true) == 0)
+                console_puts("  (no change)");
+
+            console_putc('\n');
+        }
+    }
+
+    mini_printf("wakes: %u (%u day boundary)\n", wakes, day_wakes);
+
+    /* Back to today for the main loop */
+    schedule_load_day(sy, smo, sd);
+}
+
+
+static void cmd_schedule(int argc, char **argv)
+{
     ensure_cfg_loaded();
 
     if (!rtc_time_is_set()) {
@@ -591,20 +1059,29 @@ static void cmd_schedule(int argc, char **argv)
         return;
     }
 
+    if (argc > 1) {
+        int days;
+
+        if (argc != 3 || strcmp(argv[1], "project") != 0 ||
+            !parse_signed_int(argv[2], &days) ||
+            days < 1 || days > SCHEDULE_PROJECT_MAX_DAYS) {
+            mini_printf("usage: schedule project [1..%u]\n",
+                        SCHEDULE_PROJECT_MAX_DAYS);
+            return;
+        }
+
+        schedule_project(days);
+        return;
+    }
+
     /* ------------------------------------------------------------------
      * Read UTC from RTC
      * ------------------------------------------------------------------ */
     int y, mo, d, h, m, s;
     rtc_get_time(&y, &mo, &d, &h, &m, &s);
 
-    /* Convert UTC → LOCAL */
-    int tz = g_cfg.tz;
-    int dst = 0;
-
-    if (g_cfg.honor_dst && is_us_dst(y, mo, d, h))
-        dst = 1;
-
-    int total = tz + dst;
+    /* Convert UTC → LOCAL (whole hours) */
+    int total = utc_offset_minutes(y, mo, d, h) / 60;
 
     int ly = y;
     int lmo = mo;
@@ -716,16 +1193,25 @@ static void cmd_schedule(int argc, char **argv)
     struct Row rows[MAX_EVENTS];
     size_t rc = 0;
 
+    /* Calendar qualifiers use the UTC date */
+    int uy = 0, umo = 0, ud = 0;
+    rtc_get_time(&uy, &umo, &ud, NULL, NULL, NULL);
+    uint8_t uwd = (uint8_t)day_of_week(uy, umo, ud);
+
+    struct day_utc_offset off;
+    today_utc_offset(&off);
+
     for (size_t i = 0; i < MAX_EVENTS; i++) {
 
         const Event *ev = &events[i];
         if (ev->refnum == 0)
             continue;
 
+        if (!event_on_day(ev, uwd, (uint8_t)umo, (uint8_t)ud))
+            continue;
+
         uint16_t minute;
-        if (!resolve_when(&ev->when,
-                          have_sol ? &sol : NULL,
-                          &minute))
+        if (!resolve_when_day(&ev->when, &sol, &off, &minute))
             continue;
 
         rows[rc].minute = minute; /* UTC */
@@ -966,6 +1452,61 @@ static void cmd_set(int argc, char **argv)
         return;
     }
 
+    /* --------------------------------------------------
+     * set coalesce MIN [late|early]
+     *   Events within MIN minutes share one wake (0 = off)
+     * -------------------------------------------------- */
+    if (!strcmp(argv[1], "coalesce") && (argc == 3 || argc == 4)) {
+        int v = atoi(argv[2]);
+        if (v < 0 || v > 60) {
+            console_puts("ERROR\n");
+            return;
+        }
+
+        uint8_t early = g_cfg.coalesce_early;
+        if (argc == 4) {
+            if (!strcmp(argv[3], "early"))
+                early = 1;
+            else if (!strcmp(argv[3], "late"))
+                early = 0;
+            else {
+                console_puts("ERROR\n");
+                return;
+            }
+        }
+
+        g_cfg.coalesce_minutes = (uint8_t)v;
+        g_cfg.coalesce_early   = early;
+        g_cfg_dirty = true;
+        console_puts("OK\n");
+        return;
+    }
+
+    /* --------------------------------------------------
+     * set current <state> <uA>
+     *   Energy model: board current in one power state
+     * -------------------------------------------------- */
+    if (!strcmp(argv[1], "current") && argc == 4) {
+        uint8_t s = 0;
+        while (s < ENERGY_STATE_COUNT &&
+               strcmp(argv[2], energy_state_name(s)) != 0)
+            s++;
+
+        char *end = NULL;
+        unsigned long ua = strtoul(argv[3], &end, 10);
+
+        if (s >= ENERGY_STATE_COUNT || end == argv[3] || *end ||
+            ua > 5000000ul) {
+            console_puts("ERROR\n");
+            return;
+        }
+
+        g_cfg.energy_ua[s] = (uint32_t)ua;
+        g_cfg_dirty = true;
+        console_puts("OK\n");
+        return;
+    }
+
     /* --------------------------------------------------
      * Mechanical timing parameters (unchanged)
      * -------------------------------------------------- */
@@ -1085,6 +1626,12 @@ static void cmd_set(int argc, char **argv)
  }
 
 
+#if defined(SOLAR_MODEL_FIT)
+#define SOLAR_CACHE_LABEL "SOLAR FIT"
+#else
+#define SOLAR_CACHE_LABEL "SOLAR TABLE"
+#endif
+
  static void cmd_save(int argc, char **argv)
  {
      (void)argc;
@@ -1095,6 +1642,23 @@ static void cmd_set(int argc, char **argv)
      config_save(&g_cfg);
 
      g_cfg_dirty = false;
+
+     /* New location → rebuild the per-location solar cache */
+     if (solar_table_cache_needed(g_cfg.latitude_e4, g_cfg.longitude_e4)) {
+         if (devices_busy()) {
+             /* Build blocks for seconds; never stall moving hardware */
+             solar_service_queue_build(g_cfg.latitude_e4, g_cfg.longitude_e4);
+             console_puts(SOLAR_CACHE_LABEL ": QUEUED (builds when devices are idle)\n");
+         } else {
+             console_puts(SOLAR_CACHE_LABEL ": BUILDING...\n");
+             if (!solar_table_cache_build(g_cfg.latitude_e4, g_cfg.longitude_e4))
+                 console_puts(SOLAR_CACHE_LABEL ": UNAVAILABLE (using compute)\n");
+         }
+     }
+
+     /* Memoized days may predate the cache; answer from it from now on */
+     solar_service_invalidate();
+
      console_puts("OK\n");
  }
 
@@ -1299,6 +1863,28 @@ static void cmd_config(int, char **)
     mini_printf("dst  : %s\n",
                 g_cfg.honor_dst ? "ON (US rules)" : "OFF");
 
+#if defined(SOLAR_BAKED)
+    mini_printf("solar_baked : %s\n",
+                solar_baked_valid_for(g_cfg.latitude_e4, g_cfg.longitude_e4)
+                    ? "ACTIVE" : "INACTIVE (location changed)");
+#endif
+
+#if defined(SOLAR_MODEL_FIT)
+    if (solar_fit_valid_for(g_cfg.latitude_e4, g_cfg.longitude_e4))
+        mini_printf("solar_fit : VALID (max err %u min)\n",
+                    (unsigned)solar_fit_max_error());
+    else
+        console_puts("solar_fit : NONE (using compute)\n");
+#else
+    mini_printf("solar_table : %s\n",
+                solar_table_valid_for(g_cfg.latitude_e4, g_cfg.longitude_e4)
+                    ? "VALID" : "STALE (save to rebuild)");
+#endif
+
+    mini_printf("coalesce : %u min (%s)\n",
+                (unsigned)g_cfg.coalesce_minutes,
+                g_cfg.coalesce_early ? "early" : "late");
+
     /* drift baseline */
     if (g_cfg.rtc_set_epoch != 0) {
         mini_printf("rtc_set_epoch : %lu\n",
@@ -1344,9 +1930,12 @@ static void cmd_event(int argc, char **argv)
             return;
         }
 
-        /* Compute solar times once for today */
+        /* Compute solar times once for today (valid_mask gates use) */
         struct solar_times sol;
-        bool have_sol = compute_today_solar(&sol);
+        (void)compute_today_solar(&sol);
+
+        struct day_utc_offset off;
+        today_utc_offset(&off);
 
         /* Collect resolved events (by refnum, not index) */
         struct Resolved {
@@ -1369,9 +1958,7 @@ static void cmd_event(int argc, char **argv)
                 continue;
 
             uint16_t minute;
-            if (!resolve_when(&ev->when,
-                              have_sol ? &sol : NULL,
-                              &minute))
+            if (!resolve_when_day(&ev->when, &sol, &off, &minute))
                 continue;
 
             r[rcount].minute = minute;
@@ -1446,6 +2033,7 @@ static void cmd_event(int argc, char **argv)
             console_putc(' ');
 
             when_print(&ev->when, (uint16_t)local_minute);
+            quals_print(ev);
             console_putc('\n');
         }
         return;
@@ -1497,6 +2085,17 @@ static void cmd_event(int argc, char **argv)
              return;
          }
 
+         /* --------------------------------------------------
+          * Calendar qualifiers (trailing key=value)
+          * -------------------------------------------------- */
+         while (argc > 5 && strchr(argv[argc - 1], '=')) {
+             if (!parse_qualifier(argv[argc - 1], &ev)) {
+                 console_puts("ERROR QUALIFIER\n");
+                 return;
+             }
+             argc--;
+         }
+
          /* --------------------------------------------------
           * Device
           * -------------------------------------------------- */
@@ -1527,29 +2126,16 @@ static void cmd_event(int argc, char **argv)
           * WHEN parsing
           * -------------------------------------------------- */
 
-          /* implicit HH:MM */
+          /*
+           * implicit HH:MM: local wall-clock, follows DST
+           * (resolved to UTC per day by the scheduler)
+           */
           if (argc == 5) {
               int hh, mm;
               if (parse_time_hm(argv[4], &hh, &mm)) {
 
-                  /* ---- Convert LOCAL → UTC (minutes-based) ---- */
-
-                  uint16_t local_minute = (uint16_t)(hh * 60 + mm);
-
-                  int y, mo, d, utc_h_now;
-                  rtc_get_time(&y, &mo, &d, &utc_h_now, NULL, NULL);  /* UTC */
-
-                  /* Compute offset using current UTC time */
-                  int offset_min = utc_offset_minutes(y, mo, d, utc_h_now);
-
-                  /* local = utc + offset  →  utc = local - offset */
-                  int utc_minute = (int)local_minute - offset_min;
-
-                  /* Normalize to 0–1439 */
-                  utc_minute = (utc_minute + 1440) % 1440;
-
-                  ev.when.ref = REF_MIDNIGHT;
-                  ev.when.offset_minutes = (int16_t)utc_minute;
+                  ev.when.ref = REF_LOCAL_MIDNIGHT;
+                  ev.when.offset_minutes = (int16_t)(hh * 60 + mm);
 
                   goto add_event;
               }
@@ -1590,6 +2176,11 @@ static void cmd_event(int argc, char **argv)
              { "sunset",  REF_SOLAR_STD_SET  },
              { "dawn",    REF_SOLAR_CIV_RISE },
              { "dusk",    REF_SOLAR_CIV_SET  },
+             { "nautdawn",  REF_SOLAR_NAUT_RISE  },
+             { "nautdusk",  REF_SOLAR_NAUT_SET   },
+             { "astrodawn", REF_SOLAR_ASTRO_RISE },
+             { "astrodusk", REF_SOLAR_ASTRO_SET  },
+             { "noon",      REF_SOLAR_NOON       },
          };
 
          for (size_t i = 0; i < sizeof(when_keywords)/sizeof(when_keywords[0]); i++) {
@@ -1601,7 +2192,8 @@ static void cmd_event(int argc, char **argv)
                  /* optional offset */
                  if (argc == 6) {
                      int off;
-                     if (!parse_signed_int(argv[5], &off)) {
+                     if (!parse_signed_int(argv[5], &off) ||
+                         off < EVENT_OFFSET_MIN || off > EVENT_OFFSET_MAX) {
                          console_puts("ERROR OFFSET\n");
                          return;
                      }
@@ -1653,11 +2245,16 @@ static void cmd_sleep(int argc, char **argv)
         uint16_t now_min = rtc_minutes_since_midnight();
 
         uint16_t next_min;
-        if (!scheduler_next_event_minute(now_min, &next_min)) {
+        bool     tomorrow;
+        if (!scheduler_next_event_minute(now_min, &next_min, &tomorrow)) {
             console_puts("sleep: no scheduled events\n");
             return;
         }
 
+        /* HH:MM alarm: a later minute tomorrow would fire today */
+        if (tomorrow && next_min > now_min)
+            next_min = 0;
+
         /* Compute modular delta */
         uint16_t delta =
             (uint16_t)((next_min + 1440u - now_min) % 1440u);
@@ -1781,6 +2378,152 @@ static void cmd_sleep(int argc, char **argv)
 }
 
 
+static void print_wake_counts(const char *label, const struct wake_counts *c)
+{
+    mini_printf("%s%5u  event %u  day %u  external %u  config %u\n",
+                label,
+                (unsigned)wake_counts_sum(c),
+                (unsigned)c->by_cause[WAKE_CAUSE_EVENT],
+                (unsigned)c->by_cause[WAKE_CAUSE_DAY],
+                (unsigned)c->by_cause[WAKE_CAUSE_EXTERNAL],
+                (unsigned)c->by_cause[WAKE_CAUSE_CONFIG]);
+}
+
+/*
+ * Today's coalesced wake plan, local time.
+ * One line per wake: wake time, then the events it runs.
+ */
+static void print_wake_plan(void)
+{
+    int y, mo, d;
+    rtc_get_time(&y, &mo, &d, NULL, NULL, NULL);
+
+    /* Same window the main loop uses */
+    scheduler_set_coalesce(g_cfg.coalesce_minutes,
+                           g_cfg.coalesce_early ? SCHED_COALESCE_EARLY
+                                                : SCHED_COALESCE_LATE);
+
+    size_t ng = 0, ne = 0;
+    const struct sched_wake_group *g = scheduler_wake_plan(&ng);
+    const struct ResolvedEvent *tl = scheduler_timeline(&ne);
+
+    mini_printf("Wake plan (window %u min, %s):\n",
+                (unsigned)g_cfg.coalesce_minutes,
+                g_cfg.coalesce_early ? "early" : "late");
+
+    if (ng == 0) {
+        console_puts("  (no events: day-boundary wake only)\n");
+        return;
+    }
+
+    unsigned wakes = 0;
+
+    for (size_t i = 0; i < ng; i++) {
+
+        uint16_t wake = g_cfg.coalesce_early ? g[i].first : g[i].last;
+
+        /* Groups split at the same minute (device repeat) share a wake */
+        if (i == 0 ||
+            wake != (g_cfg.coalesce_early ? g[i - 1].first : g[i - 1].last))
+            wakes++;
+
+        console_puts("  ");
+        print_hhmm(solar_local_minute(y, mo, d, wake));
+        console_puts(" ");
+
+        for (uint8_t k = g[i].begin; k < g[i].end; k++) {
+
+            const char *dev = "?";
+            const char *state = "?";
+
+            device_name(tl[k].device_id, &dev);
+            device_get_state_string(tl[k].device_id,
+                                    (tl[k].action == ACTION_ON)
+                                        ? DEV_STATE_ON : DEV_STATE_OFF,
+                                    &state);
+
+            console_puts(" ");
+            print_hhmm(solar_local_minute(y, mo, d, tl[k].minute));
+            mini_printf(" %s %s", dev, state);
+        }
+
+        console_putc('\n');
+    }
+
+    mini_printf("wakes/day : %u for %u events\n\n",
+                wakes, (unsigned)ne);
+}
+
+static void cmd_wakes(int, char **)
+{
+    ensure_cfg_loaded();
+
+    if (rtc_time_is_set())
+        print_wake_plan();
+
+    /* UTC days, counted by the main loop in RUN mode */
+    print_wake_counts("today     : ", wake_stats_today());
+    print_wake_counts("yesterday : ", wake_stats_yesterday());
+
+    mini_printf("since boot: %5lu\n", (unsigned long)wake_stats_total());
+}
+
+/* ms as seconds, one decimal */
+static void print_secs(uint32_t ms)
+{
+    mini_printf("%8lu.%u", (unsigned long)(ms / 1000u),
+                (unsigned)((ms % 1000u) / 100u));
+}
+
+/* uAh as mAh, three decimals */
+static void print_mah(uint32_t uah)
+{
+    mini_printf("%lu.%03u", (unsigned long)(uah / 1000u),
+                (unsigned)(uah % 1000u));
+}
+
+static void print_energy_wakes(const char *label, const struct wake_counts *c)
+{
+    mini_printf("%srtc %u  door %u  config %u\n",
+                label,
+                (unsigned)(c->by_cause[WAKE_CAUSE_EVENT] +
+                           c->by_cause[WAKE_CAUSE_DAY]),
+                (unsigned)c->by_cause[WAKE_CAUSE_EXTERNAL],
+                (unsigned)c->by_cause[WAKE_CAUSE_CONFIG]);
+}
+
+/*
+ * Time per power state today and yesterday (UTC days), and the
+ * charge it costs at the configured currents.
+ */
+static void cmd_energy(int, char **)
+{
+    ensure_cfg_loaded();
+
+    const struct energy_day *today = energy_today();
+    const struct energy_day *yday  = energy_yesterday();
+
+    console_puts("state       today s       yday s        uA\n");
+
+    for (uint8_t i = 0; i < ENERGY_STATE_COUNT; i++) {
+        print_padded(energy_state_name(i), 8);
+        print_secs(today->ms[i]);
+        console_puts("  ");
+        print_secs(yday->ms[i]);
+        mini_printf("  %8lu\n", (unsigned long)g_cfg.energy_ua[i]);
+    }
+
+    console_puts("\nmAh       : today ");
+    print_mah(energy_day_uah(today, g_cfg.energy_ua));
+    console_puts(" so far, yesterday ");
+    print_mah(energy_day_uah(yday, g_cfg.energy_ua));
+    console_puts("/day\n");
+
+    print_energy_wakes("wakes     : today ", wake_stats_today());
+    print_energy_wakes("            yesterday ", wake_stats_yesterday());
+}
+
+
 typedef void (*cmd_fn_t)(int argc, char **argv);
 
 typedef struct {
@@ -1820,16 +2563,21 @@ typedef struct {
       "  Format: YYYY-MM-DD HH:MM:SS AM|PM\n" \
     ) \
     \
-    X(schedule, 0, 0, cmd_schedule, \
+    X(schedule, 0, 2, cmd_schedule, \
       "Show schedule", \
       "schedule\n" \
-      "  Show system schedule and next resolved events\n" \
+      "schedule project <days>\n" \
+      "  Show system schedule and next resolved events, or\n" \
+      "  replay the next 1..31 days: each wake and device\n" \
+      "  change in local time, and the total wakes\n" \
     ) \
     \
-    X(solar, 0, 0, cmd_solar, \
+    X(solar, 0, 1, cmd_solar, \
       "Show sunrise/sunset times", \
       "solar\n" \
-      "  Show stored location and today's solar times\n" \
+      "solar <days>\n" \
+      "  Show today's solar times, or a local-time forecast\n" \
+      "  for the next 1..60 days\n" \
     ) \
     \
     X(set, 2, 6, cmd_set, \
@@ -1839,6 +2587,9 @@ typedef struct {
       "set lat  +/-DD.DDDD\n" \
       "set lon  +/-DDD.DDDD\n" \
       "set tz   +/-HH\n" \
+      "set coalesce MIN [late|early]\n" \
+      "set current <state> <uA>\n" \
+      "  state: sleep idle active motor lock relay console\n" \
     ) \
     \
     X(config, 0, 0, cmd_config, \
@@ -1880,11 +2631,20 @@ typedef struct {
       "Event commands", \
       "event list\n" \
       "event add <device> <on|off> HH:MM\n" \
+      "  local time, follows DST\n" \
       "event add <device> <on|off> midnight HH:MM\n" \
+      "  entered local, kept as a fixed UTC time\n" \
       "event add <device> <on|off> sunrise +/-MIN\n" \
       "event add <device> <on|off> sunset  +/-MIN\n" \
       "event add <device> <on|off> dawn    +/-MIN\n" \
       "event add <device> <on|off> dusk    +/-MIN\n" \
+      "event add <device> <on|off> nautdawn|nautdusk +/-MIN\n" \
+      "event add <device> <on|off> astrodawn|astrodusk +/-MIN\n" \
+      "event add <device> <on|off> noon    +/-MIN\n" \
+      "  optional, after the time:\n" \
+      "    days=mo,we,fr | mo-fr | weekdays | weekends\n" \
+      "    dates=MM/DD-MM/DD  (season, may wrap Dec 31)\n" \
+      "  (weekdays and dates are UTC)\n" \
       "event delete <refnum>\n" \
       "event clear\n" \
     ) \
@@ -1911,6 +2671,25 @@ typedef struct {
           "sleep\n" \
           "sleep <minutes>\n" \
           "  sleep till the next resolved scheduler event (if any)\n" \
+    ) \
+    \
+    X(wakes, 0, 0, cmd_wakes, \
+      "Show wake plan and counts", \
+      "wakes\n" \
+      "  Today's wake plan after coalescing, wakes/day, and\n" \
+      "  wakeups today / yesterday (UTC days) by cause:\n" \
+      "  event = scheduled alarm, day = day-boundary housekeeping,\n" \
+      "  external = door switch or other interrupt,\n" \
+      "  config = console session (config switch)\n" \
+    ) \
+    \
+    X(energy, 0, 0, cmd_energy, \
+      "Show time and charge per power state", \
+      "energy\n" \
+      "  Time in each power state today / yesterday (UTC days),\n" \
+      "  estimated mAh at the configured currents, and wakes by\n" \
+      "  cause. CPU: sleep + idle + active = the day; motor, lock,\n" \
+      "  relay and console add on top. Currents: set current\n" \
     )
 
 
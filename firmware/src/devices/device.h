@@ -8,13 +8,18 @@
  *  - Devices are dumb
  *  - No scheduling or event knowledge
  *  - Scheduler decides WHAT, devices decide HOW
+ *  - next_deadline_ms (optional): earliest time tick() has work.
+ *    true with *due_ms set, or false when nothing is pending; a due
+ *    time at or before now_ms means tick now. Devices that provide
+ *    it are only ticked when due; without it, every pass.
  *
- * Updated: 2026-01-01
+ * Updated: 2026-10-16
  */
 
 #pragma once
 #include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include "device_ids.h"
 
 /* Device-visible state */
@@ -35,4 +40,5 @@ typedef struct {
     const char *(*state_string)(dev_state_t state);
     void        (*tick)(uint32_t now_ms);
     bool        (*is_busy)(void);
+    bool        (*next_deadline_ms)(uint32_t now_ms, uint32_t *due_ms);
 } Device;
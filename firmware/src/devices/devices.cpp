@@ -4,7 +4,7 @@
  * Project: Chicken Coop Controller
  * Purpose: Device registry implementation
  *
- * Updated: 2026-01-08
+ * Updated: 2026-10-16
  */
 
 #include "devices.h"
@@ -135,15 +135,26 @@ bool device_lookup_id(const char *name, uint8_t *out_id)
  * Periodic service
  * -------------------------------------------------------------------------- */
 
+static inline bool ms_before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
 void device_tick(uint32_t now_ms)
 {
     for (size_t i = 0; i < DEVICE_ID_TABLE_SIZE; i++) {
         const Device *dev = devices[i];
-        if (!dev)
+        if (!dev || !dev->tick)
             continue;
 
-        if (dev->tick)
-            dev->tick(now_ms);
+        /* Nothing due: skip the tick */
+        if (dev->next_deadline_ms) {
+            uint32_t due;
+            if (!dev->next_deadline_ms(now_ms, &due) || ms_before(now_ms, due))
+                continue;
+        }
+
+        dev->tick(now_ms);
     }
 }
 
@@ -301,6 +312,39 @@ bool devices_busy(void){
 
 
 
+bool devices_next_deadline(uint32_t now_ms, uint32_t *due_ms)
+{
+    bool     have     = false;
+    uint32_t earliest = 0;
+
+    for (size_t i = 0; i < DEVICE_ID_TABLE_SIZE; i++) {
+        const Device *dev = devices[i];
+        if (!dev)
+            continue;
+
+        uint32_t due;
+
+        if (dev->next_deadline_ms) {
+            if (!dev->next_deadline_ms(now_ms, &due))
+                continue;
+        } else if (dev->is_busy && dev->is_busy()) {
+            due = now_ms;
+        } else {
+            continue;
+        }
+
+        if (!have || ms_before(due, earliest))
+            earliest = due;
+        have = true;
+    }
+
+    if (have && due_ms)
+        *due_ms = earliest;
+
+    return have;
+}
+
+
 bool device_is_busy(uint8_t id)
 {
     const Device *dev = device_by_id(id);
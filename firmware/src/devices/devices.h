@@ -184,3 +184,16 @@ bool devices_busy(void);
 
 
 bool device_is_busy(uint8_t id);
+
+/*
+ * devices_next_deadline()
+ *
+ * Earliest next_deadline_ms() over all devices: when the main loop
+ * next has device work. A busy device without the hook counts as
+ * due now (ticked every pass, as before).
+ *
+ * Returns:
+ *   true  → *due_ms set (may be at or before now_ms)
+ *   false → no device has anything pending
+ */
+bool devices_next_deadline(uint32_t now_ms, uint32_t *due_ms);
@@ -9,7 +9,7 @@
  *  - Delegates motion and timing to door_state_machine
  *  - No direct hardware control here
  *
- * Updated: 2026-01-06
+ * Updated: 2026-10-16
  */
 
 #include "device.h"
@@ -94,6 +94,12 @@ static bool door_busy()
 }
 
 
+static bool door_next_deadline(uint32_t now_ms, uint32_t *due_ms)
+{
+    return door_sm_next_deadline(now_ms, due_ms);
+}
+
+
 /* --------------------------------------------------------------------------
  * Device registration
  * -------------------------------------------------------------------------- */
@@ -107,5 +113,6 @@ Device door_device = {
     .schedule_state = door_schedule_state,
     .state_string = door_state_string,
     .tick         = door_tick,
-    .is_busy      = door_busy
+    .is_busy      = door_busy,
+    .next_deadline_ms = door_next_deadline
 };
@@ -238,6 +238,27 @@ void door_sm_tick(uint32_t now_ms)
         break;
     }
 }
+
+bool door_sm_next_deadline(uint32_t now_ms, uint32_t *due_ms)
+{
+    switch (g_motion) {
+
+    case DOOR_MOVING_OPEN:
+    case DOOR_MOVING_CLOSE:
+        /* First tick starts the travel timer */
+        *due_ms = (g_motion_t0_ms == 0) ? now_ms
+                                        : g_motion_t0_ms + g_cfg.door_travel_ms;
+        return true;
+
+    case DOOR_POSTCLOSE_LOCK:
+        *due_ms = g_motion_t0_ms + door_settle_ms();
+        return true;
+
+    default:
+        return false;
+    }
+}
+
 dev_state_t door_sm_get_state(void)
 {
     switch (g_motion) {
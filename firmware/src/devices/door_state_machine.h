@@ -107,6 +107,15 @@ void door_sm_schedule(dev_state_t state,  uint32_t when);
  */
 void door_sm_tick(uint32_t now_ms);
 
+/*
+ * When door_sm_tick() next has work (end of travel, end of settle).
+ *
+ * Returns:
+ *  - true with *due_ms set while moving or locking
+ *  - false when idle
+ */
+bool door_sm_next_deadline(uint32_t now_ms, uint32_t *due_ms);
+
 /*
  * Query the settled, device-visible door state.
  *
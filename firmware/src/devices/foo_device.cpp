@@ -63,5 +63,6 @@ Device foo_device = {
     .schedule_state  = NULL,
     .state_string = foo_state_string,
     .tick = NULL,
-    .is_busy  = NULL
+    .is_busy  = NULL,
+    .next_deadline_ms = NULL
 };
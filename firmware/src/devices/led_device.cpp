@@ -4,7 +4,7 @@
  * Project: Chicken Coop Controller
  * Purpose: Simple ON/OFF relay device
  *
- * Updated: 2026-01-01
+ * Updated: 2026-10-16
  */
 
 #include "device.h"
@@ -39,6 +39,11 @@ static void led_tick(uint32_t now_ms)
     led_state_machine_tick(now_ms);
 }
 
+static bool led_next_deadline(uint32_t now_ms, uint32_t *due_ms)
+{
+    return led_state_machine_next_ms(now_ms, due_ms);
+}
+
 
 Device led_device = {
     .name       = "led",
@@ -49,5 +54,6 @@ Device led_device = {
     .schedule_state  = NULL,
     .state_string = led_state_string,
     .tick         =  led_tick,
-    .is_busy         = NULL
+    .is_busy         = NULL,
+    .next_deadline_ms = led_next_deadline
 };
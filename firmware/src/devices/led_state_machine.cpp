@@ -8,6 +8,7 @@
  *  - Non-blocking at the state-machine level
  *  - Software PWM carrier is driven by repeated door_led_tick() calls
  *  - Pulse envelope is rate-limited for smooth breathing
+ *  - next_ms() lets an idling main loop skip the ticks that do nothing
  *
  * Extended:
  *  - Blink/Pulse may run finite number of cycles
@@ -43,6 +44,10 @@ static uint16_t g_cycle_counter    = 0;   /* counts completed cycles */
 static uint32_t g_blink_t0_ms = 0;
 static bool     g_led_on      = false;
 
+/* Duty changed since the carrier last ran: pins not yet driven */
+static bool     g_pending     = false;
+static uint32_t g_pwm_last_ms = 0;
+
 /* Pulse timing (in PWM ticks) */
 static uint32_t g_pulse_last_ticks = 0;
 static uint8_t  g_pulse_step       = 0;
@@ -93,15 +98,14 @@ static inline void led_apply(bool on, uint8_t duty)
         door_led_red_pwm(duty);
 }
 
-static void door_led_pwm_service(uint32_t now_ms)
+/* Returns true if the carrier ran (pins now reflect the duty) */
+static bool door_led_pwm_service(uint32_t now_ms)
 {
-    static uint32_t last_ms = 0;
-
-    uint32_t elapsed = now_ms - last_ms;
+    uint32_t elapsed = now_ms - g_pwm_last_ms;
     if (elapsed == 0)
-        return;
+        return false;
 
-    last_ms = now_ms;
+    g_pwm_last_ms = now_ms;
 
     uint32_t ticks = elapsed * PWM_TICKS_PER_MS;
 
@@ -113,6 +117,8 @@ static void door_led_pwm_service(uint32_t now_ms)
         door_led_tick();
         g_pwm_ticks++;
     }
+
+    return true;
 }
 
 /* --------------------------------------------------------------------------
@@ -131,6 +137,7 @@ void led_state_machine_init(void)
 
     g_blink_t0_ms       = 0;
     g_led_on            = false;
+    g_pending           = false;
 
     g_pulse_last_ticks  = 0;
     g_pulse_step        = 0;
@@ -160,6 +167,7 @@ void led_state_machine_init(void)
 
      g_blink_t0_ms      = 0;
      g_led_on           = false;
+     g_pending          = true;
 
      g_pulse_last_ticks = 0;
      g_pulse_step       = 0;
@@ -207,6 +215,31 @@ bool led_state_machine_is_on(void)
     return g_led_on;
 }
 
+bool led_state_machine_next_ms(uint32_t now_ms, uint32_t *due_ms)
+{
+    /* Next carrier run drives the new duty (never twice in one ms) */
+    if (g_pending) {
+        *due_ms = g_pwm_last_ms + 1u;
+        return true;
+    }
+
+    switch (g_mode) {
+
+    case LED_BLINK:
+        *due_ms = (g_blink_t0_ms == 0) ? now_ms
+                                       : g_blink_t0_ms + BLINK_PERIOD_MS;
+        return true;
+
+    case LED_PULSE:
+        /* Carrier once per millisecond */
+        *due_ms = g_pwm_last_ms + 1u;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
 /**
  * @brief Service state machine.
  *
@@ -214,7 +247,8 @@ bool led_state_machine_is_on(void)
  */
  void led_state_machine_tick(uint32_t now_ms)
  {
-     door_led_pwm_service(now_ms);
+     if (door_led_pwm_service(now_ms))
+         g_pending = false;
 
      switch (g_mode) {
 
@@ -237,6 +271,7 @@ bool led_state_machine_is_on(void)
 
              g_led_on = !g_led_on;
              g_blink_t0_ms = now_ms;
+             g_pending = true;
 
              /* Count full cycle on falling edge (ON->OFF) */
              if (!g_led_on && g_cycles_remaining > 0) {
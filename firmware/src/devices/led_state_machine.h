@@ -74,3 +74,16 @@ void led_state_machine_tick(uint32_t now_ms);
  *  - false otherwise
  */
 bool led_state_machine_is_on(void);
+
+/*
+ * When tick() next has work to do.
+ *
+ * Returns:
+ *  - true with *due_ms set: call tick() by then (at or before
+ *    now_ms: call it now)
+ *  - false: the outputs hold on their own (OFF, solid ON)
+ *
+ * Pulse needs the PWM carrier every millisecond; blink only at its
+ * edges (full duty holds the pin between ticks).
+ */
+bool led_state_machine_next_ms(uint32_t now_ms, uint32_t *due_ms);
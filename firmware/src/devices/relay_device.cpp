@@ -70,7 +70,7 @@
  * - rtc_get_epoch() provides seconds since 2000-01-01 00:00:00 UTC.
  * - No timezone or DST logic exists at this layer.
  *
- * Updated: 2026-02-19
+ * Updated: 2026-10-16
  */
 
 #include "device.h"
@@ -217,6 +217,20 @@ static const char *relay_state_string(dev_state_t state)
 }
 
 
+/**
+ * @brief Relays never wait on a timer.
+ *
+ * Coil pulses are bounded inside relayN_set()/relayN_reset() and a
+ * latched relay holds with no power: nothing for tick() to do.
+ */
+static bool relay_next_deadline(uint32_t now_ms, uint32_t *due_ms)
+{
+    (void)now_ms;
+    (void)due_ms;
+    return false;
+}
+
+
 /* ============================================================================
  * Initialization
  * ========================================================================== */
@@ -255,7 +269,8 @@ Device relay1_device = {
     .schedule_state = relay1_schedule_state,
     .state_string   = relay_state_string,
     .tick           = NULL,
-    .is_busy        = NULL
+    .is_busy        = NULL,
+    .next_deadline_ms = relay_next_deadline
 };
 
 /** Relay2 device descriptor */
@@ -268,5 +283,6 @@ Device relay2_device = {
     .schedule_state = relay2_schedule_state,
     .state_string   = relay_state_string,
     .tick           = NULL,
-    .is_busy        = NULL
+    .is_busy        = NULL,
+    .next_deadline_ms = relay_next_deadline
 };
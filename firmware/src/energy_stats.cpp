@@ -0,0 +1,173 @@
+/*
+ * energy_stats.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Time spent per power state, rolled up per UTC day
+ *
+ * Notes:
+ *  - Active is derived: awake since the day started, less idle
+ *  - A sleep across UTC midnight is split between the two days
+ *  - An RTC jump (set, or more than two days) charges no power-down
+ *    and restarts the day count
+ *
+ * Updated: 2026-10-16
+ */
+
+#include "energy_stats.h"
+#include "uptime.h"
+
+#include <string.h>
+
+#define SECS_PER_DAY      86400u
+#define MAX_SLEEP_SECS    (2u * SECS_PER_DAY)
+
+static struct energy_day s_today;
+static struct energy_day s_yesterday;
+
+static uint32_t s_day_awake0;       /* uptime when today's count began */
+static uint32_t s_load_t0[ENERGY_STATE_COUNT];
+static uint8_t  s_loads_on;         /* bit per energy_state */
+
+static bool     s_synced;
+static uint32_t s_sync_epoch;
+static uint32_t s_sync_ms;
+static uint32_t s_day;              /* UTC day number of s_today */
+static bool     s_slept;
+
+static const char *const s_names[ENERGY_STATE_COUNT] = {
+    "sleep", "idle", "active", "motor", "lock", "relay", "console"
+};
+
+/* Bring open spans and the derived active time up to now_ms */
+static void flush(uint32_t now_ms)
+{
+    for (uint8_t i = ENERGY_DOOR_MOTOR; i < ENERGY_STATE_COUNT; i++) {
+        if (s_loads_on & (1u << i)) {
+            s_today.ms[i] += now_ms - s_load_t0[i];
+            s_load_t0[i]   = now_ms;
+        }
+    }
+
+    uint32_t awake = now_ms - s_day_awake0;
+    uint32_t idle  = s_today.ms[ENERGY_IDLE];
+
+    s_today.ms[ENERGY_ACTIVE] = (awake > idle) ? awake - idle : 0;
+}
+
+static void roll(uint32_t now_ms)
+{
+    flush(now_ms);
+
+    s_yesterday = s_today;
+    memset(&s_today, 0, sizeof(s_today));
+
+    s_day_awake0 = now_ms;
+}
+
+void energy_load_on(enum energy_state load)
+{
+    if (load < ENERGY_DOOR_MOTOR || load >= ENERGY_STATE_COUNT)
+        return;
+
+    if (s_loads_on & (1u << load))
+        return;
+
+    s_loads_on       |= (uint8_t)(1u << load);
+    s_load_t0[load]   = uptime_millis();
+}
+
+void energy_load_off(enum energy_state load)
+{
+    if (load < ENERGY_DOOR_MOTOR || load >= ENERGY_STATE_COUNT)
+        return;
+
+    if (!(s_loads_on & (1u << load)))
+        return;
+
+    s_today.ms[load] += uptime_millis() - s_load_t0[load];
+    s_loads_on       &= (uint8_t)~(1u << load);
+}
+
+void energy_idle_tick(void)
+{
+    s_today.ms[ENERGY_IDLE]++;
+}
+
+void energy_power_down(void)
+{
+    s_slept = true;
+}
+
+void energy_rtc_sync(uint32_t epoch, uint32_t now_ms)
+{
+    uint32_t day = epoch / SECS_PER_DAY;
+
+    if (!s_synced ||
+        epoch < s_sync_epoch ||
+        epoch - s_sync_epoch > MAX_SLEEP_SECS) {
+
+        if (s_synced && day != s_day)
+            roll(now_ms);
+
+        s_synced = true;
+        s_day    = day;
+
+    } else {
+
+        /* Since the last sync: awake first, then the sleep (if any) */
+        uint32_t wall  = (epoch - s_sync_epoch) * 1000u;
+        uint32_t awake = now_ms - s_sync_ms;
+        uint32_t pos   = s_slept ? awake : wall;
+
+        while (s_day < day) {
+            uint32_t edge = ((s_day + 1u) * SECS_PER_DAY - s_sync_epoch) * 1000u;
+
+            if (edge > pos) {
+                uint32_t end = (edge < wall) ? edge : wall;
+                s_today.ms[ENERGY_PWR_DOWN] += end - pos;
+                pos = end;
+            }
+
+            roll(now_ms);
+            s_day++;
+        }
+
+        if (wall > pos)
+            s_today.ms[ENERGY_PWR_DOWN] += wall - pos;
+    }
+
+    s_sync_epoch = epoch;
+    s_sync_ms    = now_ms;
+    s_slept      = false;
+}
+
+const struct energy_day *energy_today(void)
+{
+    flush(uptime_millis());
+    return &s_today;
+}
+
+const struct energy_day *energy_yesterday(void)
+{
+    return &s_yesterday;
+}
+
+uint32_t energy_day_uah(const struct energy_day *d,
+                        const uint32_t ua[ENERGY_STATE_COUNT])
+{
+    if (!d || !ua)
+        return 0;
+
+    /* uA x ms / 3.6e6 = uAh */
+    uint64_t sum = 0;
+    for (uint8_t i = 0; i < ENERGY_STATE_COUNT; i++)
+        sum += (uint64_t)d->ms[i] * ua[i];
+
+    sum /= 3600000u;
+    return (sum > 0xFFFFFFFFu) ? 0xFFFFFFFFu : (uint32_t)sum;
+}
+
+const char *energy_state_name(uint8_t s)
+{
+    return (s < ENERGY_STATE_COUNT) ? s_names[s] : "?";
+}
@@ -0,0 +1,68 @@
+/*
+ * energy_stats.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Time spent per power state, rolled up per UTC day
+ *
+ * Notes:
+ *  - Portable: platform drivers and the main loop report state
+ *    changes here; nothing is sampled
+ *  - CPU states are exclusive (power-down + idle + active = the day);
+ *    loads (door motor, lock, relay coil, console) add on top
+ *  - Awake time is uptime (Timer0 stops in PWR_DOWN). Power-down is
+ *    the RTC time across a sleep less the awake time around it
+ *  - Idle is counted in Timer0 ticks: SLEEP_MODE_IDLE lasts to the
+ *    next 1 ms tick
+ *  - Today's counters roll into "yesterday" at the UTC date change
+ *  - No heap, fixed-size counters
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/* Power states, each with a configured current (g_cfg.energy_ua) */
+enum energy_state : uint8_t {
+    ENERGY_PWR_DOWN = 0,        /* CPU: SLEEP_MODE_PWR_DOWN */
+    ENERGY_IDLE,                /* CPU: SLEEP_MODE_IDLE */
+    ENERGY_ACTIVE,              /* CPU: running */
+    ENERGY_DOOR_MOTOR,          /* load: door H-bridge enabled */
+    ENERGY_LOCK,                /* load: lock pulse */
+    ENERGY_RELAY,               /* load: relay coil pulse */
+    ENERGY_CONSOLE,             /* load: config strap open, UART up */
+    ENERGY_STATE_COUNT
+};
+
+struct energy_day {
+    uint32_t ms[ENERGY_STATE_COUNT];
+};
+
+/* Loads: door_hw_enable/stop, lock_pulse(), relay_pulse(), console */
+void energy_load_on(enum energy_state load);
+void energy_load_off(enum energy_state load);
+
+/* system_idle(): one SLEEP_MODE_IDLE, one Timer0 tick */
+void energy_idle_tick(void);
+
+/* system_sleep_until(): the CPU really was in PWR_DOWN */
+void energy_power_down(void);
+
+/*
+ * Main loop, after every RTC read: UTC epoch (2000 base) and the
+ * pass's uptime. Charges the power-down time since the last sync and
+ * rolls the day when the date changed.
+ */
+void energy_rtc_sync(uint32_t epoch, uint32_t now_ms);
+
+/* Today so far (open spans included), and the previous full day */
+const struct energy_day *energy_today(void);
+const struct energy_day *energy_yesterday(void);
+
+/* Charge for one day's counters at per-state currents (uA), in uAh */
+uint32_t energy_day_uah(const struct energy_day *d,
+                        const uint32_t ua[ENERGY_STATE_COUNT]);
+
+/* Console name: sleep, idle, active, motor, lock, relay, console */
+const char *energy_state_name(uint8_t s);
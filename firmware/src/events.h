@@ -13,12 +13,22 @@
  * Notes:
  *  - All resolved times are minute-of-day (0..1439)
  *  - Invalid or out-of-range resolves are discarded, never wrapped
+ *  - Solar refs are only evaluated if some event uses them
+ *    (scheduler_solar_needs)
+ *  - A day's ResolvedEvents are kept sorted by minute (scheduler
+ *    timeline); queries binary search it
+ *  - Calendar qualifiers (weekdays, season) are evaluated once per
+ *    day into per-slot bitmasks (scheduler_update_day), never per wake
+ *  - Local wall-clock events (REF_LOCAL_MIDNIGHT) are resolved to UTC
+ *    with the day's offsets when the day is compiled; wakes compare
+ *    UTC only
  *
- * Updated: 2026-01-08
+ * Updated: 2026-10-16
  * ========================================================================== */
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -31,7 +41,21 @@ enum TimeRef : uint8_t {
     REF_SOLAR_STD_RISE,
     REF_SOLAR_STD_SET,
     REF_SOLAR_CIV_RISE,
-    REF_SOLAR_CIV_SET
+    REF_SOLAR_CIV_SET,
+
+    /* Appended only: values are stored in config */
+    REF_SOLAR_NAUT_RISE,
+    REF_SOLAR_NAUT_SET,
+    REF_SOLAR_ASTRO_RISE,
+    REF_SOLAR_ASTRO_SET,
+    REF_SOLAR_NOON,
+
+    /*
+     * REF_MIDNIGHT in local wall-clock time (tz + DST of the day), not
+     * UTC. Resolved per UTC day against that day's offsets (struct
+     * day_utc_offset). Stored as REF_MIDNIGHT + the local bit.
+     */
+    REF_LOCAL_MIDNIGHT
 };
 
 /* Declarative time expression */
@@ -40,6 +64,18 @@ struct When {
     int16_t offset_minutes; /* signed offset from reference */
 };
 
+/*
+ * One UTC day's offset to local wall-clock time (minutes, local - UTC).
+ *
+ * A DST change inside the day splits it: UTC minutes [0, change) use
+ * before, [change, 1440) use after. change == 1440 → no change.
+ */
+struct day_utc_offset {
+    int16_t  before;
+    int16_t  after;
+    uint16_t change;
+};
+
 /* Generic device action */
 enum Action : uint8_t {
     ACTION_OFF = 0,
@@ -59,8 +95,30 @@ struct Event {
     enum Action action;
     struct When when;
     refnum_t    refnum;     /* non-zero == used slot, also stable identity */
+
+    /*
+     * Calendar qualifiers (UTC date). All zero = every day.
+     *
+     * weekdays: EVENT_DAY_* bits; 0 = every weekday
+     * season:   from_mo/from_d .. to_mo/to_d inclusive; from_mo 0 =
+     *           all year. A range ending before it starts wraps the
+     *           year end (11/01..02/28 = Nov through Feb).
+     */
+    uint8_t     weekdays;
+    uint8_t     from_mo, from_d;
+    uint8_t     to_mo, to_d;
 };
 
+/* Event.weekdays bits (bit n = day_of_week() n) */
+#define EVENT_DAY_SUN  0x01u
+#define EVENT_DAY_MON  0x02u
+#define EVENT_DAY_TUE  0x04u
+#define EVENT_DAY_WED  0x08u
+#define EVENT_DAY_THU  0x10u
+#define EVENT_DAY_FRI  0x20u
+#define EVENT_DAY_SAT  0x40u
+#define EVENT_DAYS_ALL 0x7Fu
+
 /* Fully-resolved event for a specific day (non-persistent) */
 struct ResolvedEvent {
     uint8_t     device_id;
@@ -68,3 +126,25 @@ struct ResolvedEvent {
     refnum_t    refnum;
     uint16_t    minute;     /* 0..1439 */
 };
+
+/*
+ * First index in a minute-sorted ResolvedEvent array whose minute is
+ * strictly after `minute` (count if none).
+ */
+static inline size_t resolved_upper_bound(const struct ResolvedEvent *tl,
+                                          size_t count,
+                                          uint16_t minute)
+{
+    size_t lo = 0, hi = count;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (tl[mid].minute <= minute)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
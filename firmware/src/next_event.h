@@ -8,6 +8,8 @@
  *  - Pure scheduling logic
  *  - No I/O, no globals, no device knowledge
  *  - Input event table is SPARSE: slots are valid iff refnum != 0
+ *  - Treats every event as daily (calendar qualifiers are applied by
+ *    the scheduler timeline, scheduler_next_event_minute())
  *
  * Updated: 2026-01-08
  * ========================================================================== */
@@ -10,16 +10,68 @@
  *  - No device state
  *  - No cross-midnight wrapping
  *  - Invalid or unresolvable times return false
+ *  - Local wall-clock times map to UTC with caller-supplied offsets
  *
- * Updated: 2025-12-30
+ * Updated: 2026-10-16
  */
 
 #include "resolve_when.h"
 #include "solar.h"
 
+uint16_t resolve_when_solar_need(enum TimeRef ref)
+{
+    switch (ref) {
+    case REF_SOLAR_STD_RISE:   return SOLAR_Q_STD_RISE;
+    case REF_SOLAR_STD_SET:    return SOLAR_Q_STD_SET;
+    case REF_SOLAR_CIV_RISE:   return SOLAR_Q_CIV_RISE;
+    case REF_SOLAR_CIV_SET:    return SOLAR_Q_CIV_SET;
+    case REF_SOLAR_NAUT_RISE:  return SOLAR_Q_NAUT_RISE;
+    case REF_SOLAR_NAUT_SET:   return SOLAR_Q_NAUT_SET;
+    case REF_SOLAR_ASTRO_RISE: return SOLAR_Q_ASTRO_RISE;
+    case REF_SOLAR_ASTRO_SET:  return SOLAR_Q_ASTRO_SET;
+    case REF_SOLAR_NOON:       return SOLAR_Q_NOON;
+    default:                   return 0;
+    }
+}
+
+/* Quantity present in the supplied solar data */
+static inline bool sol_has(const struct solar_times *sol, uint16_t q)
+{
+    return sol && (sol->valid_mask & q);
+}
+
+/* Local minute-of-day → UTC minute-of-day on a day with offsets off */
+static uint16_t local_to_utc(int32_t local, const struct day_utc_offset *off)
+{
+    int32_t t = (local - off->before) % 1440;
+    if (t < 0)
+        t += 1440;
+
+    if (t < off->change)
+        return (uint16_t)t;
+
+    t = (local - off->after) % 1440;
+    if (t < 0)
+        t += 1440;
+
+    if (t >= off->change)
+        return (uint16_t)t;
+
+    /* Skipped by the change (spring forward): run at the change */
+    return off->change;
+}
+
 bool resolve_when(const struct When* when,
                   const struct solar_times* sol,
                   uint16_t* out_minute)
+{
+    return resolve_when_day(when, sol, NULL, out_minute);
+}
+
+bool resolve_when_day(const struct When* when,
+                      const struct solar_times* sol,
+                      const struct day_utc_offset* off,
+                      uint16_t* out_minute)
 {
     if (!when || !out_minute)
         return false;
@@ -32,29 +84,55 @@ bool resolve_when(const struct When* when,
         return false;
 
     case REF_MIDNIGHT:
+    case REF_LOCAL_MIDNIGHT:
         base = 0;
         break;
 
     case REF_SOLAR_STD_RISE:
-        if (!sol) return false;
+        if (!sol_has(sol, SOLAR_Q_STD_RISE)) return false;
         base = sol->sunrise_std;
         break;
 
     case REF_SOLAR_STD_SET:
-        if (!sol) return false;
+        if (!sol_has(sol, SOLAR_Q_STD_SET)) return false;
         base = sol->sunset_std;
         break;
 
     case REF_SOLAR_CIV_RISE:
-        if (!sol) return false;
+        if (!sol_has(sol, SOLAR_Q_CIV_RISE)) return false;
         base = sol->sunrise_civ;
         break;
 
     case REF_SOLAR_CIV_SET:
-        if (!sol) return false;
+        if (!sol_has(sol, SOLAR_Q_CIV_SET)) return false;
         base = sol->sunset_civ;
         break;
 
+    case REF_SOLAR_NAUT_RISE:
+        if (!sol_has(sol, SOLAR_Q_NAUT_RISE)) return false;
+        base = sol->sunrise_naut;
+        break;
+
+    case REF_SOLAR_NAUT_SET:
+        if (!sol_has(sol, SOLAR_Q_NAUT_SET)) return false;
+        base = sol->sunset_naut;
+        break;
+
+    case REF_SOLAR_ASTRO_RISE:
+        if (!sol_has(sol, SOLAR_Q_ASTRO_RISE)) return false;
+        base = sol->sunrise_astro;
+        break;
+
+    case REF_SOLAR_ASTRO_SET:
+        if (!sol_has(sol, SOLAR_Q_ASTRO_SET)) return false;
+        base = sol->sunset_astro;
+        break;
+
+    case REF_SOLAR_NOON:
+        if (!sol_has(sol, SOLAR_Q_NOON)) return false;
+        base = sol->noon;
+        break;
+
     default:
         return false;
     }
@@ -66,6 +144,33 @@ bool resolve_when(const struct When* when,
     if (t < 0)
         t += 1440;
 
+    if (when->ref == REF_LOCAL_MIDNIGHT && off)
+        t = local_to_utc(t, off);
+
     *out_minute = (uint16_t)t;
     return true;
 }
+
+bool event_on_day(const struct Event *ev,
+                  uint8_t weekday, uint8_t month, uint8_t day)
+{
+    if (!ev || weekday > 6)
+        return false;
+
+    if (ev->weekdays && !(ev->weekdays & (1u << weekday)))
+        return false;
+
+    if (ev->from_mo == 0)
+        return true;
+
+    /* Compare as month * 32 + day: order-preserving, no calendar math */
+    uint16_t md   = (uint16_t)(month * 32u + day);
+    uint16_t from = (uint16_t)(ev->from_mo * 32u + ev->from_d);
+    uint16_t to   = (uint16_t)(ev->to_mo * 32u + ev->to_d);
+
+    if (from <= to)
+        return md >= from && md <= to;
+
+    /* Wraps the year end */
+    return md >= from || md <= to;
+}
@@ -8,8 +8,13 @@
  *  - Stateless, pure function
  *  - No dependency on device state
  *  - Invalid times are rejected, never wrapped
+ *  - A solar ref resolves only if its quantity is in sol->valid_mask
+ *  - event_on_day() is the calendar half: whether an event runs on a
+ *    date at all
+ *  - Local wall-clock Whens need the day's UTC offsets
+ *    (resolve_when_day()); the scheduler supplies them per day
  *
- * Updated: 2025-12-29
+ * Updated: 2026-10-16
  */
 
 #pragma once
@@ -21,7 +26,26 @@ struct solar_times;
 
 /* Resolve a When expression into minute-of-day.
  * Returns true on success, false if disabled or out-of-range.
+ * A local wall-clock When is taken as UTC here; see resolve_when_day().
  */
 bool resolve_when(const struct When* when,
                   const struct solar_times* sol,
                   uint16_t* out_minute);
+
+/* Same, on a UTC day with offsets off (may be NULL = UTC).
+ * A local time the DST change skips resolves to the change minute; one
+ * it repeats resolves to its first occurrence.
+ */
+bool resolve_when_day(const struct When* when,
+                      const struct solar_times* sol,
+                      const struct day_utc_offset* off,
+                      uint16_t* out_minute);
+
+/* SOLAR_Q_* bit a reference depends on (0 for non-solar refs) */
+uint16_t resolve_when_solar_need(enum TimeRef ref);
+
+/* True if ev's calendar qualifiers admit the date.
+ * weekday is day_of_week() (0 = Sunday). Ignores refnum and time.
+ */
+bool event_on_day(const struct Event *ev,
+                  uint8_t weekday, uint8_t month, uint8_t day);
@@ -8,54 +8,65 @@
 #include "console/console.h"
 
 /*
- * Apply reduced scheduler state to devices.
+ * Apply one device's reduced state.
  *
  * This is the ONLY place where scheduled intent
  * actually turns into device actions.
  */
- void schedule_apply(const struct reduced_state *rs)
+ void schedule_apply_device(uint8_t id, const struct reduced_state *rs)
  {
-     if (!rs)
+     if (!rs || id >= STATE_REDUCER_MAX_DEVICES)
          return;
 
-     uint8_t id;
-
-     for (bool ok = device_enum_first(&id);
-          ok;
-          ok = device_enum_next(id, &id)) {
-
-         if (!rs->has_action[id])
-             continue;
+     if (!rs->has_action[id])
+         return;
 
-         dev_state_t want =
-             (rs->action[id] == ACTION_ON) ? DEV_STATE_ON
-                                           : DEV_STATE_OFF;
+     dev_state_t want =
+         (rs->action[id] == ACTION_ON) ? DEV_STATE_ON
+                                       : DEV_STATE_OFF;
 
-         dev_state_t have;
-         if (!device_get_state_by_id(id, &have))
-             continue;
+     dev_state_t have;
+     if (!device_get_state_by_id(id, &have))
+         return;
 
-         /* No-op if already correct */
-         if (have == want)
-             continue;
+     /* No-op if already correct */
+     if (have == want)
+         return;
 
 
-         uint32_t when = rs->when[id];
+     uint32_t when = rs->when[id];
 
 #if 0    /* ---- DEBUG: print scheduled action ---- */
 
-         const char *name = "?";
-         device_name(id, &name);
+     const char *name = "?";
+     device_name(id, &name);
 
-         mini_printf("\tDEBUG SCHED: %s -> %s (when=%lu)\n",
-                     name,
-                     (want == DEV_STATE_ON) ? "ON" : "OFF",
-                     when);
+     mini_printf("\tDEBUG SCHED: %s -> %s (when=%lu)\n",
+                 name,
+                 (want == DEV_STATE_ON) ? "ON" : "OFF",
+                 when);
 
 #endif
 
-         /* ---- Apply action ---- */
+     /* ---- Apply action ---- */
+
+     device_schedule_state_by_id(id, want,when);
+ }
+
+/*
+ * Apply reduced scheduler state to all registered devices.
+ */
+ void schedule_apply(const struct reduced_state *rs)
+ {
+     if (!rs)
+         return;
+
+     uint8_t id;
+
+     for (bool ok = device_enum_first(&id);
+          ok;
+          ok = device_enum_next(id, &id)) {
 
-         device_schedule_state_by_id(id, want,when);
+         schedule_apply_device(id, rs);
      }
  }
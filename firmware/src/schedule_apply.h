@@ -20,6 +20,14 @@ extern "C" {
  */
 void schedule_apply(const struct reduced_state *rs);
 
+/*
+ * Apply the reduced intent of a single device.
+ *
+ * Same rules as schedule_apply(); lets callers that reduced only one
+ * device (per-device event index) apply only that device.
+ */
+void schedule_apply_device(uint8_t id, const struct reduced_state *rs);
+
 #ifdef __cplusplus
 }
 #endif
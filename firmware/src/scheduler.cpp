@@ -5,7 +5,10 @@
  * Purpose: Day-scoped scheduler logic
  *
  * Responsibilities:
- *  - Cache solar data for TODAY only
+ *  - Cache solar data for yesterday, today and tomorrow
+ *  - Derive which solar quantities the event table references
+ *  - Compile today's events into a sorted timeline
+ *  - Group nearby events into shared wakes
  *  - Answer “what is the next event minute today?”
  *  - Track schedule changes via an ETag
  *
@@ -13,19 +16,21 @@
  *  - No device execution
  *  - No RTC access
  *  - No config mutation
- *  - No timezone or DST logic
+ *  - No timezone or DST rules (time_dst supplies each day's offsets)
  *
  * Notes:
  *  - Reads config_events (sparse table)
  *  - Uses caller-supplied solar data
  *  - Global, single instance
  *
- * Updated: 2026-01-08
+ * Updated: 2026-10-16
  * ========================================================================== */
 
 #include "scheduler.h"
 #include "config_events.h"
 #include "resolve_when.h"
+#include "solar_service.h"
+#include "time_dst.h"     /* day_of_week(), date_step(), day offsets */
 
 #include <string.h>
 
@@ -51,6 +56,63 @@ struct scheduler_ctx g_scheduler;
  */
 static uint32_t g_schedule_etag = 0;
 
+/*
+ * What the ETag moves were about.
+ *
+ *  - s_dirty_devices: device bits whose events changed (config_events
+ *    mutators) or everything (date change, generic touch)
+ *  - s_dirty_solar:   solar inputs changed; expands to the devices
+ *    that have solar-referenced or local wall-clock events when taken
+ *
+ * Consumed by scheduler_take_dirty(); the main loop re-reduces and
+ * re-applies only those devices.
+ */
+static uint8_t g_dirty_devices = SCHED_DIRTY_ALL;
+static bool    g_dirty_solar   = false;
+
+/*
+ * Compiled timeline for TODAY.
+ *
+ * Rebuilt only when the ETag moves; every input it depends on
+ * (event table, date, solar context) touches the ETag.
+ */
+static struct ResolvedEvent s_timeline[MAX_EVENTS];
+static uint8_t  s_timeline_count = 0;
+
+/* Same events grouped per device (config_events index), minute-sorted */
+static struct ResolvedEvent s_by_dev[MAX_EVENTS];
+static uint8_t  s_by_dev_start[EVENT_INDEX_MAX_DEVICES + 1];
+
+/* Wake plan (coalesced groups over s_timeline) */
+static struct sched_wake_group s_groups[MAX_EVENTS];
+static uint8_t s_group_count = 0;
+static uint8_t s_coalesce_window = 0;
+static uint8_t s_coalesce_mode = SCHED_COALESCE_LATE;
+
+/* Yesterday's last event per device, tomorrow's first event */
+static struct ResolvedEvent s_carry[EVENT_INDEX_MAX_DEVICES];
+static uint16_t s_next_first = 0;
+static bool     s_have_next_first = false;
+static uint32_t s_timeline_etag  = 0;
+static bool     s_timeline_valid = false;
+
+/*
+ * Calendar qualifiers compiled per slot (bit i = slot i runs that day)
+ * for yesterday, today and tomorrow. Built when the date is set and
+ * after event edits; the compile steps below only test bits.
+ */
+#define DAY_MASK_BYTES ((MAX_EVENTS + 7) / 8)
+
+static uint8_t s_on_prev[DAY_MASK_BYTES];
+static uint8_t s_on_today[DAY_MASK_BYTES];
+static uint8_t s_on_next[DAY_MASK_BYTES];
+static bool    s_days_valid = false;
+
+/* Local wall-clock offsets of the same three days, compiled with them */
+static struct day_utc_offset s_off_prev;
+static struct day_utc_offset s_off_today;
+static struct day_utc_offset s_off_next;
+
 /* --------------------------------------------------------------------------
  * Lifecycle
  * -------------------------------------------------------------------------- */
@@ -62,6 +124,16 @@ void scheduler_init(void)
 
     /* Reset schedule change token */
     g_schedule_etag = 0;
+    g_dirty_devices = SCHED_DIRTY_ALL;
+    g_dirty_solar   = false;
+
+    s_timeline_count = 0;
+    memset(s_by_dev_start, 0, sizeof(s_by_dev_start));
+    memset(s_carry, 0, sizeof(s_carry));
+    s_have_next_first = false;
+    s_group_count = 0;
+    s_timeline_valid = false;
+    s_days_valid = false;
 }
 
 /*
@@ -71,18 +143,104 @@ void scheduler_init(void)
  * WITHOUT a date change (lat/lon, TZ, DST, manual date set).
  *
  * Effect:
+ *  - Drops the solar service memo
  *  - Marks solar invalid
  *  - Forces recompute on next scheduler_update_day()
  *  - Touches schedule so main loop re-applies immediately
  */
 void scheduler_invalidate_solar(void)
 {
-    if (g_scheduler.have_sol) {
-        g_scheduler.have_sol = false;
-        schedule_touch();
+    /* Memoized days were computed from the old inputs */
+    solar_service_invalidate();
+
+    g_scheduler.sol_need = 0;
+
+    /* TZ / DST policy: local wall-clock offsets are recompiled */
+    s_days_valid = false;
+
+    g_scheduler.have_sol      = false;
+    g_scheduler.have_sol_prev = false;
+    g_scheduler.have_sol_next = false;
+
+    /* Even without solar data: local wall-clock events still move */
+    schedule_touch_solar();
+}
+
+/* --------------------------------------------------------------------------
+ * Calendar qualifiers
+ * -------------------------------------------------------------------------- */
+
+static inline bool slot_on(const uint8_t *mask, size_t slot)
+{
+    return (mask[slot >> 3] & (uint8_t)(1u << (slot & 7))) != 0;
+}
+
+/*
+ * One day's mask. Before the first scheduler_update_day() the date is
+ * unknown (month 0): only unqualified events run.
+ */
+static void day_mask(const Event *events, int y, int mo, int d, uint8_t *mask)
+{
+    memset(mask, 0, DAY_MASK_BYTES);
+
+    if (!events)
+        return;
+
+    bool known = (mo >= 1 && mo <= 12);
+    uint8_t wd = known ? (uint8_t)day_of_week(y, mo, d) : 0;
+
+    for (size_t i = 0; i < MAX_EVENTS; i++) {
+
+        const Event *ev = &events[i];
+
+        if (ev->refnum == 0)
+            continue;
+
+        bool on = known
+            ? event_on_day(ev, wd, (uint8_t)mo, (uint8_t)d)
+            : (ev->weekdays == 0 && ev->from_mo == 0);
+
+        if (on)
+            mask[i >> 3] |= (uint8_t)(1u << (i & 7));
     }
 }
 
+static void days_compile(void)
+{
+    const Event *events = config_events_get(NULL);
+
+    int y = g_scheduler.y, mo = g_scheduler.mo, d = g_scheduler.d;
+
+    day_mask(events, y, mo, d, s_on_today);
+
+    if (mo >= 1 && mo <= 12) {
+        int py = y, pmo = mo, pd = d;
+        int ny = y, nmo = mo, nd = d;
+
+        date_step(&py, &pmo, &pd, -1);
+        date_step(&ny, &nmo, &nd, +1);
+
+        day_mask(events, py, pmo, pd, s_on_prev);
+        day_mask(events, ny, nmo, nd, s_on_next);
+
+        day_utc_offset_get(y, mo, d, &s_off_today);
+        day_utc_offset_get(py, pmo, pd, &s_off_prev);
+        day_utc_offset_get(ny, nmo, nd, &s_off_next);
+    } else {
+        memcpy(s_on_prev, s_on_today, DAY_MASK_BYTES);
+        memcpy(s_on_next, s_on_today, DAY_MASK_BYTES);
+
+        /* Date unknown: local events resolve as UTC */
+        s_off_today.before = 0;
+        s_off_today.after  = 0;
+        s_off_today.change = 1440;
+        s_off_prev = s_off_today;
+        s_off_next = s_off_today;
+    }
+
+    s_days_valid = true;
+}
+
 /*
  * Update cached date and solar data for TODAY.
  *
@@ -91,18 +249,25 @@ void scheduler_invalidate_solar(void)
  */
 void scheduler_update_day(int y, int mo, int d,
                           const struct solar_times *sol,
-                          bool have_sol)
+                          bool have_sol,
+                          uint16_t sol_need)
 {
     /*
      * If the calendar date is unchanged AND
-     * solar validity did not change, this is a no-op.
+     * solar validity did not change AND
+     * the same quantities were requested, this is a no-op.
      */
     if (g_scheduler.y == y &&
         g_scheduler.mo == mo &&
         g_scheduler.d == d &&
-        g_scheduler.have_sol == have_sol)
+        g_scheduler.have_sol == have_sol &&
+        g_scheduler.sol_need == sol_need)
         return;
 
+    bool new_date = (g_scheduler.y  != y  ||
+                     g_scheduler.mo != mo ||
+                     g_scheduler.d  != d);
+
     /* Cache new date */
     g_scheduler.y  = y;
     g_scheduler.mo = mo;
@@ -110,6 +275,7 @@ void scheduler_update_day(int y, int mo, int d,
 
     /* Cache solar validity */
     g_scheduler.have_sol = have_sol;
+    g_scheduler.sol_need = sol_need;
 
     /* Copy solar data if provided */
     if (have_sol && sol)
@@ -117,9 +283,93 @@ void scheduler_update_day(int y, int mo, int d,
 
     /*
      * Date or solar context changed.
-     * This affects schedule resolution.
+     * This affects schedule resolution: a new day re-resolves every
+     * device, a solar change only those with solar refs.
      */
-    schedule_touch();
+    if (new_date) {
+        schedule_touch();
+        days_compile();
+    } else {
+        schedule_touch_solar();
+    }
+}
+
+/*
+ * Record solar data for the neighbouring days.
+ *
+ * Like scheduler_update_day(), this does NOT compute solar.
+ */
+static bool neighbor_same(bool have, const struct solar_times *cached,
+                          bool have_new, const struct solar_times *sol)
+{
+    if (have != have_new)
+        return false;
+
+    return !have || memcmp(cached, sol, sizeof(*sol)) == 0;
+}
+
+void scheduler_update_neighbors(const struct solar_times *prev,
+                                bool have_prev,
+                                const struct solar_times *next,
+                                bool have_next)
+{
+    have_prev = have_prev && prev;
+    have_next = have_next && next;
+
+    if (neighbor_same(g_scheduler.have_sol_prev, &g_scheduler.sol_prev,
+                      have_prev, prev) &&
+        neighbor_same(g_scheduler.have_sol_next, &g_scheduler.sol_next,
+                      have_next, next))
+        return;
+
+    g_scheduler.have_sol_prev = have_prev;
+    g_scheduler.have_sol_next = have_next;
+
+    if (have_prev)
+        g_scheduler.sol_prev = *prev;
+    if (have_next)
+        g_scheduler.sol_next = *next;
+
+    /* Carry-over and wrap resolve against these */
+    schedule_touch_solar();
+}
+
+/*
+ * Union of solar quantities referenced by used event slots.
+ *
+ * Cheap (one pass over MAX_EVENTS, no solar math); called whenever
+ * the main loop re-evaluates the schedule.
+ */
+uint16_t scheduler_solar_needs(void)
+{
+    size_t used = 0;
+    const Event *events = config_events_get(&used);
+
+    if (!events)
+        return 0;
+
+    uint16_t need = 0;
+
+    for (size_t i = 0; i < MAX_EVENTS; i++) {
+        if (events[i].refnum == 0)
+            continue;
+
+        need |= resolve_when_solar_need(events[i].when.ref);
+    }
+
+    return need;
+}
+
+uint16_t scheduler_solar_pending(int y, int mo, int d)
+{
+    uint16_t need = scheduler_solar_needs();
+
+    if (g_scheduler.y != y ||
+        g_scheduler.mo != mo ||
+        g_scheduler.d != d)
+        return need;
+
+    return (uint16_t)(need & ~g_scheduler.sol_need);
 }
 
 /* --------------------------------------------------------------------------
@@ -147,36 +397,134 @@ uint32_t schedule_etag(void)
 void schedule_touch(void)
 {
     g_schedule_etag++;
+    g_dirty_devices = SCHED_DIRTY_ALL;
+    s_days_valid = false;
+}
+
+void schedule_touch_devices(uint8_t device_mask)
+{
+    g_schedule_etag++;
+    g_dirty_devices |= device_mask;
+    s_days_valid = false;   /* qualifiers may have changed */
+}
+
+void schedule_touch_solar(void)
+{
+    g_schedule_etag++;
+    g_dirty_solar = true;
+}
+
+/*
+ * Return and clear the dirty device set.
+ *
+ * The solar bit is expanded here, not when set, so repeated solar
+ * touches cost one pass over the index.
+ */
+uint8_t scheduler_take_dirty(void)
+{
+    uint8_t mask = g_dirty_devices;
+
+    if (g_dirty_solar && mask != SCHED_DIRTY_ALL) {
+
+        size_t used = 0;
+        const Event *events = config_events_get(&used);
+
+        for (uint8_t d = 0; events && d < EVENT_INDEX_MAX_DEVICES; d++) {
+
+            uint8_t cnt = 0;
+            const uint8_t *slots = config_events_device_slots(d, &cnt);
+
+            for (uint8_t k = 0; k < cnt; k++) {
+                const struct When *w = &events[slots[k]].when;
+
+                if (resolve_when_solar_need(w->ref) ||
+                    w->ref == REF_LOCAL_MIDNIGHT) {
+                    mask |= (uint8_t)(1u << d);
+                    break;
+                }
+            }
+        }
+    }
+
+    g_dirty_devices = 0;
+    g_dirty_solar   = false;
+
+    return mask;
 }
 
 /* --------------------------------------------------------------------------
- * Queries
+ * Compiled timeline
  * -------------------------------------------------------------------------- */
 
 /*
- * Find the next scheduled event minute for TODAY.
+ * Per-device groups from the config_events index.
  *
- * This is a pure query:
- *  - No side effects
- *  - No mutation
+ * Each device's slots come ascending, so strict '>' keeps slot order
+ * for equal minutes within a device.
  */
-bool scheduler_next_event_minute(uint16_t now_minute,
-                                 uint16_t *out_minute)
+static void by_device_compile(void)
 {
-    if (!out_minute)
-        return false;
+    size_t used = 0;
+    const Event *events = config_events_get(&used);
+    const struct solar_times *sol =
+        g_scheduler.have_sol ? &g_scheduler.sol : NULL;
 
-    now_minute %= 1440u;
+    uint8_t n = 0;
 
+    for (uint8_t d = 0; d < EVENT_INDEX_MAX_DEVICES; d++) {
+
+        s_by_dev_start[d] = n;
+
+        uint8_t cnt = 0;
+        const uint8_t *slots = config_events_device_slots(d, &cnt);
+
+        for (uint8_t k = 0; events && k < cnt; k++) {
+
+            const Event *ev = &events[slots[k]];
+
+            if (!slot_on(s_on_today, slots[k]))
+                continue;
+
+            uint16_t minute;
+            if (!resolve_when_day(&ev->when, sol, &s_off_today, &minute))
+                continue;
+
+            uint8_t j = n++;
+
+            while (j > s_by_dev_start[d] && s_by_dev[j - 1].minute > minute) {
+                s_by_dev[j] = s_by_dev[j - 1];
+                j--;
+            }
+
+            s_by_dev[j].device_id = ev->device_id;
+            s_by_dev[j].action    = ev->action;
+            s_by_dev[j].refnum    = ev->refnum;
+            s_by_dev[j].minute    = minute;
+        }
+    }
+
+    s_by_dev_start[EVENT_INDEX_MAX_DEVICES] = n;
+}
+
+/*
+ * Neighbouring days: yesterday's last event per device (ties → higher
+ * slot, as the reducer) and tomorrow's earliest event.
+ */
+static void neighbors_compile(void)
+{
+    memset(s_carry, 0, sizeof(s_carry));
+    s_have_next_first = false;
 
     size_t used = 0;
     const Event *events = config_events_get(&used);
 
     if (!events)
-        return false;
+        return;
 
-    bool found = false;
-    uint16_t best = 0;
+    const struct solar_times *prev =
+        g_scheduler.have_sol_prev ? &g_scheduler.sol_prev : NULL;
+    const struct solar_times *next =
+        g_scheduler.have_sol_next ? &g_scheduler.sol_next : NULL;
 
     for (size_t i = 0; i < MAX_EVENTS; i++) {
 
@@ -186,48 +534,332 @@ bool scheduler_next_event_minute(uint16_t now_minute,
             continue;
 
         uint16_t minute;
-        if (!resolve_when(&ev->when,
-                          g_scheduler.have_sol ? &g_scheduler.sol : NULL,
-                          &minute))
-            continue;
 
-        /* must be strictly in the future */
-        if (minute <= now_minute)
-            continue;
+        if (ev->device_id < EVENT_INDEX_MAX_DEVICES &&
+            slot_on(s_on_prev, i) &&
+            resolve_when_day(&ev->when, prev, &s_off_prev, &minute)) {
+
+            struct ResolvedEvent *c = &s_carry[ev->device_id];
 
-        if (!found || minute < best) {
-            best = minute;
-            found = true;
+            if (c->refnum == 0 || minute >= c->minute) {
+                c->device_id = ev->device_id;
+                c->action    = ev->action;
+                c->refnum    = ev->refnum;
+                c->minute    = minute;
+            }
+        }
+
+        if (slot_on(s_on_next, i) &&
+            resolve_when_day(&ev->when, next, &s_off_next, &minute)) {
+            if (!s_have_next_first || minute < s_next_first) {
+                s_next_first = minute;
+                s_have_next_first = true;
+            }
         }
     }
+}
 
-    /* if nothing left today, wrap to earliest tomorrow */
+/*
+ * Greedy grouping over the sorted timeline (see sched_wake_group).
+ *
+ * Device IDs outside the index never constrain a group; the reducer
+ * ignores them.
+ */
+static void groups_compile(void)
+{
+    s_group_count = 0;
+
+    uint8_t i = 0;
+
+    while (i < s_timeline_count) {
+
+        struct sched_wake_group *g = &s_groups[s_group_count++];
+
+        g->begin = i;
+        g->first = s_timeline[i].minute;
+
+        uint8_t devices = 0;
+
+        do {
+            uint8_t id = s_timeline[i].device_id;
+
+            if (id < EVENT_INDEX_MAX_DEVICES) {
+                uint8_t bit = (uint8_t)(1u << id);
+                if (devices & bit)
+                    break;
+                devices |= bit;
+            }
+
+            g->last = s_timeline[i].minute;
+            i++;
+
+        } while (i < s_timeline_count &&
+                 s_timeline[i].minute <= g->first + s_coalesce_window);
+
+        g->end = i;
+    }
+}
+
+/*
+ * Resolve every used slot that runs today once and insertion-sort by
+ * minute.
+ *
+ * Strict '>' keeps slot order for equal minutes, which is the order
+ * the full-table scans visit them in.
+ */
+static void timeline_compile(void)
+{
+    s_timeline_count = 0;
+
+    /* Event edits since the date was set */
+    if (!s_days_valid)
+        days_compile();
 
-    if (!found) {
+    size_t used = 0;
+    const Event *events = config_events_get(&used);
+
+    if (events) {
+        const struct solar_times *sol =
+            g_scheduler.have_sol ? &g_scheduler.sol : NULL;
 
         for (size_t i = 0; i < MAX_EVENTS; i++) {
 
             const Event *ev = &events[i];
 
-            if (ev->refnum == 0)
+            if (ev->refnum == 0 || !slot_on(s_on_today, i))
                 continue;
 
             uint16_t minute;
-            if (!resolve_when(&ev->when,
-                              g_scheduler.have_sol ? &g_scheduler.sol : NULL,
-                              &minute))
+            if (!resolve_when_day(&ev->when, sol, &s_off_today, &minute))
                 continue;
 
-            if (!found || minute < best) {
-                best = minute;
-                found = true;
+            uint8_t j = s_timeline_count++;
+
+            while (j > 0 && s_timeline[j - 1].minute > minute) {
+                s_timeline[j] = s_timeline[j - 1];
+                j--;
             }
+
+            s_timeline[j].device_id = ev->device_id;
+            s_timeline[j].action    = ev->action;
+            s_timeline[j].refnum    = ev->refnum;
+            s_timeline[j].minute    = minute;
         }
     }
 
-    if (!found)
+    by_device_compile();
+    neighbors_compile();
+    groups_compile();
+
+    s_timeline_etag  = g_schedule_etag;
+    s_timeline_valid = true;
+}
+
+const struct ResolvedEvent *scheduler_timeline(size_t *count)
+{
+    if (!s_timeline_valid || s_timeline_etag != g_schedule_etag)
+        timeline_compile();
+
+    if (count)
+        *count = s_timeline_count;
+
+    return s_timeline;
+}
+
+const struct ResolvedEvent *scheduler_timeline_by_device(const uint8_t **start)
+{
+    if (!s_timeline_valid || s_timeline_etag != g_schedule_etag)
+        timeline_compile();
+
+    if (start)
+        *start = s_by_dev_start;
+
+    return s_by_dev;
+}
+
+const struct ResolvedEvent *scheduler_carry_over(void)
+{
+    if (!s_timeline_valid || s_timeline_etag != g_schedule_etag)
+        timeline_compile();
+
+    return s_carry;
+}
+
+uint8_t scheduler_devices_due(uint16_t after, uint16_t upto)
+{
+    if (upto < after)
+        return SCHED_DIRTY_ALL;
+
+    size_t n = 0;
+    const struct ResolvedEvent *tl = scheduler_timeline(&n);
+
+    size_t i   = resolved_upper_bound(tl, n, after);
+    size_t end = resolved_upper_bound(tl, n, upto);
+
+    uint8_t mask = 0;
+
+    for (; i < end; i++) {
+        if (tl[i].device_id < EVENT_INDEX_MAX_DEVICES)
+            mask |= (uint8_t)(1u << tl[i].device_id);
+    }
+
+    return mask;
+}
+
+/* --------------------------------------------------------------------------
+ * Wake coalescing
+ * -------------------------------------------------------------------------- */
+
+/* Device masks in groups_compile() are 8 bits */
+static_assert(EVENT_INDEX_MAX_DEVICES <= 8, "group device mask is 8 bits");
+
+void scheduler_set_coalesce(uint8_t window_minutes, uint8_t mode)
+{
+    if (mode != SCHED_COALESCE_EARLY)
+        mode = SCHED_COALESCE_LATE;
+
+    if (window_minutes == s_coalesce_window && mode == s_coalesce_mode)
+        return;
+
+    s_coalesce_window = window_minutes;
+    s_coalesce_mode   = mode;
+
+    schedule_touch();
+}
+
+const struct sched_wake_group *scheduler_wake_plan(size_t *count)
+{
+    if (!s_timeline_valid || s_timeline_etag != g_schedule_etag)
+        timeline_compile();
+
+    if (count)
+        *count = s_group_count;
+
+    return s_groups;
+}
+
+uint16_t scheduler_effective_minute(uint16_t now_minute)
+{
+    now_minute %= 1440u;
+
+    if (s_coalesce_mode != SCHED_COALESCE_EARLY)
+        return now_minute;
+
+    size_t n = 0;
+    const struct sched_wake_group *g = scheduler_wake_plan(&n);
+
+    /* Latest group with first <= now (upper bound on first, minus one) */
+    size_t lo = 0, hi = n;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (g[mid].first <= now_minute)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo == 0)
+        return now_minute;
+
+    uint16_t last = g[lo - 1].last;
+
+    return (last > now_minute) ? last : now_minute;
+}
+
+/* --------------------------------------------------------------------------
+ * Queries
+ * -------------------------------------------------------------------------- */
+
+/*
+ * Find the next scheduled event minute for TODAY.
+ *
+ * No table scan: upper bound in the compiled timeline, or tomorrow's
+ * first event (tomorrow's solar) when wrapping.
+ */
+bool scheduler_next_event_minute(uint16_t now_minute,
+                                 uint16_t *out_minute,
+                                 bool *out_tomorrow)
+{
+    if (!out_minute)
         return false;
 
-    *out_minute = best;
+    if (out_tomorrow)
+        *out_tomorrow = false;
+
+    now_minute %= 1440u;
+
+    size_t n = 0;
+    const struct ResolvedEvent *tl = scheduler_timeline(&n);
+
+    size_t i = resolved_upper_bound(tl, n, now_minute);
+
+    if (i < n) {
+        *out_minute = tl[i].minute;
+        return true;
+    }
+
+    /* if nothing left today, wrap to earliest tomorrow */
+    if (!s_have_next_first)
+        return false;
+
+    *out_minute = s_next_first;
+
+    if (out_tomorrow)
+        *out_tomorrow = true;
+
+    return true;
+}
+
+/*
+ * Next wake after coalescing.
+ *
+ * Binary search on the group boundary the mode wakes at; groups are
+ * time-ordered, so both first and last are non-decreasing.
+ */
+bool scheduler_next_wake_minute(uint16_t now_minute,
+                                uint16_t *out_minute,
+                                bool *out_tomorrow)
+{
+    if (!out_minute)
+        return false;
+
+    if (out_tomorrow)
+        *out_tomorrow = false;
+
+    now_minute %= 1440u;
+
+    size_t n = 0;
+    const struct sched_wake_group *g = scheduler_wake_plan(&n);
+
+    bool early = (s_coalesce_mode == SCHED_COALESCE_EARLY);
+
+    size_t lo = 0, hi = n;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        uint16_t m = early ? g[mid].first : g[mid].last;
+
+        if (m <= now_minute)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo < n) {
+        *out_minute = early ? g[lo].first : g[lo].last;
+        return true;
+    }
+
+    /* if nothing left today, wrap to earliest tomorrow */
+    if (!s_have_next_first)
+        return false;
+
+    *out_minute = s_next_first;
+
+    if (out_tomorrow)
+        *out_tomorrow = true;
+
     return true;
 }
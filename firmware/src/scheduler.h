@@ -5,29 +5,36 @@
  * Purpose: Day-scoped event scheduler (shared: host + firmware)
  *
  * What this IS:
- *  - Answers questions about TODAY only
+ *  - Answers questions about TODAY, with yesterday / tomorrow context
  *  - Knows when the next scheduled event occurs (minute-of-day)
- *  - Caches solar data for the current day
- *  - Exposes a change token (ETag) for schedule invalidation
+ *  - Compiles today's events into a sorted timeline (once per ETag)
+ *  - Groups nearby events into shared wakes (coalescing window)
+ *  - Caches solar data for yesterday, today and tomorrow
+ *  - Knows which solar quantities the event table needs
+ *  - Exposes a change token (ETag) for schedule invalidation, plus
+ *    which devices a change affects
  *
  * What this is NOT:
  *  - No device execution
  *  - No RTC access
  *  - No config mutation
- *  - No timezone or DST logic
+ *  - No timezone or DST rules: local wall-clock events use each
+ *    day's offsets from time_dst, compiled with the day
  *
  * Design rules:
  *  - Global, single instance
  *  - Deterministic
  *  - No dynamic allocation
  *
- * Updated: 2026-01-08
+ * Updated: 2026-10-16
  * ========================================================================== */
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include "events.h"
 #include "solar.h"
 
 /* --------------------------------------------------------------------------
@@ -44,6 +51,13 @@ struct scheduler_ctx {
     int y, mo, d;               /* date solar cache applies to */
     struct solar_times sol;     /* cached solar times */
     bool have_sol;              /* false if solar unavailable/invalid */
+    uint16_t sol_need;          /* SOLAR_Q_* requested for this date */
+
+    /* Neighbouring UTC days, same SOLAR_Q_* set as today */
+    struct solar_times sol_prev;
+    bool have_sol_prev;
+    struct solar_times sol_next;
+    bool have_sol_next;
 };
 
 /* Global scheduler instance */
@@ -72,8 +86,10 @@ void scheduler_init(void);
  *  - manual date set
  *
  * Effect:
+ *  - Drops memoized days in the solar service
  *  - Marks solar cache invalid
  *  - Forces recompute on next scheduler_update_day()
+ *  - Recompiles the days' local wall-clock offsets (TZ / DST)
  *
  * NOTE:
  *  - Does NOT recompute immediately
@@ -87,14 +103,62 @@ void scheduler_invalidate_solar(void);
  * Caller supplies:
  *  - current calendar date
  *  - solar times for today (if available)
+ *  - the SOLAR_Q_* set those times were computed for
  *
  * Behavior:
- *  - If date unchanged AND solar still valid → no-op
+ *  - If date, solar validity and requested set are unchanged → no-op
  *  - Otherwise cache new date and solar state
+ *  - A new date compiles the events' calendar qualifiers (weekdays,
+ *    season) for yesterday, today and tomorrow into per-slot bitmasks,
+ *    and each day's UTC offsets (day_utc_offset_get()) for local
+ *    wall-clock events; the timeline, carry-over and wrap only test
+ *    those bits and compare UTC minutes
  */
 void scheduler_update_day(int y, int mo, int d,
                           const struct solar_times *sol,
-                          bool have_sol);
+                          bool have_sol,
+                          uint16_t sol_need);
+
+/*
+ * Update solar data for yesterday and tomorrow.
+ *
+ * Call after scheduler_update_day() with solar times for the days
+ * before and after it (same SOLAR_Q_* set).
+ *
+ * Used for:
+ *  - carry-over: the governing event before today's first event is
+ *    yesterday's last (after a reset at 02:00 the door still has one)
+ *  - wrap: tomorrow's first event is resolved with tomorrow's solar
+ *
+ * Behavior:
+ *  - Unchanged inputs → no-op
+ *  - Otherwise cache and touch the ETag
+ */
+void scheduler_update_neighbors(const struct solar_times *prev,
+                                bool have_prev,
+                                const struct solar_times *next,
+                                bool have_next);
+
+/*
+ * Solar quantities the event table references.
+ *
+ * Returns the SOLAR_Q_* union over all used slots. A table with no
+ * solar refs returns 0 and no solar math needs to run at all.
+ */
+uint16_t scheduler_solar_needs(void);
+
+/*
+ * Solar quantities needed for (y, mo, d) that the cache does not hold.
+ *
+ * Non-zero when:
+ *  - the date differs from the cached one (and any are needed)
+ *  - an event was added that references a new quantity
+ *  - scheduler_invalidate_solar() was called
+ *
+ * The caller recomputes with scheduler_solar_needs() and passes the
+ * result to scheduler_update_day().
+ */
+uint16_t scheduler_solar_pending(int y, int mo, int d);
 
 /* --------------------------------------------------------------------------
  * Schedule change tracking (ETag)
@@ -134,6 +198,138 @@ uint32_t schedule_etag(void);
  */
 void schedule_touch(void);
 
+/* Dirty mask meaning "every device" */
+#define SCHED_DIRTY_ALL 0xFFu
+
+/*
+ * Mark the schedule as changed for some devices only.
+ *
+ * device_mask: bit d set → device ID d affected (IDs 0..7).
+ * Bumps the ETag like schedule_touch(); called by the config_events
+ * mutators with the old and new device of the edited slot.
+ */
+void schedule_touch_devices(uint8_t device_mask);
+
+/*
+ * Mark solar inputs as changed.
+ *
+ * Bumps the ETag; only devices with solar-referenced or local
+ * wall-clock events become dirty (resolved when the mask is taken).
+ */
+void schedule_touch_solar(void);
+
+/*
+ * Return and clear the set of devices whose reduction may have
+ * changed since the last call (SCHED_DIRTY_ALL after boot, a date
+ * change or a generic schedule_touch()).
+ */
+uint8_t scheduler_take_dirty(void);
+
+/* --------------------------------------------------------------------------
+ * Compiled timeline
+ * -------------------------------------------------------------------------- */
+
+/*
+ * Today's events, resolved and sorted by minute-of-day.
+ *
+ * Returns:
+ *   pointer to the sorted array; *count set to its length
+ *
+ * Behavior:
+ *   - Compiled from the sparse table on first use after the ETag
+ *     changes (event edits, date, solar context); otherwise cached
+ *   - Unused slots and events that fail resolve_when() are dropped
+ *   - Equal minutes keep slot order (lower slot first)
+ *
+ * Notes:
+ *   - Valid until the next schedule_touch()
+ *   - Solar resolution uses cached scheduler solar context
+ */
+const struct ResolvedEvent *scheduler_timeline(size_t *count);
+
+/*
+ * Today's events grouped by device (config_events index).
+ *
+ * Returns:
+ *   array holding each device's resolved events, minute-sorted
+ *   (slot order on ties); *start receives EVENT_INDEX_MAX_DEVICES + 1
+ *   offsets, device d owning [start[d], start[d + 1])
+ *
+ * Notes:
+ *   - Compiled together with scheduler_timeline(), same lifetime
+ */
+const struct ResolvedEvent *scheduler_timeline_by_device(const uint8_t **start);
+
+/*
+ * Yesterday's governing event per device.
+ *
+ * Returns:
+ *   EVENT_INDEX_MAX_DEVICES entries; entry d is device d's last event
+ *   of yesterday (resolved with yesterday's solar), refnum == 0 if none
+ *
+ * Notes:
+ *   - Minutes are yesterday's minute-of-day
+ *   - Compiled together with scheduler_timeline()
+ */
+const struct ResolvedEvent *scheduler_carry_over(void);
+
+/*
+ * Devices with an event in (after, upto], from today's timeline.
+ *
+ * Used on a minute tick: only these can have a new governing event.
+ * upto < after (day wrapped) → SCHED_DIRTY_ALL.
+ */
+uint8_t scheduler_devices_due(uint16_t after, uint16_t upto);
+
+/* --------------------------------------------------------------------------
+ * Wake coalescing
+ * -------------------------------------------------------------------------- */
+
+/* Coalescing modes */
+#define SCHED_COALESCE_LATE   0   /* wake at the group's last event */
+#define SCHED_COALESCE_EARLY  1   /* wake at its first, pre-execute the rest */
+
+/*
+ * One wake of today's plan: timeline entries [begin, end).
+ *
+ * A group starts at an event and takes the following events while
+ *  - their minute is within window minutes of the group's first, and
+ *  - their device is not already in the group
+ * so no device ever skips an intermediate state.
+ */
+struct sched_wake_group {
+    uint16_t first;             /* minute of the first event */
+    uint16_t last;              /* minute of the last event */
+    uint8_t  begin;             /* timeline index */
+    uint8_t  end;               /* timeline index, exclusive */
+};
+
+/*
+ * Set the coalescing window (minutes, 0 = off) and mode.
+ *
+ * Unchanged values → no-op; otherwise touches the ETag so the plan is
+ * recompiled.
+ */
+void scheduler_set_coalesce(uint8_t window_minutes, uint8_t mode);
+
+/*
+ * Today's wake plan.
+ *
+ * Returns the groups in time order; *count receives how many. Same
+ * lifetime as scheduler_timeline().
+ */
+const struct sched_wake_group *scheduler_wake_plan(size_t *count);
+
+/*
+ * Minute the reducer should evaluate at.
+ *
+ * LATE (or window 0): now_minute.
+ * EARLY: the last minute of the latest group that has started, if
+ * later than now_minute, so the group's remaining events run in the
+ * same wake.
+ */
+uint16_t scheduler_effective_minute(uint16_t now_minute);
+
 /* --------------------------------------------------------------------------
  * Queries
  * -------------------------------------------------------------------------- */
@@ -142,7 +338,8 @@ void schedule_touch(void);
  * Find the next scheduled event minute.
  *
  * Parameters:
- *   now_minute  - current UTC minute-of-day (0..1439)
+ *   now_minute   - current UTC minute-of-day (0..1439)
+ *   out_tomorrow - optional; set true when out_minute is tomorrow's
  *
  * Returns:
  *   true  → out_minute set to the next event minute-of-day (0..1439)
@@ -150,13 +347,30 @@ void schedule_touch(void);
  *
  * Behavior:
  *   - Finds the earliest event strictly after now_minute
- *   - If no future event exists today, wraps to the earliest event tomorrow
+ *   - If no future event exists today, wraps to the earliest event
+ *     tomorrow, resolved with tomorrow's solar times
+ *   - A tomorrow minute can be later than now_minute (solar drift,
+ *     qualifiers, local time): an HH:MM alarm armed for it would
+ *     fire today; the main loop sleeps to 00:00 first
  *   - Ignores empty slots (refnum == 0)
  *   - Ignores events that fail resolve_when()
  *
  * Notes:
  *   - All times are UTC minute-of-day
  *   - Solar resolution uses cached scheduler solar context
+ *   - Binary search in the compiled timeline
  */
 bool scheduler_next_event_minute(uint16_t now_minute,
-                                 uint16_t *out_minute);
+                                 uint16_t *out_minute,
+                                 bool *out_tomorrow);
+
+/*
+ * Find the next wake minute after coalescing.
+ *
+ * Same contract as scheduler_next_event_minute(), but returns the
+ * wake of the next group: its last event (LATE) or its first (EARLY).
+ * Tomorrow's wrap target is tomorrow's first event.
+ */
+bool scheduler_next_wake_minute(uint16_t now_minute,
+                                uint16_t *out_minute,
+                                bool *out_tomorrow);
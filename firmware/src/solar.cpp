@@ -10,14 +10,19 @@
  *  - No network dependencies
  *
  * This file contains:
- *  - Pure astronomical math (NOAA-based)
- *  - One application-level helper that pulls config + RTC state
+ *  - Pure astronomical math (NOAA-based, floating point)
+ *  - Helpers shared with the fixed-point engine (solar_fixed.cpp)
+ *  - solar_compute() / solar_compute_e4() engine dispatch
+ *    (a baked site table, if built in, answers first)
  *
- * Updated: 2026-01-08
+ * Updated: 2026-10-16
  */
 
 #include "solar.h"
+#include "solar_engine.h"
+#include "solar_baked.h"
 #include <math.h>
+#include <stddef.h>
 
 #include "config.h"
 
@@ -69,7 +74,7 @@ static inline uint16_t round_minutes(double x)
  *  end   = 00:10 (10)
  *  → duration = 20 minutes
  * -------------------------------------------------------------------------- */
-static uint16_t duration(uint16_t start, uint16_t end)
+uint16_t solar_duration(uint16_t start, uint16_t end)
 {
     if (end >= start)
         return end - start;
@@ -86,7 +91,7 @@ static uint16_t duration(uint16_t start, uint16_t end)
  *  - divisible by 4
  *  - except centuries unless divisible by 400
  * -------------------------------------------------------------------------- */
-static int doy(int y, int m, int d)
+int solar_day_of_year(int y, int m, int d)
 {
     static const int mdays[] =
         { 0,31,59,90,120,151,181,212,243,273,304,334 };
@@ -97,39 +102,33 @@ static int doy(int y, int m, int d)
 }
 
 /* --------------------------------------------------------------------------
- * Core NOAA solar event calculation
- *
- * This computes ONE solar event:
- *  - sunrise OR sunset
- *  - standard OR civil (via zenith angle)
- *
- * Inputs:
- *  - day_of_year
- *  - latitude / longitude
- *  - timezone offset (already DST-adjusted)
- *  - zenith angle:
- *      90.833 → official sunrise/sunset
- *      96.0   → civil dawn/dusk
- *  - sunrise flag (true = sunrise, false = sunset)
- *
- * Output:
- *  - minutes_out: fractional minute-of-day (0..1440)
+ * Advance (year, day-of-year) by one day
+ * -------------------------------------------------------------------------- */
+void solar_next_day(uint16_t *year, int *doy)
+{
+    int y = *year;
+    bool leap = (y % 4 == 0 && y % 100 != 0) || (y % 400 == 0);
+
+    if (++(*doy) > (leap ? 366 : 365)) {
+        *doy = 1;
+        (*year)++;
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * NOAA day-constant ephemeris
  *
- * Returns false if the sun never rises or sets that day
- * (e.g., extreme latitudes).
+ * Everything in the NOAA event calculation that does not depend on the
+ * zenith angle. One per anchor time:
+ *  - sunrise side: t = day + (06:00 - lngHour)
+ *  - sunset  side: t = day + (18:00 - lngHour)
  * -------------------------------------------------------------------------- */
-static bool calc_event(
+void solar_noaa_ephemeris(
     int day_of_year,
-    double lat,
-    double lon,
-    int tz,
-    double zenith,
+    double lngHour,
     bool sunrise,
-    double &minutes_out)
+    struct solar_noaa_ephem *e)
 {
-    /* Longitude hour value */
-    double lngHour = lon / 15.0;
-
     /* Approximate time */
     double t = sunrise
         ? day_of_year + ((6.0  - lngHour) / 24.0)
@@ -160,14 +159,62 @@ static bool calc_event(
     RA = (RA + (Lq - RAq)) / 15.0;
 
     /* Declination */
-    double sinDec = 0.39782 * sin(L * DEG2RAD);
-    double cosDec = cos(asin(sinDec));
+    e->sinDec = 0.39782 * sin(L * DEG2RAD);
+    e->cosDec = cos(asin(e->sinDec));
+
+    /* Local mean time → universal time, minus the hour angle */
+    e->ut_base = RA - (0.06571 * t) - 6.622 - lngHour;
+}
+
+/* --------------------------------------------------------------------------
+ * Universal time (hours, any range) → local fractional minute-of-day
+ * -------------------------------------------------------------------------- */
+static double noaa_ut_minutes(double UT, int tz)
+{
+    while (UT < 0.0)   UT += 24.0;
+    while (UT >= 24.0) UT -= 24.0;
 
+    /* Convert to local minutes */
+    double minutes = (UT + tz) * 60.0;
+
+    /* Normalize minute-of-day */
+    if (minutes < 0.0)     minutes += 1440.0;
+    if (minutes >= 1440.0) minutes -= 1440.0;
+
+    return minutes;
+}
+
+/* --------------------------------------------------------------------------
+ * One zenith crossing from a precomputed ephemeris
+ *
+ * Inputs:
+ *  - ephemeris for the matching sunrise/sunset side
+ *  - sin/cos of latitude
+ *  - cos of zenith angle:
+ *      90.833 → official sunrise/sunset
+ *      96.0   → civil dawn/dusk
+ *  - timezone offset (already DST-adjusted)
+ *  - sunrise flag (true = sunrise, false = sunset)
+ *
+ * Output:
+ *  - minutes_out: fractional minute-of-day (0..1440)
+ *
+ * Returns false if the sun never rises or sets that day
+ * (e.g., extreme latitudes).
+ * -------------------------------------------------------------------------- */
+static bool noaa_crossing(
+    const struct solar_noaa_ephem &e,
+    double sinLat,
+    double cosLat,
+    double cosZ,
+    int tz,
+    bool sunrise,
+    double &minutes_out)
+{
     /* Local hour angle */
     double cosH =
-        (cos(zenith * DEG2RAD) -
-         sinDec * sin(lat * DEG2RAD)) /
-        (cosDec * cos(lat * DEG2RAD));
+        (cosZ - e.sinDec * sinLat) /
+        (e.cosDec * cosLat);
 
     /* Sun never rises or sets */
     if (cosH > 1.0 || cosH < -1.0)
@@ -179,27 +226,300 @@ static bool calc_event(
 
     H /= 15.0;
 
-    /* Local mean time */
-    double T = H + RA - (0.06571 * t) - 6.622;
+    minutes_out = noaa_ut_minutes(H + e.ut_base, tz);
+    return true;
+}
 
-    /* Universal time */
-    double UT = T - lngHour;
+/* --------------------------------------------------------------------------
+ * Solar noon from a precomputed ephemeris (hour angle 0, always exists)
+ * -------------------------------------------------------------------------- */
+static double noaa_transit(const struct solar_noaa_ephem &e, int tz)
+{
+    return noaa_ut_minutes(e.ut_base, tz);
+}
 
-    while (UT < 0.0)   UT += 24.0;
-    while (UT >= 24.0) UT -= 24.0;
+/* Round to minute resolution (1439.5.. rounds up to 1440 → 0) */
+static inline uint16_t noaa_minute(double m)
+{
+    uint16_t minute = round_minutes(m);
 
-    /* Convert to local minutes */
-    minutes_out = (UT + tz) * 60.0;
+    if (minute >= 1440)
+        minute -= 1440;
 
-    /* Normalize minute-of-day */
-    if (minutes_out < 0.0)     minutes_out += 1440.0;
-    if (minutes_out >= 1440.0) minutes_out -= 1440.0;
+    return minute;
+}
+
+/* --------------------------------------------------------------------------
+ * One rounded event minute (crossing + rounding), shared with the
+ * host batch path so both produce identical bits
+ * -------------------------------------------------------------------------- */
+bool solar_noaa_event_minute(
+    const struct solar_noaa_ephem *e,
+    double   sinLat,
+    double   cosLat,
+    double   cosZ,
+    int8_t   tz,
+    bool     sunrise,
+    uint16_t *minute)
+{
+    double m;
+
+    if (!noaa_crossing(*e, sinLat, cosLat, cosZ, tz, sunrise, m)) {
+        *minute = 0;
+        return false;
+    }
 
+    *minute = noaa_minute(m);
     return true;
 }
 
 /* --------------------------------------------------------------------------
- * Public API: pure solar computation
+ * Standard event set shared by both engines
+ * -------------------------------------------------------------------------- */
+void solar_std_events_init(struct solar_event ev[SOLAR_STD_EVENTS])
+{
+    ev[0].zenith_mdeg = SOLAR_ZENITH_OFFICIAL_MDEG; ev[0].sunrise = true;
+    ev[1].zenith_mdeg = SOLAR_ZENITH_OFFICIAL_MDEG; ev[1].sunrise = false;
+    ev[2].zenith_mdeg = SOLAR_ZENITH_CIVIL_MDEG;    ev[2].sunrise = true;
+    ev[3].zenith_mdeg = SOLAR_ZENITH_CIVIL_MDEG;    ev[3].sunrise = false;
+}
+
+void solar_times_set_std(struct solar_times *out,
+                         uint16_t rise_std, uint16_t set_std,
+                         uint16_t rise_civ, uint16_t set_civ)
+{
+    out->sunrise_std = rise_std;
+    out->sunset_std  = set_std;
+    out->sunrise_civ = rise_civ;
+    out->sunset_civ  = set_civ;
+
+    /* Derived durations */
+    out->day_length     = solar_duration(rise_std, set_std);
+    out->visible_length = solar_duration(rise_civ, set_civ);
+
+    /* Extended quantities are only filled on request */
+    out->sunrise_naut  = 0;
+    out->sunset_naut   = 0;
+    out->sunrise_astro = 0;
+    out->sunset_astro  = 0;
+    out->noon          = 0;
+
+    out->valid_mask = SOLAR_Q_STD_CIV;
+}
+
+bool solar_times_from_events(const struct solar_event ev[SOLAR_STD_EVENTS],
+                             struct solar_times *out)
+{
+    for (uint8_t i = 0; i < SOLAR_STD_EVENTS; i++) {
+        if (!ev[i].valid)
+            return false;
+    }
+
+    solar_times_set_std(out, ev[0].minute, ev[1].minute,
+                        ev[2].minute, ev[3].minute);
+    return true;
+}
+
+/* --------------------------------------------------------------------------
+ * Solar quantity → kernel event + struct solar_times field
+ *
+ * Ordered so that events sharing a zenith angle are adjacent.
+ * -------------------------------------------------------------------------- */
+static const struct {
+    uint16_t q;
+    uint32_t zenith_mdeg;
+    bool     sunrise;
+    uint8_t  field;     /* offsetof(struct solar_times, ...) */
+} solar_quantities[] = {
+    { SOLAR_Q_STD_RISE,   SOLAR_ZENITH_OFFICIAL_MDEG, true,  offsetof(struct solar_times, sunrise_std)   },
+    { SOLAR_Q_STD_SET,    SOLAR_ZENITH_OFFICIAL_MDEG, false, offsetof(struct solar_times, sunset_std)    },
+    { SOLAR_Q_CIV_RISE,   SOLAR_ZENITH_CIVIL_MDEG,    true,  offsetof(struct solar_times, sunrise_civ)   },
+    { SOLAR_Q_CIV_SET,    SOLAR_ZENITH_CIVIL_MDEG,    false, offsetof(struct solar_times, sunset_civ)    },
+    { SOLAR_Q_NAUT_RISE,  SOLAR_ZENITH_NAUTICAL_MDEG, true,  offsetof(struct solar_times, sunrise_naut)  },
+    { SOLAR_Q_NAUT_SET,   SOLAR_ZENITH_NAUTICAL_MDEG, false, offsetof(struct solar_times, sunset_naut)   },
+    { SOLAR_Q_ASTRO_RISE, SOLAR_ZENITH_ASTRO_MDEG,    true,  offsetof(struct solar_times, sunrise_astro) },
+    { SOLAR_Q_ASTRO_SET,  SOLAR_ZENITH_ASTRO_MDEG,    false, offsetof(struct solar_times, sunset_astro)  },
+    { SOLAR_Q_NOON,       SOLAR_ZENITH_TRANSIT,       true,  offsetof(struct solar_times, noon)          },
+};
+
+#define SOLAR_QUANTITIES (sizeof(solar_quantities) / sizeof(solar_quantities[0]))
+
+/* --------------------------------------------------------------------------
+ * NOAA location constants
+ *
+ * Everything that depends only on where, not when. Computed once per
+ * kernel call, or once per solar_noaa_range() call.
+ * -------------------------------------------------------------------------- */
+#define NOAA_ZENITH_SLOTS 4
+
+struct noaa_loc {
+    double   lngHour;
+    double   sinLat;
+    double   cosLat;
+
+    /* cos(zenith) cache; std, civil, nautical, astronomical */
+    uint8_t  nzen;
+    uint32_t zen_mdeg[NOAA_ZENITH_SLOTS];
+    double   cosZ[NOAA_ZENITH_SLOTS];
+};
+
+void solar_noaa_site(double lat, double lon,
+                     double *lngHour, double *sinLat, double *cosLat)
+{
+    /* Longitude hour value */
+    *lngHour = lon / 15.0;
+
+    *sinLat = sin(lat * DEG2RAD);
+    *cosLat = cos(lat * DEG2RAD);
+}
+
+double solar_noaa_cosZ(uint32_t zenith_mdeg)
+{
+    return cos((double)zenith_mdeg * (DEG2RAD / 1000.0));
+}
+
+static void noaa_loc_init(struct noaa_loc &loc, double lat, double lon)
+{
+    solar_noaa_site(lat, lon, &loc.lngHour, &loc.sinLat, &loc.cosLat);
+
+    loc.nzen = 0;
+}
+
+static double noaa_loc_cosZ(struct noaa_loc &loc, uint32_t zenith_mdeg)
+{
+    for (uint8_t i = 0; i < loc.nzen; i++) {
+        if (loc.zen_mdeg[i] == zenith_mdeg)
+            return loc.cosZ[i];
+    }
+
+    double c = solar_noaa_cosZ(zenith_mdeg);
+
+    if (loc.nzen < NOAA_ZENITH_SLOTS) {
+        loc.zen_mdeg[loc.nzen] = zenith_mdeg;
+        loc.cosZ[loc.nzen]     = c;
+        loc.nzen++;
+    }
+
+    return c;
+}
+
+/* --------------------------------------------------------------------------
+ * NOAA events for one day-of-year
+ *
+ * Each anchor ephemeris is computed at most once and shared by every
+ * event on that side.
+ *
+ * Returns the number of valid events.
+ * -------------------------------------------------------------------------- */
+static uint8_t noaa_day_events(
+    struct noaa_loc &loc,
+    int day_of_year,
+    int8_t tz,
+    struct solar_event *ev,
+    uint8_t count)
+{
+    struct solar_noaa_ephem eph[2];
+    bool have_eph[2] = { false, false };
+
+    uint8_t valid = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+
+        uint8_t side = ev[i].sunrise ? 0 : 1;
+
+        if (!have_eph[side]) {
+            solar_noaa_ephemeris(day_of_year, loc.lngHour, ev[i].sunrise,
+                                 &eph[side]);
+            have_eph[side] = true;
+        }
+
+        if (ev[i].zenith_mdeg == SOLAR_ZENITH_TRANSIT) {
+            ev[i].minute = noaa_minute(noaa_transit(eph[side], tz));
+            ev[i].valid  = true;
+        } else {
+            double cosZ = noaa_loc_cosZ(loc, ev[i].zenith_mdeg);
+
+            ev[i].valid = solar_noaa_event_minute(&eph[side],
+                                                  loc.sinLat, loc.cosLat,
+                                                  cosZ, tz, ev[i].sunrise,
+                                                  &ev[i].minute);
+        }
+
+        if (ev[i].valid)
+            valid++;
+    }
+
+    return valid;
+}
+
+/* --------------------------------------------------------------------------
+ * NOAA event kernel
+ * -------------------------------------------------------------------------- */
+uint8_t solar_noaa_events(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    double   lat,
+    double   lon,
+    int8_t   tz,
+    struct solar_event *ev,
+    uint8_t  count)
+{
+    if (!ev || count == 0)
+        return 0;
+
+    struct noaa_loc loc;
+    noaa_loc_init(loc, lat, lon);
+
+    return noaa_day_events(loc, solar_day_of_year(year, month, day),
+                           tz, ev, count);
+}
+
+/* --------------------------------------------------------------------------
+ * NOAA multi-day walk
+ *
+ * Location constants once, then one day-of-year step per day.
+ * Results are identical to calling solar_noaa_compute() per day.
+ * -------------------------------------------------------------------------- */
+uint8_t solar_noaa_range(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    uint8_t  ndays,
+    double   lat,
+    double   lon,
+    int8_t   tz,
+    struct solar_times *out,
+    bool *valid)
+{
+    if (!out || !valid)
+        return 0;
+
+    struct noaa_loc loc;
+    noaa_loc_init(loc, lat, lon);
+
+    int doy = solar_day_of_year(year, month, day);
+    uint8_t n_ok = 0;
+
+    for (uint8_t i = 0; i < ndays; i++) {
+
+        struct solar_event ev[SOLAR_STD_EVENTS];
+        solar_std_events_init(ev);
+
+        noaa_day_events(loc, doy, tz, ev, SOLAR_STD_EVENTS);
+
+        valid[i] = solar_times_from_events(ev, &out[i]);
+        if (valid[i])
+            n_ok++;
+
+        solar_next_day(&year, &doy);
+    }
+
+    return n_ok;
+}
+
+/* --------------------------------------------------------------------------
+ * NOAA floating point engine (standard + civil, via the kernel)
  *
  * Caller supplies:
  *  - date
@@ -210,7 +530,7 @@ static bool calc_event(
  * No config.
  * No RTC.
  * -------------------------------------------------------------------------- */
-bool solar_compute(
+bool solar_noaa_compute(
     uint16_t year,
     uint8_t  month,
     uint8_t  day,
@@ -222,30 +542,183 @@ bool solar_compute(
     if (!out)
         return false;
 
-    int n = doy(year, month, day);
+    struct solar_event ev[SOLAR_STD_EVENTS];
+    solar_std_events_init(ev);
+
+    if (solar_noaa_events(year, month, day, lat, lon, tz,
+                          ev, SOLAR_STD_EVENTS) != SOLAR_STD_EVENTS)
+        return false;
+
+    return solar_times_from_events(ev, out);
+}
+
+/* --------------------------------------------------------------------------
+ * Public API: pure solar computation
+ *
+ * Engine is selected at build time (see solar_engine.h).
+ * -------------------------------------------------------------------------- */
+bool solar_compute(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    double   lat,
+    double   lon,
+    int8_t   tz,
+    struct solar_times *out)
+{
+#if defined(SOLAR_ENGINE_FIXED)
+    int32_t lat_e4 = (int32_t)(lat * 10000.0 + (lat < 0.0 ? -0.5 : 0.5));
+    int32_t lon_e4 = (int32_t)(lon * 10000.0 + (lon < 0.0 ? -0.5 : 0.5));
+
+    return solar_fixed_compute(year, month, day, lat_e4, lon_e4, tz, out);
+#else
+    return solar_noaa_compute(year, month, day, lat, lon, tz, out);
+#endif
+}
+
+/* --------------------------------------------------------------------------
+ * Public API: pure solar computation, config-native units
+ *
+ * Latitude / longitude in degrees * 1e4 (as stored in struct config).
+ * The fixed-point engine consumes these directly; no float is touched.
+ * -------------------------------------------------------------------------- */
+bool solar_compute_e4(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    int32_t  lat_e4,
+    int32_t  lon_e4,
+    int8_t   tz,
+    struct solar_times *out)
+{
+#if defined(SOLAR_BAKED)
+    /* Fixed installation: flash table read while the location matches */
+    bool have_sol;
+    if (solar_baked_lookup(year, month, day, lat_e4, lon_e4, tz, out, &have_sol))
+        return have_sol;
+#endif
+
+#if defined(SOLAR_ENGINE_FIXED)
+    return solar_fixed_compute(year, month, day, lat_e4, lon_e4, tz, out);
+#else
+    return solar_noaa_compute(year, month, day,
+                              (double)lat_e4 / 10000.0,
+                              (double)lon_e4 / 10000.0,
+                              tz, out);
+#endif
+}
+
+/* --------------------------------------------------------------------------
+ * Public API: event kernel
+ * -------------------------------------------------------------------------- */
+uint8_t solar_events_compute(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    int32_t  lat_e4,
+    int32_t  lon_e4,
+    int8_t   tz,
+    struct solar_event *ev,
+    uint8_t  count)
+{
+#if defined(SOLAR_ENGINE_FIXED)
+    return solar_fixed_events(year, month, day, lat_e4, lon_e4, tz,
+                              ev, count);
+#else
+    return solar_noaa_events(year, month, day,
+                             (double)lat_e4 / 10000.0,
+                             (double)lon_e4 / 10000.0,
+                             tz, ev, count);
+#endif
+}
+
+/* --------------------------------------------------------------------------
+ * Public API: multi-day walk
+ * -------------------------------------------------------------------------- */
+uint8_t solar_compute_range(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    uint8_t  ndays,
+    int32_t  lat_e4,
+    int32_t  lon_e4,
+    int8_t   tz,
+    struct solar_times *out,
+    bool *valid)
+{
+#if defined(SOLAR_ENGINE_FIXED)
+    return solar_fixed_range(year, month, day, ndays, lat_e4, lon_e4, tz,
+                             out, valid);
+#else
+    return solar_noaa_range(year, month, day, ndays,
+                            (double)lat_e4 / 10000.0,
+                            (double)lon_e4 / 10000.0,
+                            tz, out, valid);
+#endif
+}
 
-    double sr_std, ss_std, sr_civ, ss_civ;
+/* --------------------------------------------------------------------------
+ * Public API: requested subset
+ *
+ * Builds a kernel request from the SOLAR_Q_* bits only. With nothing
+ * requested no ephemeris is evaluated at all.
+ * -------------------------------------------------------------------------- */
+uint16_t solar_compute_mask(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    int32_t  lat_e4,
+    int32_t  lon_e4,
+    int8_t   tz,
+    uint16_t need,
+    struct solar_times *out)
+{
+    if (!out)
+        return 0;
 
-    /* Standard sunrise/sunset */
-    if (!calc_event(n, lat, lon, tz, 90.833, true,  sr_std)) return false;
-    if (!calc_event(n, lat, lon, tz, 90.833, false, ss_std)) return false;
+    struct solar_event ev[SOLAR_QUANTITIES];
+    uint8_t which[SOLAR_QUANTITIES];
+    uint8_t n = 0;
 
-    /* Civil dawn/dusk */
-    if (!calc_event(n, lat, lon, tz, 96.0, true,  sr_civ)) return false;
-    if (!calc_event(n, lat, lon, tz, 96.0, false, ss_civ)) return false;
+    for (uint8_t i = 0; i < SOLAR_QUANTITIES; i++) {
+        if (!(need & solar_quantities[i].q))
+            continue;
 
-    /* Round to minute resolution */
-    out->sunrise_std = round_minutes(sr_std);
-    out->sunset_std  = round_minutes(ss_std);
-    out->sunrise_civ = round_minutes(sr_civ);
-    out->sunset_civ  = round_minutes(ss_civ);
+        ev[n].zenith_mdeg = solar_quantities[i].zenith_mdeg;
+        ev[n].sunrise     = solar_quantities[i].sunrise;
+        which[n++] = i;
+    }
 
-    /* Derived durations */
-    out->day_length =
-        duration(out->sunrise_std, out->sunset_std);
+    out->valid_mask &= (uint16_t)~need;
 
-    out->visible_length =
-        duration(out->sunrise_civ, out->sunset_civ);
+    if (n == 0)
+        return out->valid_mask;
 
-    return true;
+    (void)solar_events_compute(year, month, day, lat_e4, lon_e4, tz, ev, n);
+
+    for (uint8_t k = 0; k < n; k++) {
+        uint8_t i = which[k];
+        uint16_t *field =
+            (uint16_t *)((uint8_t *)out + solar_quantities[i].field);
+
+        *field = ev[k].valid ? ev[k].minute : 0;
+
+        if (ev[k].valid)
+            out->valid_mask |= solar_quantities[i].q;
+    }
+
+    /* Derived durations (0 unless both ends exist) */
+    if ((out->valid_mask & (SOLAR_Q_STD_RISE | SOLAR_Q_STD_SET)) ==
+        (SOLAR_Q_STD_RISE | SOLAR_Q_STD_SET))
+        out->day_length = solar_duration(out->sunrise_std, out->sunset_std);
+    else
+        out->day_length = 0;
+
+    if ((out->valid_mask & (SOLAR_Q_CIV_RISE | SOLAR_Q_CIV_SET)) ==
+        (SOLAR_Q_CIV_RISE | SOLAR_Q_CIV_SET))
+        out->visible_length = solar_duration(out->sunrise_civ, out->sunset_civ);
+    else
+        out->visible_length = 0;
+
+    return out->valid_mask;
 }
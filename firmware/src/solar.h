@@ -22,7 +22,12 @@
  *
  * That is intentional (for now).
  *
- * Updated: 2026-01-08
+ * Engine:
+ *  - Default build uses the NOAA floating point engine
+ *  - SOLAR_ENGINE=fixed (Makefile) selects the libm-free fixed-point
+ *    engine; results agree to within one minute for |lat| <= 65
+ *
+ * Updated: 2026-10-16
  */
 
 #pragma once
@@ -33,10 +38,34 @@
 extern "C" {
 #endif
 
+/*
+ * Solar quantities, as bits.
+ *
+ * Used both to request a subset (solar_compute_mask) and to report
+ * which fields of struct solar_times hold a valid minute.
+ */
+#define SOLAR_Q_STD_RISE    0x0001u
+#define SOLAR_Q_STD_SET     0x0002u
+#define SOLAR_Q_CIV_RISE    0x0004u
+#define SOLAR_Q_CIV_SET     0x0008u
+#define SOLAR_Q_NAUT_RISE   0x0010u
+#define SOLAR_Q_NAUT_SET    0x0020u
+#define SOLAR_Q_ASTRO_RISE  0x0040u
+#define SOLAR_Q_ASTRO_SET   0x0080u
+#define SOLAR_Q_NOON        0x0100u
+
+#define SOLAR_Q_STD_CIV     0x000Fu   /* the four solar_compute() events */
+#define SOLAR_Q_ALL         0x01FFu
+
 /*
  * Solar times for a single calendar day.
  *
  * All values are minute-of-day (0..1439).
+ *
+ * valid_mask (SOLAR_Q_*) says which minutes are meaningful.
+ * solar_compute() and the table/fit caches fill the standard + civil
+ * four; nautical / astronomical / noon are only filled on request
+ * (solar_compute_mask) and are 0 otherwise.
  */
 struct solar_times {
     uint16_t sunrise_std;     /* Official sunrise */
@@ -45,6 +74,39 @@ struct solar_times {
     uint16_t sunset_civ;      /* Civil dusk */
     uint16_t day_length;      /* sunrise_std → sunset_std */
     uint16_t visible_length;  /* sunrise_civ → sunset_civ */
+    uint16_t sunrise_naut;    /* Nautical dawn */
+    uint16_t sunset_naut;     /* Nautical dusk */
+    uint16_t sunrise_astro;   /* Astronomical dawn */
+    uint16_t sunset_astro;    /* Astronomical dusk */
+    uint16_t noon;            /* Solar noon (transit) */
+    uint16_t valid_mask;      /* SOLAR_Q_* */
+};
+
+/*
+ * Zenith angles, millidegrees.
+ */
+#define SOLAR_ZENITH_OFFICIAL_MDEG  90833UL   /* sunrise / sunset */
+#define SOLAR_ZENITH_CIVIL_MDEG     96000UL   /* civil dawn / dusk */
+#define SOLAR_ZENITH_NAUTICAL_MDEG 102000UL   /* nautical dawn / dusk */
+#define SOLAR_ZENITH_ASTRO_MDEG    108000UL   /* astronomical dawn / dusk */
+
+/*
+ * Not a zenith crossing: the sun's transit (hour angle 0).
+ * Always valid. The sunrise flag only picks the anchor ephemeris.
+ */
+#define SOLAR_ZENITH_TRANSIT            0UL
+
+/*
+ * One requested solar event.
+ *
+ * Caller fills zenith_mdeg + sunrise.
+ * Kernel fills valid + minute.
+ */
+struct solar_event {
+    uint32_t zenith_mdeg;     /* In: zenith angle, millidegrees */
+    bool     sunrise;         /* In: true = rising, false = setting */
+    bool     valid;           /* Out: false if the sun never crosses */
+    uint16_t minute;          /* Out: minute-of-day (0..1439) */
 };
 
 /*
@@ -69,6 +131,96 @@ bool solar_compute(
     struct solar_times *out
 );
 
+/*
+ * Same as solar_compute(), but latitude / longitude are given in
+ * degrees * 1e4, the units stored in struct config.
+ *
+ * Preferred on the device: with the fixed-point engine selected the
+ * whole computation stays in integer arithmetic.
+ */
+bool solar_compute_e4(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    int32_t  lat_e4,
+    int32_t  lon_e4,
+    int8_t   tz,
+    struct solar_times *out
+);
+
+/*
+ * Solar event kernel.
+ *
+ * Computes the day-constant ephemeris terms once, then evaluates every
+ * requested zenith crossing from them. Extra twilight angles cost one
+ * hour-angle evaluation each.
+ *
+ * Events sharing a zenith angle should be adjacent (cos(zenith) is
+ * reused between neighbours).
+ *
+ * Latitude / longitude in degrees * 1e4.
+ *
+ * Returns the number of valid events.
+ */
+uint8_t solar_events_compute(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    int32_t  lat_e4,
+    int32_t  lon_e4,
+    int8_t   tz,
+    struct solar_event *ev,
+    uint8_t  count
+);
+
+/*
+ * Requested subset of solar quantities.
+ *
+ * need is a SOLAR_Q_* mask. Only those events are evaluated; an
+ * unused twilight angle or noon costs nothing. Fields outside need
+ * are left untouched, so a caller can add quantities to a struct it
+ * already holds.
+ *
+ * Unlike solar_compute(), a missing event does not fail the day:
+ * it is simply absent from out->valid_mask.
+ *
+ * Returns out->valid_mask.
+ */
+uint16_t solar_compute_mask(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    int32_t  lat_e4,
+    int32_t  lon_e4,
+    int8_t   tz,
+    uint16_t need,
+    struct solar_times *out
+);
+
+/*
+ * Consecutive days starting at (year, month, day).
+ *
+ * Location-dependent terms are computed once and the day-of-year is
+ * stepped incrementally (across year ends). Per-day results are
+ * identical to solar_compute_e4().
+ *
+ * out[] and valid[] must hold ndays entries; valid[i] is false when the
+ * sun does not rise/set on day i.
+ *
+ * Returns the number of valid days.
+ */
+uint8_t solar_compute_range(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    uint8_t  ndays,
+    int32_t  lat_e4,
+    int32_t  lon_e4,
+    int8_t   tz,
+    struct solar_times *out,
+    bool *valid
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,313 @@
+/*
+ * solar_baked.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Compile-time solar table for fixed installations
+ *
+ * Notes:
+ *  - Everything below baked_build() runs in the compiler, not on the
+ *    device: the table is a constexpr value placed in PROGMEM
+ *  - Trig is evaluated with short constexpr series (no libm in
+ *    constant expressions). Loop counts are fixed, so evaluation is the
+ *    same whether double is 64-bit (host) or 32-bit (AVR)
+ *  - NOAA equations are transcribed from solar.cpp step for step
+ *  - Day-of-year only (one leap year covers every calendar day),
+ *    UTC minutes, 0xFFF = event does not occur
+ *
+ * Updated: 2026-10-16
+ */
+
+#include "solar_baked.h"
+
+#if defined(SOLAR_BAKED)
+
+#include "solar_engine.h"
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#else
+#define PROGMEM
+#define pgm_read_byte(p) (*(p))
+#endif
+
+#define BK_DAYS      366
+#define BK_DAY_BYTES 6
+#define BK_NONE      0x0FFFu
+
+/* --------------------------------------------------------------------------
+ * constexpr math
+ * -------------------------------------------------------------------------- */
+
+static constexpr double CX_PI      = 3.14159265358979323846;
+static constexpr double CX_TWO_PI  = 2.0 * CX_PI;
+static constexpr double CX_DEG2RAD = CX_PI / 180.0;
+static constexpr double CX_RAD2DEG = 180.0 / CX_PI;
+
+static constexpr double cx_floor(double x)
+{
+    double i = (double)(long long)x;
+    return (i > x) ? i - 1.0 : i;
+}
+
+static constexpr double cx_sqrt(double x)
+{
+    if (x <= 0.0)
+        return 0.0;
+
+    double g = (x > 1.0) ? x : 1.0;
+
+    for (int i = 0; i < 40; i++)
+        g = 0.5 * (g + x / g);
+
+    return g;
+}
+
+static constexpr double cx_sin(double x)
+{
+    /* Reduce to [-pi, pi], then fold to [-pi/2, pi/2] */
+    x -= CX_TWO_PI * cx_floor(x / CX_TWO_PI + 0.5);
+
+    if (x >  CX_PI / 2.0) x =  CX_PI - x;
+    if (x < -CX_PI / 2.0) x = -CX_PI - x;
+
+    double x2 = x * x;
+    double term = x;
+    double sum = x;
+
+    for (int n = 1; n <= 9; n++) {
+        term *= -x2 / (double)((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+
+    return sum;
+}
+
+static constexpr double cx_cos(double x)
+{
+    return cx_sin(x + CX_PI / 2.0);
+}
+
+static constexpr double cx_atan(double x)
+{
+    bool neg = x < 0.0;
+    if (neg) x = -x;
+
+    bool inv = x > 1.0;
+    if (inv) x = 1.0 / x;
+
+    /* Two half-angle steps: |x| <= tan(pi/16) */
+    x = x / (1.0 + cx_sqrt(1.0 + x * x));
+    x = x / (1.0 + cx_sqrt(1.0 + x * x));
+
+    double x2 = x * x;
+    double term = x;
+    double sum = x;
+
+    for (int n = 1; n <= 12; n++) {
+        term *= -x2;
+        sum += term / (double)(2 * n + 1);
+    }
+
+    sum *= 4.0;
+
+    if (inv) sum = CX_PI / 2.0 - sum;
+
+    return neg ? -sum : sum;
+}
+
+static constexpr double cx_acos(double x)
+{
+    if (x >=  1.0) return 0.0;
+    if (x <= -1.0) return CX_PI;
+
+    return CX_PI / 2.0 - cx_atan(x / cx_sqrt(1.0 - x * x));
+}
+
+/* --------------------------------------------------------------------------
+ * NOAA, as in solar.cpp
+ * -------------------------------------------------------------------------- */
+
+struct cx_ephem {
+    double ut_base;
+    double sinDec;
+    double cosDec;
+};
+
+static constexpr cx_ephem cx_ephemeris(int day_of_year, double lngHour, bool sunrise)
+{
+    double t = sunrise
+        ? day_of_year + ((6.0  - lngHour) / 24.0)
+        : day_of_year + ((18.0 - lngHour) / 24.0);
+
+    double M = (0.9856 * t) - 3.289;
+
+    double L = M
+        + (1.916 * cx_sin(M * CX_DEG2RAD))
+        + (0.020 * cx_sin(2 * M * CX_DEG2RAD))
+        + 282.634;
+
+    while (L < 0.0)    L += 360.0;
+    while (L >= 360.0) L -= 360.0;
+
+    double RA = CX_RAD2DEG *
+        cx_atan(0.91764 * cx_sin(L * CX_DEG2RAD) / cx_cos(L * CX_DEG2RAD));
+
+    while (RA < 0.0)    RA += 360.0;
+    while (RA >= 360.0) RA -= 360.0;
+
+    double Lq  = cx_floor(L  / 90.0) * 90.0;
+    double RAq = cx_floor(RA / 90.0) * 90.0;
+    RA = (RA + (Lq - RAq)) / 15.0;
+
+    cx_ephem e = {};
+
+    e.sinDec = 0.39782 * cx_sin(L * CX_DEG2RAD);
+    e.cosDec = cx_sqrt(1.0 - e.sinDec * e.sinDec);   /* cos(asin(x)) */
+    e.ut_base = RA - (0.06571 * t) - 6.622 - lngHour;
+
+    return e;
+}
+
+static constexpr uint16_t cx_event(const cx_ephem &e,
+                                   double sinLat, double cosLat,
+                                   double cosZ, bool sunrise)
+{
+    double cosH = (cosZ - e.sinDec * sinLat) / (e.cosDec * cosLat);
+
+    if (cosH > 1.0 || cosH < -1.0)
+        return BK_NONE;
+
+    double H = sunrise
+        ? 360.0 - CX_RAD2DEG * cx_acos(cosH)
+        : CX_RAD2DEG * cx_acos(cosH);
+
+    double UT = H / 15.0 + e.ut_base;
+
+    while (UT < 0.0)   UT += 24.0;
+    while (UT >= 24.0) UT -= 24.0;
+
+    uint16_t m = (uint16_t)(UT * 60.0 + 0.5);
+    if (m >= 1440)
+        m -= 1440;
+
+    return m;
+}
+
+/* --------------------------------------------------------------------------
+ * Table (4 x 12-bit per day, solar_table packing)
+ * -------------------------------------------------------------------------- */
+
+struct baked_table {
+    uint8_t b[BK_DAYS][BK_DAY_BYTES];
+};
+
+static constexpr baked_table baked_build(void)
+{
+    baked_table t = {};
+
+    const double lat     = (double)SOLAR_BAKED_LAT_E4 / 10000.0;
+    const double lon     = (double)SOLAR_BAKED_LON_E4 / 10000.0;
+    const double lngHour = lon / 15.0;
+    const double sinLat  = cx_sin(lat * CX_DEG2RAD);
+    const double cosLat  = cx_cos(lat * CX_DEG2RAD);
+
+    const double cosZ_std = cx_cos((double)SOLAR_ZENITH_OFFICIAL_MDEG * (CX_DEG2RAD / 1000.0));
+    const double cosZ_civ = cx_cos((double)SOLAR_ZENITH_CIVIL_MDEG    * (CX_DEG2RAD / 1000.0));
+
+    for (int i = 0; i < BK_DAYS; i++) {
+
+        cx_ephem rise = cx_ephemeris(i + 1, lngHour, true);
+        cx_ephem set  = cx_ephemeris(i + 1, lngHour, false);
+
+        uint16_t v[4] = {
+            cx_event(rise, sinLat, cosLat, cosZ_std, true),
+            cx_event(set,  sinLat, cosLat, cosZ_std, false),
+            cx_event(rise, sinLat, cosLat, cosZ_civ, true),
+            cx_event(set,  sinLat, cosLat, cosZ_civ, false),
+        };
+
+        t.b[i][0] = (uint8_t)(v[0]);
+        t.b[i][1] = (uint8_t)((v[0] >> 8) | (v[1] << 4));
+        t.b[i][2] = (uint8_t)(v[1] >> 4);
+        t.b[i][3] = (uint8_t)(v[2]);
+        t.b[i][4] = (uint8_t)((v[2] >> 8) | (v[3] << 4));
+        t.b[i][5] = (uint8_t)(v[3] >> 4);
+    }
+
+    return t;
+}
+
+static constexpr baked_table s_baked PROGMEM = baked_build();
+
+/* --------------------------------------------------------------------------
+ * Public API
+ * -------------------------------------------------------------------------- */
+
+bool solar_baked_valid_for(int32_t lat_e4, int32_t lon_e4)
+{
+    return lat_e4 == (int32_t)SOLAR_BAKED_LAT_E4 &&
+           lon_e4 == (int32_t)SOLAR_BAKED_LON_E4;
+}
+
+bool solar_baked_lookup(uint16_t year,
+                        uint8_t  month,
+                        uint8_t  day,
+                        int32_t  lat_e4,
+                        int32_t  lon_e4,
+                        int8_t   tz,
+                        struct solar_times *out,
+                        bool *have_sol)
+{
+    if (!out || !have_sol)
+        return false;
+
+    if (!solar_baked_valid_for(lat_e4, lon_e4))
+        return false;
+
+    int n = solar_day_of_year(year, month, day);
+    if (n < 1 || n > BK_DAYS)
+        return false;
+
+    uint8_t b[BK_DAY_BYTES];
+    for (uint8_t i = 0; i < BK_DAY_BYTES; i++)
+        b[i] = pgm_read_byte(&s_baked.b[n - 1][i]);
+
+    uint16_t v[4];
+    v[0] = (uint16_t)(b[0] | ((b[1] & 0x0F) << 8));
+    v[1] = (uint16_t)((b[1] >> 4) | (b[2] << 4));
+    v[2] = (uint16_t)(b[3] | ((b[4] & 0x0F) << 8));
+    v[3] = (uint16_t)((b[4] >> 4) | (b[5] << 4));
+
+    /* Same contract as solar_compute(): all four events or nothing */
+    *have_sol = false;
+
+    for (uint8_t e = 0; e < 4; e++) {
+        if (v[e] >= 1440)
+            return true;
+
+        int16_t m = (int16_t)v[e] + (int16_t)tz * 60;
+        while (m < 0)     m += 1440;
+        while (m >= 1440) m -= 1440;
+        v[e] = (uint16_t)m;
+    }
+
+    solar_times_set_std(out, v[0], v[1], v[2], v[3]);
+
+    *have_sol = true;
+    return true;
+}
+
+#else /* !SOLAR_BAKED */
+
+bool solar_baked_valid_for(int32_t, int32_t)
+{
+    return false;
+}
+
+bool solar_baked_lookup(uint16_t, uint8_t, uint8_t, int32_t, int32_t,
+                        int8_t, struct solar_times *, bool *)
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * solar_baked.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Compile-time solar table for fixed installations
+ *
+ * Notes:
+ *  - Enabled by building with a site location (Makefile):
+ *        make SOLAR_SITE_LAT_E4=425000 SOLAR_SITE_LON_E4=-830000
+ *    which defines SOLAR_BAKED_LAT_E4 / SOLAR_BAKED_LON_E4
+ *  - The compiler evaluates the NOAA equations (constexpr series trig)
+ *    for every day-of-year and places the result in flash (PROGMEM);
+ *    no solar math runs at boot or at midnight for that site
+ *  - Used only while the configured location equals the baked one.
+ *    After a console location change the normal path (EEPROM table /
+ *    fit, else runtime math) takes over, so that math stays linked.
+ *  - Same 12-bit packing as solar_table (6 bytes/day, ~2.2 KB flash)
+ *  - Without a site location this module is empty and every lookup
+ *    misses
+ *
+ * Accuracy:
+ *  - Same equations as the runtime NOAA engine, series trig instead of
+ *    libm; results agree to within one minute (tests/solar_host)
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "solar.h"
+
+#if defined(SOLAR_BAKED_LAT_E4) && defined(SOLAR_BAKED_LON_E4)
+#define SOLAR_BAKED 1
+#endif
+
+/* True if a baked table exists and was built for (lat_e4, lon_e4) */
+bool solar_baked_valid_for(int32_t lat_e4, int32_t lon_e4);
+
+/*
+ * Flash table lookup, same contract as solar_table_lookup():
+ *  - true  → baked table answered; *out filled if the sun rises/sets,
+ *            *have_sol says which
+ *  - false → no baked table, or a different location
+ *
+ * tz shifts the UTC table minutes (same meaning as solar_compute()).
+ */
+bool solar_baked_lookup(uint16_t year,
+                        uint8_t  month,
+                        uint8_t  day,
+                        int32_t  lat_e4,
+                        int32_t  lon_e4,
+                        int8_t   tz,
+                        struct solar_times *out,
+                        bool *have_sol);
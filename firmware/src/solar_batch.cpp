@@ -0,0 +1,306 @@
+/*
+ * solar_batch.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Host-only bulk solar evaluation (many sites x many days)
+ *
+ * Notes:
+ *  - HOST ONLY (pthreads, malloc); never linked into firmware
+ *  - Built from the same NOAA building blocks as the scalar kernel
+ *    (solar_noaa_ephemeris / solar_noaa_event_minute), so every
+ *    floating point operation happens in the same order: identical bits
+ *  - Transcendentals stay scalar libm calls; vector libm variants are
+ *    not bit-identical, which is the one property this must keep
+ *  - Work unit is one longitude group; workers pull groups from a
+ *    shared counter, so uneven groups still balance
+ *
+ * Updated: 2026-10-16
+ */
+
+#if defined(__AVR__)
+#error "solar_batch.cpp is host-only"
+#endif
+
+#include "solar_batch.h"
+#include "solar_engine.h"
+#include "time_dst.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define BATCH_MAX_THREADS 64
+
+/* Fixed engine: days per solar_fixed_range() call */
+#define BATCH_FIXED_CHUNK 64
+
+/* --------------------------------------------------------------------------
+ * Shared job state
+ * -------------------------------------------------------------------------- */
+
+struct batch_site {
+    int32_t lon_e4;
+    size_t  index;              /* position in the caller's arrays */
+};
+
+struct batch_job {
+    const struct solar_batch *b;
+
+    /* Sites ordered by longitude, and group boundaries into that order */
+    struct batch_site *order;
+    size_t            *group_start; /* ngroups + 1 entries */
+    size_t             ngroups;
+
+    /* Per-site constants, indexed like the caller's arrays */
+    double *lngHour;
+    double *sinLat;
+    double *cosLat;
+
+    double cosZ_std;
+    double cosZ_civ;
+
+    int    doy0;
+
+    size_t next_group;          /* atomic work counter */
+    size_t n_valid;             /* atomic */
+};
+
+static int site_cmp(const void *a, const void *b)
+{
+    const struct batch_site *x = (const struct batch_site *)a;
+    const struct batch_site *y = (const struct batch_site *)b;
+
+    if (x->lon_e4 != y->lon_e4)
+        return x->lon_e4 < y->lon_e4 ? -1 : 1;
+
+    return x->index < y->index ? -1 : (x->index > y->index);
+}
+
+/* --------------------------------------------------------------------------
+ * One longitude group, all days
+ * -------------------------------------------------------------------------- */
+
+#if !defined(SOLAR_ENGINE_FIXED)
+
+static size_t run_group(struct batch_job *job, size_t g)
+{
+    const struct solar_batch *b = job->b;
+
+    const size_t first = job->group_start[g];
+    const size_t last  = job->group_start[g + 1];
+
+    /* Every site in the group shares lngHour */
+    const double lngHour = job->lngHour[job->order[first].index];
+
+    uint16_t year = b->year;
+    int      doy  = job->doy0;
+    size_t   n_ok = 0;
+
+    for (uint32_t d = 0; d < b->ndays; d++) {
+
+        struct solar_noaa_ephem rise, set;
+        solar_noaa_ephemeris(doy, lngHour, true,  &rise);
+        solar_noaa_ephemeris(doy, lngHour, false, &set);
+
+        for (size_t k = first; k < last; k++) {
+
+            const size_t s   = job->order[k].index;
+            const size_t out = s * b->ndays + d;
+
+            const double sinLat = job->sinLat[s];
+            const double cosLat = job->cosLat[s];
+
+            /* Same order as solar_std_events_init() */
+            bool ok = solar_noaa_event_minute(&rise, sinLat, cosLat,
+                                              job->cosZ_std, b->tz, true,
+                                              &b->sunrise_std[out]);
+            ok &= solar_noaa_event_minute(&set, sinLat, cosLat,
+                                          job->cosZ_std, b->tz, false,
+                                          &b->sunset_std[out]);
+            ok &= solar_noaa_event_minute(&rise, sinLat, cosLat,
+                                          job->cosZ_civ, b->tz, true,
+                                          &b->sunrise_civ[out]);
+            ok &= solar_noaa_event_minute(&set, sinLat, cosLat,
+                                          job->cosZ_civ, b->tz, false,
+                                          &b->sunset_civ[out]);
+
+            b->valid[out] = ok;
+            n_ok += ok;
+        }
+
+        solar_next_day(&year, &doy);
+    }
+
+    return n_ok;
+}
+
+#else
+
+/* Fixed engine: integer math, so the per-site range walk is already exact */
+static size_t run_group(struct batch_job *job, size_t g)
+{
+    const struct solar_batch *b = job->b;
+    size_t n_ok = 0;
+
+    for (size_t k = job->group_start[g]; k < job->group_start[g + 1]; k++) {
+
+        const size_t s = job->order[k].index;
+
+        uint16_t year  = b->year;
+        uint8_t  month = b->month;
+        uint8_t  day   = b->day;
+
+        for (uint32_t d = 0; d < b->ndays; d += BATCH_FIXED_CHUNK) {
+
+            uint32_t n = b->ndays - d;
+            if (n > BATCH_FIXED_CHUNK)
+                n = BATCH_FIXED_CHUNK;
+
+            struct solar_times t[BATCH_FIXED_CHUNK];
+            bool ok[BATCH_FIXED_CHUNK];
+
+            n_ok += solar_fixed_range(year, month, day, (uint8_t)n,
+                                      b->lat_e4[s], b->lon_e4[s], b->tz,
+                                      t, ok);
+
+            for (uint32_t i = 0; i < n; i++) {
+                const size_t out = s * b->ndays + d + i;
+
+                b->valid[out] = ok[i];
+                if (!ok[i])
+                    continue;
+
+                b->sunrise_std[out] = t[i].sunrise_std;
+                b->sunset_std[out]  = t[i].sunset_std;
+                b->sunrise_civ[out] = t[i].sunrise_civ;
+                b->sunset_civ[out]  = t[i].sunset_civ;
+            }
+
+            /* Next chunk start date */
+            for (uint32_t i = 0; i < n; i++) {
+                if (++day > days_in_month(year, month)) {
+                    day = 1;
+                    if (++month > 12) {
+                        month = 1;
+                        year++;
+                    }
+                }
+            }
+        }
+    }
+
+    return n_ok;
+}
+
+#endif
+
+/* --------------------------------------------------------------------------
+ * Worker
+ * -------------------------------------------------------------------------- */
+
+static void *worker(void *arg)
+{
+    struct batch_job *job = (struct batch_job *)arg;
+    size_t n_ok = 0;
+
+    for (;;) {
+        size_t g = __atomic_fetch_add(&job->next_group, 1, __ATOMIC_RELAXED);
+        if (g >= job->ngroups)
+            break;
+
+        n_ok += run_group(job, g);
+    }
+
+    __atomic_fetch_add(&job->n_valid, n_ok, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------
+ * Public API
+ * -------------------------------------------------------------------------- */
+
+size_t solar_batch_compute(const struct solar_batch *b, unsigned threads)
+{
+    if (!b || !b->lat_e4 || !b->lon_e4 ||
+        !b->sunrise_std || !b->sunset_std ||
+        !b->sunrise_civ || !b->sunset_civ || !b->valid)
+        return 0;
+
+    if (b->nsites == 0 || b->ndays == 0)
+        return 0;
+
+    struct batch_job job = {};
+    job.b = b;
+
+    job.order       = (struct batch_site *)malloc(b->nsites * sizeof(*job.order));
+    job.group_start = (size_t *)malloc((b->nsites + 1) * sizeof(size_t));
+    job.lngHour     = (double *)malloc(b->nsites * sizeof(double));
+    job.sinLat      = (double *)malloc(b->nsites * sizeof(double));
+    job.cosLat      = (double *)malloc(b->nsites * sizeof(double));
+
+    size_t n_valid = 0;
+
+    if (!job.order || !job.group_start ||
+        !job.lngHour || !job.sinLat || !job.cosLat)
+        goto done;
+
+    /* Per-site constants, exactly as the scalar kernel derives them */
+    for (size_t s = 0; s < b->nsites; s++) {
+        solar_noaa_site((double)b->lat_e4[s] / 10000.0,
+                        (double)b->lon_e4[s] / 10000.0,
+                        &job.lngHour[s], &job.sinLat[s], &job.cosLat[s]);
+
+        job.order[s].lon_e4 = b->lon_e4[s];
+        job.order[s].index  = s;
+    }
+
+    job.cosZ_std = solar_noaa_cosZ(SOLAR_ZENITH_OFFICIAL_MDEG);
+    job.cosZ_civ = solar_noaa_cosZ(SOLAR_ZENITH_CIVIL_MDEG);
+    job.doy0     = solar_day_of_year(b->year, b->month, b->day);
+
+    /* Group by longitude */
+    qsort(job.order, b->nsites, sizeof(*job.order), site_cmp);
+
+    for (size_t s = 0; s < b->nsites; s++) {
+        if (s == 0 || job.order[s].lon_e4 != job.order[s - 1].lon_e4)
+            job.group_start[job.ngroups++] = s;
+    }
+    job.group_start[job.ngroups] = b->nsites;
+
+    /* Workers */
+    if (threads == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (n > 0) ? (unsigned)n : 1;
+    }
+    if (threads > BATCH_MAX_THREADS)
+        threads = BATCH_MAX_THREADS;
+    if (threads > job.ngroups)
+        threads = (unsigned)job.ngroups;
+
+    {
+        pthread_t tid[BATCH_MAX_THREADS];
+        unsigned started = 0;
+
+        for (unsigned t = 1; t < threads; t++) {
+            if (pthread_create(&tid[started], NULL, worker, &job) == 0)
+                started++;
+        }
+
+        /* Calling thread works too (and alone when threads == 1) */
+        worker(&job);
+
+        for (unsigned t = 0; t < started; t++)
+            pthread_join(tid[t], NULL);
+    }
+
+    n_valid = job.n_valid;
+
+done:
+    free(job.order);
+    free(job.group_start);
+    free(job.lngHour);
+    free(job.sinLat);
+    free(job.cosLat);
+
+    return n_valid;
+}
@@ -0,0 +1,75 @@
+/*
+ * solar_batch.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Host-only bulk solar evaluation (many sites x many days)
+ *
+ * Notes:
+ *  - HOST ONLY. Not part of the firmware build (see firmware/Makefile);
+ *    used by planning tools and by tests that validate table/fit modes
+ *  - Structure-of-arrays in and out: one array per input coordinate
+ *    and one array per result field
+ *  - Results are bit-identical to calling solar_compute_e4() for every
+ *    (site, day) pair with the engine selected at build time
+ *
+ * Why it is faster than the scalar loop:
+ *  - The NOAA ephemeris depends only on (day, longitude). Sites are
+ *    grouped by longitude and each group shares one ephemeris per day,
+ *    so a latitude sweep pays one hour-angle evaluation per site
+ *  - Per-site constants (sin/cos latitude) and cos(zenith) are hoisted
+ *    out of the day loop; day-of-year is stepped, not recomputed
+ *  - Longitude groups are spread over worker threads
+ *  - With SOLAR_ENGINE_FIXED the per-site range walk is used instead
+ *    (integer math, nothing to share between sites)
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "solar.h"
+
+/*
+ * One batch request.
+ *
+ * Result arrays hold nsites * ndays entries, site-major:
+ *     index = site * ndays + day_offset
+ */
+struct solar_batch {
+    /* Sites */
+    size_t         nsites;
+    const int32_t *lat_e4;          /* degrees * 1e4 */
+    const int32_t *lon_e4;          /* degrees * 1e4 */
+
+    /* Days: ndays consecutive days from (year, month, day) */
+    uint16_t       year;
+    uint8_t        month;
+    uint8_t        day;
+    uint32_t       ndays;
+
+    int8_t         tz;              /* same meaning as solar_compute() */
+
+    /* Results */
+    uint16_t      *sunrise_std;
+    uint16_t      *sunset_std;
+    uint16_t      *sunrise_civ;
+    uint16_t      *sunset_civ;
+    bool          *valid;           /* == solar_compute_e4() return */
+};
+
+/*
+ * Evaluate a batch.
+ *
+ * threads:
+ *  - 0 → one worker per online CPU
+ *  - 1 → calling thread only
+ *
+ * Minutes are only meaningful where valid is true (same contract as
+ * solar_compute_e4(), which leaves *out untouched on failure).
+ *
+ * Returns the number of valid (site, day) pairs.
+ */
+size_t solar_batch_compute(const struct solar_batch *b, unsigned threads);
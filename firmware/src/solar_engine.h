@@ -0,0 +1,132 @@
+/*
+ * solar_engine.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Internal solar engine interface
+ *
+ * Notes:
+ *  - NOT part of the public solar API (use solar.h)
+ *  - Two interchangeable engines exist:
+ *      solar_noaa_*   floating point NOAA almanac (solar.cpp)
+ *      solar_fixed_*  integer / CORDIC port of the same math (solar_fixed.cpp)
+ *  - solar_compute() dispatches to exactly one of them at build time:
+ *      default               → NOAA float engine
+ *      -DSOLAR_ENGINE_FIXED  → fixed-point engine (no libm)
+ *  - Each engine exposes an event kernel (*_events) that shares the
+ *    day-constant ephemeris across any number of zenith crossings.
+ *  - Both engines are always compiled; --gc-sections drops the unused one.
+ *    Host tests link both to compare them.
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "solar.h"
+
+/* Shared helpers (solar.cpp) */
+int      solar_day_of_year(int y, int m, int d);
+uint16_t solar_duration(uint16_t start, uint16_t end);
+void     solar_next_day(uint16_t *year, int *doy);
+
+/*
+ * The four events behind struct solar_times, in kernel order:
+ *  [0] std rise  [1] std set  [2] civ rise  [3] civ set
+ */
+#define SOLAR_STD_EVENTS 4
+
+void solar_std_events_init(struct solar_event ev[SOLAR_STD_EVENTS]);
+
+/* Fill the standard + civil four (valid_mask = SOLAR_Q_STD_CIV) */
+void solar_times_set_std(struct solar_times *out,
+                         uint16_t rise_std, uint16_t set_std,
+                         uint16_t rise_civ, uint16_t set_civ);
+
+bool solar_times_from_events(const struct solar_event ev[SOLAR_STD_EVENTS],
+                             struct solar_times *out);
+
+/* NOAA floating point engine (solar.cpp) */
+
+/*
+ * NOAA building blocks, exposed for the host batch path
+ * (solar_batch.cpp). Everything else goes through the kernels below.
+ */
+struct solar_noaa_ephem {
+    double ut_base;   /* RA - 0.06571 t - 6.622 - lngHour (hours) */
+    double sinDec;
+    double cosDec;
+};
+
+void   solar_noaa_site(double lat, double lon,
+                       double *lngHour, double *sinLat, double *cosLat);
+double solar_noaa_cosZ(uint32_t zenith_mdeg);
+
+void   solar_noaa_ephemeris(int day_of_year,
+                            double lngHour,
+                            bool sunrise,
+                            struct solar_noaa_ephem *e);
+
+bool   solar_noaa_event_minute(const struct solar_noaa_ephem *e,
+                               double   sinLat,
+                               double   cosLat,
+                               double   cosZ,
+                               int8_t   tz,
+                               bool     sunrise,
+                               uint16_t *minute);
+
+uint8_t solar_noaa_events(uint16_t year,
+                          uint8_t  month,
+                          uint8_t  day,
+                          double   lat,
+                          double   lon,
+                          int8_t   tz,
+                          struct solar_event *ev,
+                          uint8_t  count);
+
+uint8_t solar_noaa_range(uint16_t year,
+                         uint8_t  month,
+                         uint8_t  day,
+                         uint8_t  ndays,
+                         double   lat,
+                         double   lon,
+                         int8_t   tz,
+                         struct solar_times *out,
+                         bool *valid);
+
+bool solar_noaa_compute(uint16_t year,
+                        uint8_t  month,
+                        uint8_t  day,
+                        double   lat,
+                        double   lon,
+                        int8_t   tz,
+                        struct solar_times *out);
+
+/* Fixed-point engine (solar_fixed.cpp) */
+uint8_t solar_fixed_events(uint16_t year,
+                           uint8_t  month,
+                           uint8_t  day,
+                           int32_t  lat_e4,
+                           int32_t  lon_e4,
+                           int8_t   tz,
+                           struct solar_event *ev,
+                           uint8_t  count);
+
+uint8_t solar_fixed_range(uint16_t year,
+                          uint8_t  month,
+                          uint8_t  day,
+                          uint8_t  ndays,
+                          int32_t  lat_e4,
+                          int32_t  lon_e4,
+                          int8_t   tz,
+                          struct solar_times *out,
+                          bool *valid);
+
+bool solar_fixed_compute(uint16_t year,
+                         uint8_t  month,
+                         uint8_t  day,
+                         int32_t  lat_e4,
+                         int32_t  lon_e4,
+                         int8_t   tz,
+                         struct solar_times *out);
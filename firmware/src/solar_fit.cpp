@@ -0,0 +1,357 @@
+/*
+ * solar_fit.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Per-location harmonic (Fourier) model of solar event times
+ *
+ * Notes:
+ *  - Portable: storage comes from solar_fit_store_* hooks
+ *  - Fit: one streaming DFT pass over 366 days (int64 accumulators),
+ *    then a second pass measuring the worst in-sample error
+ *  - Eval: integer only, no float
+ *  - Event times are unwrapped across midnight before fitting
+ *    (UTC sunset often crosses 00:00 during the year)
+ *
+ * Updated: 2026-10-16
+ */
+
+#include "solar_fit.h"
+#include "solar_engine.h"
+#include "time_dst.h"
+#include "config.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#else
+#define PROGMEM
+#define pgm_read_word(p) (*(p))
+#endif
+
+/* Any leap year: covers day-of-year 1..366 */
+#define SF_BUILD_YEAR   2028
+#define SF_DAYS         366
+
+/* Minute scale of stored coefficients */
+#define SF_SCALE        16
+
+/* A model worse than this is not stored as usable */
+#define SF_MAX_ERR_MIN  3
+
+/* --------------------------------------------------------------------------
+ * Quarter-wave sine, Q15, 64 segments + endpoint
+ * -------------------------------------------------------------------------- */
+static const int16_t sf_sin_lut[65] PROGMEM = {
+        0,   804,  1608,  2410,  3212,  4011,  4808,  5602,
+     6393,  7179,  7962,  8739,  9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767
+};
+
+/* sin of a 16-bit binary angle (65536 == full turn), Q15 */
+static int16_t sf_sin(uint16_t a)
+{
+    uint16_t p = a & 0x3FFF;
+
+    if (a & 0x4000)
+        p = 0x4000 - p;
+
+    uint8_t i = (uint8_t)(p >> 8);
+    int16_t s = (int16_t)pgm_read_word(&sf_sin_lut[i]);
+
+    if (i < 64) {
+        int16_t n = (int16_t)pgm_read_word(&sf_sin_lut[i + 1]);
+        s += (int16_t)(((int32_t)(n - s) * (p & 0xFF)) >> 8);
+    }
+
+    return (a & 0x8000) ? (int16_t)-s : s;
+}
+
+static inline int16_t sf_cos(uint16_t a)
+{
+    return sf_sin((uint16_t)(a + 0x4000));
+}
+
+/* Day-of-year → basis angle */
+static inline uint16_t sf_angle(int day_of_year)
+{
+    return (uint16_t)(((uint32_t)(day_of_year - 1) << 16) / SF_DAYS);
+}
+
+/* --------------------------------------------------------------------------
+ * Cached model
+ * -------------------------------------------------------------------------- */
+
+enum {
+    SF_UNKNOWN = 0,
+    SF_VALID,
+    SF_INVALID
+};
+
+static uint8_t s_state = SF_UNKNOWN;
+static struct solar_fit_model s_model;
+
+static void load_stored(void)
+{
+    solar_fit_store_read(&s_model);
+
+    s_state = SF_INVALID;
+
+    if (s_model.magic != SOLAR_FIT_MAGIC ||
+        s_model.version != SOLAR_FIT_VERSION)
+        return;
+
+    if (s_model.checksum !=
+        config_fletcher16(&s_model, offsetof(struct solar_fit_model, checksum)))
+        return;
+
+    s_state = SF_VALID;
+}
+
+/* --------------------------------------------------------------------------
+ * Fit helpers
+ * -------------------------------------------------------------------------- */
+
+/* Four UTC event minutes for one day; false if any missing */
+static bool sample_day(uint8_t mo, uint8_t d,
+                       int32_t lat_e4, int32_t lon_e4,
+                       uint16_t v[SOLAR_FIT_EVENTS])
+{
+    struct solar_event ev[SOLAR_STD_EVENTS];
+    solar_std_events_init(ev);
+
+    if (solar_events_compute(SF_BUILD_YEAR, mo, d, lat_e4, lon_e4, 0,
+                             ev, SOLAR_STD_EVENTS) != SOLAR_STD_EVENTS)
+        return false;
+
+    for (uint8_t e = 0; e < SOLAR_FIT_EVENTS; e++)
+        v[e] = ev[e].minute;
+
+    return true;
+}
+
+/* Continue an unwrapped series: nearest 1440-multiple to prev */
+static int16_t unwrap(int16_t prev, uint16_t v)
+{
+    int16_t u = (int16_t)v;
+
+    while (u - prev >  720) u -= 1440;
+    while (u - prev < -720) u += 1440;
+
+    return u;
+}
+
+static void next_date(uint8_t *mo, uint8_t *d)
+{
+    if (++(*d) > days_in_month(SF_BUILD_YEAR, *mo)) {
+        *d = 1;
+        (*mo)++;
+    }
+}
+
+/* Circular minute distance */
+static uint16_t minute_dist(uint16_t a, uint16_t b)
+{
+    int16_t d = (int16_t)a - (int16_t)b;
+
+    if (d < 0) d = -d;
+    if (d > 720) d = 1440 - d;
+
+    return (uint16_t)d;
+}
+
+/* Evaluate one event (1/16 minute, unnormalized) */
+static int32_t eval_event(const int16_t c[SOLAR_FIT_COEFFS], uint16_t w)
+{
+    int32_t acc = c[0];
+
+    for (uint8_t k = 1; k <= SOLAR_FIT_HARMONICS; k++) {
+        uint16_t kw = (uint16_t)(w * k);
+
+        /* Round each term; truncation would bias every event early */
+        acc += ((int32_t)c[2 * k - 1] * sf_cos(kw) + (1L << 14)) >> 15;
+        acc += ((int32_t)c[2 * k]     * sf_sin(kw) + (1L << 14)) >> 15;
+    }
+
+    return acc;
+}
+
+static uint16_t to_minute(int32_t acc16)
+{
+    int32_t m = (acc16 + SF_SCALE / 2) >> 4;
+
+    m %= 1440;
+    if (m < 0) m += 1440;
+
+    return (uint16_t)m;
+}
+
+/* --------------------------------------------------------------------------
+ * Public API
+ * -------------------------------------------------------------------------- */
+
+void solar_fit_eval(const struct solar_fit_model *m,
+                    int day_of_year,
+                    struct solar_times *out)
+{
+    uint16_t w = sf_angle(day_of_year);
+
+    solar_times_set_std(out,
+                        to_minute(eval_event(m->coef[0], w)),
+                        to_minute(eval_event(m->coef[1], w)),
+                        to_minute(eval_event(m->coef[2], w)),
+                        to_minute(eval_event(m->coef[3], w)));
+}
+
+bool solar_fit_valid_for(int32_t lat_e4, int32_t lon_e4)
+{
+    if (s_state == SF_UNKNOWN)
+        load_stored();
+
+    return s_state == SF_VALID &&
+           s_model.latitude_e4  == lat_e4 &&
+           s_model.longitude_e4 == lon_e4;
+}
+
+bool solar_fit_build(int32_t lat_e4, int32_t lon_e4)
+{
+    struct solar_fit_model m;
+    memset(&m, 0, sizeof(m));
+
+    /* Invalidate first: a failed or interrupted build is never trusted */
+    s_state = SF_INVALID;
+    solar_fit_store_write(&m);
+
+    /* ---- Pass 1: streaming DFT of the unwrapped series ---- */
+
+    int64_t acc[SOLAR_FIT_EVENTS][SOLAR_FIT_COEFFS];
+    memset(acc, 0, sizeof(acc));
+
+    int16_t prev[SOLAR_FIT_EVENTS];
+    uint8_t mo = 1, d = 1;
+
+    for (uint16_t i = 0; i < SF_DAYS; i++, next_date(&mo, &d)) {
+
+        uint16_t v[SOLAR_FIT_EVENTS];
+        if (!sample_day(mo, d, lat_e4, lon_e4, v))
+            return false;
+
+        uint16_t w = sf_angle(i + 1);
+
+        for (uint8_t e = 0; e < SOLAR_FIT_EVENTS; e++) {
+
+            prev[e] = (i == 0) ? (int16_t)v[e] : unwrap(prev[e], v[e]);
+
+            int32_t y = (int32_t)prev[e] * SF_SCALE;
+
+            acc[e][0] += y;
+
+            for (uint8_t k = 1; k <= SOLAR_FIT_HARMONICS; k++) {
+                uint16_t kw = (uint16_t)(w * k);
+                acc[e][2 * k - 1] += (int64_t)y * sf_cos(kw);
+                acc[e][2 * k]     += (int64_t)y * sf_sin(kw);
+            }
+        }
+    }
+
+    /* Series must close on itself for a periodic fit */
+    for (uint8_t e = 0; e < SOLAR_FIT_EVENTS; e++) {
+        if (prev[e] < -1440 || prev[e] > 2 * 1440)
+            return false;
+    }
+
+    /* a0 = mean, a_k/b_k = 2/N * sum(y * basis) (basis in Q15) */
+    const int64_t den = (int64_t)SF_DAYS * 32767;
+
+    for (uint8_t e = 0; e < SOLAR_FIT_EVENTS; e++) {
+
+        int32_t a0 = (int32_t)((acc[e][0] + SF_DAYS / 2) / SF_DAYS);
+
+        a0 %= 1440 * SF_SCALE;
+        if (a0 < 0) a0 += 1440 * SF_SCALE;
+        m.coef[e][0] = (int16_t)a0;
+
+        for (uint8_t c = 1; c < SOLAR_FIT_COEFFS; c++) {
+            int64_t n = 2 * acc[e][c];
+            int64_t q = (n >= 0 ? n + den / 2 : n - den / 2) / den;
+
+            if (q > INT16_MAX || q < INT16_MIN)
+                return false;
+
+            m.coef[e][c] = (int16_t)q;
+        }
+    }
+
+    /* ---- Pass 2: worst in-sample error ---- */
+
+    uint16_t worst = 0;
+    mo = 1; d = 1;
+
+    for (uint16_t i = 0; i < SF_DAYS; i++, next_date(&mo, &d)) {
+
+        uint16_t v[SOLAR_FIT_EVENTS];
+        if (!sample_day(mo, d, lat_e4, lon_e4, v))
+            return false;
+
+        uint16_t w = sf_angle(i + 1);
+
+        for (uint8_t e = 0; e < SOLAR_FIT_EVENTS; e++) {
+            uint16_t dm = minute_dist(to_minute(eval_event(m.coef[e], w)), v[e]);
+            if (dm > worst)
+                worst = dm;
+        }
+    }
+
+    if (worst > SF_MAX_ERR_MIN)
+        return false;
+
+    m.magic        = SOLAR_FIT_MAGIC;
+    m.version      = SOLAR_FIT_VERSION;
+    m.max_err_min  = (uint8_t)worst;
+    m.latitude_e4  = lat_e4;
+    m.longitude_e4 = lon_e4;
+    m.checksum     = config_fletcher16(&m, offsetof(struct solar_fit_model, checksum));
+
+    solar_fit_store_write(&m);
+
+    s_model = m;
+    s_state = SF_VALID;
+
+    return true;
+}
+
+bool solar_fit_lookup(uint16_t year,
+                      uint8_t  month,
+                      uint8_t  day,
+                      int32_t  lat_e4,
+                      int32_t  lon_e4,
+                      struct solar_times *out,
+                      bool *have_sol)
+{
+    if (!out || !have_sol)
+        return false;
+
+    if (!solar_fit_valid_for(lat_e4, lon_e4))
+        return false;
+
+    solar_fit_eval(&s_model, solar_day_of_year(year, month, day), out);
+
+    /* Fit exists only for locations with all events every day */
+    *have_sol = true;
+    return true;
+}
+
+uint8_t solar_fit_max_error(void)
+{
+    if (s_state == SF_UNKNOWN)
+        load_stored();
+
+    return (s_state == SF_VALID) ? s_model.max_err_min : 0xFF;
+}
@@ -0,0 +1,94 @@
+/*
+ * solar_fit.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Per-location harmonic (Fourier) model of solar event times
+ *
+ * Notes:
+ *  - Middle ground between solar_compute() and the 366-day table
+ *  - Each event (std/civ rise/set) is modelled over day-of-year as
+ *        m(doy) = a0 + sum_k ( a_k cos(k w) + b_k sin(k w) ),
+ *        w = 2*pi*(doy - 1) / 366
+ *  - Fitted once when a new location is saved (366 solar computations)
+ *  - Evaluation is integer only: a quarter-wave sine table and
+ *    SOLAR_FIT_HARMONICS * 2 multiply-adds per event
+ *  - Only locations where every day has all four events can be fitted;
+ *    otherwise the model is marked unusable and callers fall back
+ *  - Selected with -DSOLAR_MODEL_FIT (Makefile: SOLAR_MODEL=fit)
+ *
+ * Storage:
+ *  - int16 coefficients in 1/16 minute, 4 events x (1 + 2K) values
+ *  - K = 4 → 72 bytes + header
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "solar.h"
+
+#define SOLAR_FIT_HARMONICS  4
+#define SOLAR_FIT_EVENTS     4
+#define SOLAR_FIT_COEFFS     (1 + 2 * SOLAR_FIT_HARMONICS)
+
+#define SOLAR_FIT_MAGIC      0x5346u   /* 'SF' */
+#define SOLAR_FIT_VERSION    1
+
+struct solar_fit_model {
+    uint16_t magic;
+    uint8_t  version;
+    uint8_t  max_err_min;       /* worst in-sample error seen at build */
+    int32_t  latitude_e4;       /* key */
+    int32_t  longitude_e4;      /* key */
+
+    /*
+     * Per event: a0, a1, b1, a2, b2, ...
+     * Units: 1/16 minute. a0 is normalized to 0..1439.
+     */
+    int16_t  coef[SOLAR_FIT_EVENTS][SOLAR_FIT_COEFFS];
+
+    uint16_t checksum;          /* Fletcher-16 over all fields above */
+};
+
+/*
+ * True if the stored model was fitted for (lat_e4, lon_e4) and
+ * passes its checksum. Cached until the next build.
+ */
+bool solar_fit_valid_for(int32_t lat_e4, int32_t lon_e4);
+
+/*
+ * Fit and store a model for (lat_e4, lon_e4).
+ *
+ * Returns false (and stores nothing usable) if some day of the year
+ * lacks one of the four events.
+ */
+bool solar_fit_build(int32_t lat_e4, int32_t lon_e4);
+
+/*
+ * Evaluate a model directly (no storage, no key check).
+ */
+void solar_fit_eval(const struct solar_fit_model *m,
+                    int day_of_year,
+                    struct solar_times *out);
+
+/*
+ * Model lookup, same contract as solar_table_lookup():
+ *  - true  → model answered, *out filled, *have_sol = true
+ *  - false → no usable model for this location
+ */
+bool solar_fit_lookup(uint16_t year,
+                      uint8_t  month,
+                      uint8_t  day,
+                      int32_t  lat_e4,
+                      int32_t  lon_e4,
+                      struct solar_times *out,
+                      bool *have_sol);
+
+/* Worst in-sample error of the stored model (minutes), 0xFF if none */
+uint8_t solar_fit_max_error(void);
+
+/* Platform storage hooks (platform/solar_fit_eeprom.cpp) */
+void solar_fit_store_read(struct solar_fit_model *m);
+void solar_fit_store_write(const struct solar_fit_model *m);
@@ -0,0 +1,563 @@
+/*
+ * solar_fixed.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Fixed-point (libm-free) solar engine
+ *
+ * Notes:
+ *  - Same NOAA almanac equations as solar.cpp, integer arithmetic only
+ *  - No float, no double, no libm
+ *  - Selected with -DSOLAR_ENGINE_FIXED (Makefile: SOLAR_ENGINE=fixed)
+ *
+ * Number formats:
+ *  - Angles are binary angles (BAM): full turn == 2^32.
+ *    Wrap-around IS the modulo-360 normalization; no while() loops.
+ *    The same scale doubles as time-of-day: 2^32 == 24 h, so the
+ *    NOAA "divide degrees by 15 to get hours" step disappears.
+ *  - sin/cos/ratios are Q30 (1.0 == 2^30).
+ *  - Day counts are Q16 (1 day == 2^16).
+ *  - 32-bit arithmetic only: products are assembled from 16-bit
+ *    halves, so no 64-bit multiply or shift is pulled from libgcc.
+ *
+ * Trig:
+ *  - CORDIC, shift/add only, 30 iterations (~1e-8 rad).
+ *  - acos(cosH) is evaluated as atan2(sqrt(den^2 - num^2), num), which
+ *    removes the only division in the NOAA equations.
+ *  - sqrt is digit-by-digit on a Q28 root, so the remainder fits 32 bits.
+ *
+ * Structure:
+ *  - Ephemeris terms (M, L, RA, declination) depend only on the day and
+ *    the 06:00 / 18:00 anchor, never on the zenith angle. They are
+ *    computed once per anchor and shared by every event on that side.
+ *
+ * Accuracy:
+ *  - Matches solar_noaa_compute() to within one minute for |lat| <= 65.
+ *    See tests/solar_host.
+ *
+ * Updated: 2026-10-16
+ */
+
+#include <stddef.h>
+
+#include "solar_engine.h"
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#else
+#define PROGMEM
+#define pgm_read_dword(p) (*(p))
+#endif
+
+/* --------------------------------------------------------------------------
+ * Fixed-point constants
+ *
+ * All values derived from the NOAA constants in solar.cpp.
+ * -------------------------------------------------------------------------- */
+
+#define Q30_ONE            (1L << 30)
+
+#define BAM_90             0x40000000UL
+#define BAM_180            0x80000000UL
+
+/* degrees * 1e4  →  BAM, as Q16 multiplier (2^32 / 3600000 * 2^16) */
+#define E4_TO_BAM_Q16      78187494UL
+
+/* millidegrees  →  BAM, as Q16 multiplier (2^32 / 360000 * 2^16) */
+#define MDEG_TO_BAM_Q16    781874935UL
+
+/* Mean anomaly: M = 0.9856 * t - 3.289 (degrees) */
+#define M_PER_DAY_BAM      11758666UL
+#define M_OFFSET_BAM       39239298UL
+
+/* True longitude: L = M + 1.916 sin M + 0.020 sin 2M + 282.634 */
+#define L_C1_BAM           22858770L
+#define L_C2_BAM           238609L
+#define L_OFFSET_BAM       3371954963UL
+
+/* Right ascension / declination factors */
+#define RA_TAN_Q30         985308447L     /* 0.91764 */
+#define DEC_SIN_Q30        427155972L     /* 0.39782 */
+
+/* Local mean time: T = H + RA - 0.06571 t - 6.622 (hours) */
+#define T_PER_DAY_BAM      11759263UL
+#define T_OFFSET_BAM       1185053060UL
+
+/* Approximate-time anchors: 06:00 and 18:00 as Q16 day fractions */
+#define T_RISE_Q16         16384L
+#define T_SET_Q16          49152L
+
+/* --------------------------------------------------------------------------
+ * CORDIC
+ * -------------------------------------------------------------------------- */
+
+#define CORDIC_ITERS       30
+
+/* Aggregate CORDIC gain 1/K in Q30 (0.6072529350...) */
+#define CORDIC_GAIN_Q30    652032874L
+
+/* atan(2^-i) as BAM */
+static const uint32_t cordic_atan[CORDIC_ITERS] PROGMEM = {
+    0x20000000UL, 0x12E4051EUL, 0x09FB385BUL, 0x051111D4UL,
+    0x028B0D43UL, 0x0145D7E1UL, 0x00A2F61EUL, 0x00517C55UL,
+    0x0028BE53UL, 0x00145F2FUL, 0x000A2F98UL, 0x000517CCUL,
+    0x00028BE6UL, 0x000145F3UL, 0x0000A2FAUL, 0x0000517DUL,
+    0x000028BEUL, 0x0000145FUL, 0x00000A30UL, 0x00000518UL,
+    0x0000028CUL, 0x00000146UL, 0x000000A3UL, 0x00000051UL,
+    0x00000029UL, 0x00000014UL, 0x0000000AUL, 0x00000005UL,
+    0x00000003UL, 0x00000001UL
+};
+
+/* --------------------------------------------------------------------------
+ * Multiplies with 32-bit intermediates
+ * -------------------------------------------------------------------------- */
+
+/*
+ * (a * b) >> 30 for |a|, |b| <= 2^30.
+ *
+ * Split at bit 15: the high x high product is exact, the cross terms
+ * are shifted separately so they cannot overflow, and low x low
+ * (under one LSB after the shift) is dropped. Error <= 3 LSB Q30.
+ */
+static inline int32_t mul_q30(int32_t a, int32_t b)
+{
+    int32_t ah = a >> 15, al = a & 0x7FFF;
+    int32_t bh = b >> 15, bl = b & 0x7FFF;
+
+    return ah * bh + ((ah * bl) >> 15) + ((al * bh) >> 15);
+}
+
+/*
+ * (v * k) >> 16, modulo 2^32. Exact.
+ *
+ * Used for Q16 day counts times per-day BAM rates (the wrap is the
+ * modulo-360 normalization) and for degree → BAM conversions.
+ */
+static inline uint32_t mul_q16(uint32_t v, uint32_t k)
+{
+    uint32_t kl = k & 0xFFFF;
+
+    return v * (k >> 16)
+         + (v >> 16) * kl
+         + (((v & 0xFFFF) * kl) >> 16);
+}
+
+/* --------------------------------------------------------------------------
+ * sin/cos of a binary angle (Q30 results)
+ *
+ * CORDIC rotation mode converges for |angle| < ~99 degrees, so the
+ * input is folded into [-90, +90) first and the result negated back.
+ * -------------------------------------------------------------------------- */
+static void fx_sincos(uint32_t a, int32_t *s, int32_t *c)
+{
+    bool flip = false;
+
+    if ((a + BAM_90) & BAM_180) {
+        a += BAM_180;
+        flip = true;
+    }
+
+    int32_t x = CORDIC_GAIN_Q30;
+    int32_t y = 0;
+    int32_t z = (int32_t)a;
+
+    for (uint8_t i = 0; i < CORDIC_ITERS; i++) {
+        int32_t dx = y >> i;
+        int32_t dy = x >> i;
+        int32_t t  = (int32_t)pgm_read_dword(&cordic_atan[i]);
+
+        if (z >= 0) {
+            x -= dx;
+            y += dy;
+            z -= t;
+        } else {
+            x += dx;
+            y -= dy;
+            z += t;
+        }
+    }
+
+    if (flip) {
+        x = -x;
+        y = -y;
+    }
+
+    if (s) *s = y;
+    if (c) *c = x;
+}
+
+/* --------------------------------------------------------------------------
+ * atan2(y, x) as a binary angle
+ *
+ * CORDIC vectoring mode. Inputs must stay below 2^29 in magnitude
+ * (vector length grows by 1.647 during the iteration).
+ * -------------------------------------------------------------------------- */
+static uint32_t fx_atan2(int32_t y, int32_t x)
+{
+    uint32_t z = 0;
+
+    if (x < 0) {
+        x = -x;
+        y = -y;
+        z = BAM_180;
+    }
+
+    for (uint8_t i = 0; i < CORDIC_ITERS; i++) {
+        int32_t  dx = y >> i;
+        int32_t  dy = x >> i;
+        uint32_t t  = pgm_read_dword(&cordic_atan[i]);
+
+        if (y > 0) {
+            x += dx;
+            y -= dy;
+            z += t;
+        } else {
+            x -= dx;
+            y += dy;
+            z -= t;
+        }
+    }
+
+    return z;
+}
+
+/* --------------------------------------------------------------------------
+ * sqrt of a Q30 value in [0, 1], Q30 result
+ *
+ * Digit-by-digit on x * 2^26, two input bits per step. The root is
+ * Q28, so the remainder (<= 2 * root) still fits 32 bits after its
+ * two-bit shift. The last two result bits are zero (~1e-9).
+ * -------------------------------------------------------------------------- */
+static int32_t fx_sqrt_q30(uint32_t x)
+{
+    uint32_t root = 0;
+    uint32_t rem  = 0;
+
+    for (uint8_t i = 0; i < 29; i++) {
+        rem  = (rem << 2) | (x >> 30);
+        x  <<= 2;
+        root <<= 1;
+
+        uint32_t trial = (root << 1) | 1;
+
+        if (rem >= trial) {
+            rem  -= trial;
+            root |= 1;
+        }
+    }
+
+    return (int32_t)(root << 2);
+}
+
+/* --------------------------------------------------------------------------
+ * Day-constant ephemeris for one anchor time (06:00 or 18:00 local mean)
+ *
+ * Everything in calc_event() that does not depend on the zenith angle.
+ * -------------------------------------------------------------------------- */
+struct fx_ephem {
+    uint32_t ut_base;   /* RA - 0.06571 t - 6.622 h - lngHour, as BAM */
+    int32_t  sinDec;    /* Q30 */
+    int32_t  cosDec;    /* Q30 */
+};
+
+static void fixed_ephemeris(
+    int      day_of_year,
+    int32_t  lon_q16,
+    uint32_t lon_bam,
+    bool     sunrise,
+    struct fx_ephem *e)
+{
+    /* Approximate time, Q16 days (>= 0.5 day: doy >= 1, |lon| <= 180) */
+    uint32_t t = (uint32_t)(((int32_t)day_of_year << 16)
+                            + (sunrise ? T_RISE_Q16 : T_SET_Q16)
+                            - lon_q16);
+
+    /* Sun's mean anomaly */
+    uint32_t M = mul_q16(t, M_PER_DAY_BAM) - M_OFFSET_BAM;
+
+    /* Sun's true longitude (wraps naturally) */
+    int32_t sinM, sin2M;
+    fx_sincos(M,      &sinM,  NULL);
+    fx_sincos(M << 1, &sin2M, NULL);
+
+    uint32_t L = M
+        + (uint32_t)mul_q30(L_C1_BAM, sinM)
+        + (uint32_t)mul_q30(L_C2_BAM, sin2M)
+        + L_OFFSET_BAM;
+
+    int32_t sinL, cosL;
+    fx_sincos(L, &sinL, &cosL);
+
+    /* Right ascension, already in L's quadrant */
+    uint32_t RA = fx_atan2(mul_q30(RA_TAN_Q30, sinL) >> 1, cosL >> 1);
+
+    /* Declination */
+    e->sinDec = mul_q30(DEC_SIN_Q30, sinL);
+    e->cosDec = fx_sqrt_q30(
+        (uint32_t)(Q30_ONE - mul_q30(e->sinDec, e->sinDec)));
+
+    /* Local mean time → universal time, minus the hour angle */
+    e->ut_base = RA
+               - mul_q16(t, T_PER_DAY_BAM)
+               - T_OFFSET_BAM
+               - lon_bam;
+}
+
+/* --------------------------------------------------------------------------
+ * One zenith crossing from a precomputed ephemeris
+ *
+ * Output:
+ *  - ut_out: event time in UTC as a BAM day fraction (2^32 == 24 h)
+ *
+ * Returns false if the sun never reaches the zenith angle that day.
+ * -------------------------------------------------------------------------- */
+static bool fixed_crossing(
+    const struct fx_ephem *e,
+    int32_t  sinLat,
+    int32_t  cosLat,
+    int32_t  cosZ,
+    bool     sunrise,
+    uint32_t *ut_out)
+{
+    /* Local hour angle: cosH = num / den */
+    int32_t num = cosZ - mul_q30(e->sinDec, sinLat);
+    int32_t den = mul_q30(e->cosDec, cosLat);
+
+    /* Sun never rises or sets */
+    if (num > den || num < -den)
+        return false;
+
+    /* den^2 - num^2 >= 0 here, up to the multiply's rounding */
+    int32_t sin2H = mul_q30(den, den) - mul_q30(num, num);
+    int32_t sinH  = fx_sqrt_q30(sin2H > 0 ? (uint32_t)sin2H : 0);
+
+    uint32_t H = fx_atan2(sinH >> 1, num >> 1);
+
+    if (sunrise)
+        H = 0u - H;
+
+    /* mod 24 h by wrap-around */
+    *ut_out = H + e->ut_base;
+
+    return true;
+}
+
+/* --------------------------------------------------------------------------
+ * BAM day fraction → rounded local minute-of-day (0..1439)
+ * -------------------------------------------------------------------------- */
+static uint16_t bam_to_minutes(uint32_t ut, int8_t tz)
+{
+    /* round(ut * 1440 / 2^32) == round(ut * 45 / 2^27), in 16-bit halves */
+    uint32_t q = (ut >> 16) * 45u + (((ut & 0xFFFF) * 45u) >> 16);
+    int16_t  m = (int16_t)((q + (1UL << 10)) >> 11);
+
+    m += (int16_t)tz * 60;
+
+    while (m < 0)     m += 1440;
+    while (m >= 1440) m -= 1440;
+
+    return (uint16_t)m;
+}
+
+/* --------------------------------------------------------------------------
+ * Location constants
+ *
+ * Everything that depends only on where, not when.
+ * -------------------------------------------------------------------------- */
+#define FX_ZENITH_SLOTS 4
+
+struct fx_loc {
+    uint32_t lon_bam;   /* lngHour / 24 as BAM (wrapped) */
+    int32_t  lon_q16;   /* lngHour / 24 as Q16 days (signed, unwrapped) */
+    int32_t  sinLat;
+    int32_t  cosLat;
+
+    /* cos(zenith) cache; std, civil, nautical, astronomical */
+    uint8_t  nzen;
+    uint32_t zen_mdeg[FX_ZENITH_SLOTS];
+    int32_t  cosZ[FX_ZENITH_SLOTS];
+};
+
+/* degrees * 1e4 → BAM; a negative angle is the negated BAM of its magnitude */
+static uint32_t e4_to_bam(int32_t v_e4, uint32_t *mag)
+{
+    *mag = mul_q16(v_e4 < 0 ? 0u - (uint32_t)v_e4 : (uint32_t)v_e4,
+                   E4_TO_BAM_Q16);
+
+    return v_e4 < 0 ? 0u - *mag : *mag;
+}
+
+static void fixed_loc_init(struct fx_loc *loc, int32_t lat_e4, int32_t lon_e4)
+{
+    uint32_t mag;
+
+    loc->lon_bam = e4_to_bam(lon_e4, &mag);
+
+    /* |lon| <= 180 deg → mag < 2^32, so mag >> 16 is positive */
+    loc->lon_q16 = (int32_t)(mag >> 16);
+    if (lon_e4 < 0)
+        loc->lon_q16 = -loc->lon_q16;
+
+    fx_sincos(e4_to_bam(lat_e4, &mag), &loc->sinLat, &loc->cosLat);
+
+    loc->nzen = 0;
+}
+
+static int32_t fixed_loc_cosZ(struct fx_loc *loc, uint32_t zenith_mdeg)
+{
+    for (uint8_t i = 0; i < loc->nzen; i++) {
+        if (loc->zen_mdeg[i] == zenith_mdeg)
+            return loc->cosZ[i];
+    }
+
+    int32_t c;
+    fx_sincos(mul_q16(zenith_mdeg, MDEG_TO_BAM_Q16), NULL, &c);
+
+    if (loc->nzen < FX_ZENITH_SLOTS) {
+        loc->zen_mdeg[loc->nzen] = zenith_mdeg;
+        loc->cosZ[loc->nzen]     = c;
+        loc->nzen++;
+    }
+
+    return c;
+}
+
+/* --------------------------------------------------------------------------
+ * Events for one day-of-year
+ *
+ * Each anchor ephemeris (sunrise side / sunset side) is computed at most
+ * once and shared by every event on that side. Each additional event
+ * costs one sqrt + one atan2.
+ * -------------------------------------------------------------------------- */
+static uint8_t fixed_day_events(
+    struct fx_loc *loc,
+    int      day_of_year,
+    int8_t   tz,
+    struct solar_event *ev,
+    uint8_t  count)
+{
+    struct fx_ephem eph[2];
+    bool have_eph[2] = { false, false };
+
+    uint8_t valid = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+
+        uint8_t side = ev[i].sunrise ? 0 : 1;
+
+        if (!have_eph[side]) {
+            fixed_ephemeris(day_of_year, loc->lon_q16, loc->lon_bam,
+                            ev[i].sunrise, &eph[side]);
+            have_eph[side] = true;
+        }
+
+        uint32_t ut;
+
+        if (ev[i].zenith_mdeg == SOLAR_ZENITH_TRANSIT) {
+            /* Solar noon: hour angle 0 */
+            ut = eph[side].ut_base;
+            ev[i].valid = true;
+        } else {
+            int32_t cosZ = fixed_loc_cosZ(loc, ev[i].zenith_mdeg);
+
+            ev[i].valid = fixed_crossing(&eph[side], loc->sinLat, loc->cosLat,
+                                         cosZ, ev[i].sunrise, &ut);
+        }
+        ev[i].minute = ev[i].valid ? bam_to_minutes(ut, tz) : 0;
+
+        if (ev[i].valid)
+            valid++;
+    }
+
+    return valid;
+}
+
+/* --------------------------------------------------------------------------
+ * Event kernel
+ * -------------------------------------------------------------------------- */
+uint8_t solar_fixed_events(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    int32_t  lat_e4,
+    int32_t  lon_e4,
+    int8_t   tz,
+    struct solar_event *ev,
+    uint8_t  count)
+{
+    if (!ev || count == 0)
+        return 0;
+
+    struct fx_loc loc;
+    fixed_loc_init(&loc, lat_e4, lon_e4);
+
+    return fixed_day_events(&loc, solar_day_of_year(year, month, day),
+                            tz, ev, count);
+}
+
+/* --------------------------------------------------------------------------
+ * Multi-day walk
+ *
+ * Location constants once, then one day-of-year step per day.
+ * Results are identical to calling solar_fixed_compute() per day.
+ * -------------------------------------------------------------------------- */
+uint8_t solar_fixed_range(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    uint8_t  ndays,
+    int32_t  lat_e4,
+    int32_t  lon_e4,
+    int8_t   tz,
+    struct solar_times *out,
+    bool *valid)
+{
+    if (!out || !valid)
+        return 0;
+
+    struct fx_loc loc;
+    fixed_loc_init(&loc, lat_e4, lon_e4);
+
+    int doy = solar_day_of_year(year, month, day);
+    uint8_t n_ok = 0;
+
+    for (uint8_t i = 0; i < ndays; i++) {
+
+        struct solar_event ev[SOLAR_STD_EVENTS];
+        solar_std_events_init(ev);
+
+        fixed_day_events(&loc, doy, tz, ev, SOLAR_STD_EVENTS);
+
+        valid[i] = solar_times_from_events(ev, &out[i]);
+        if (valid[i])
+            n_ok++;
+
+        solar_next_day(&year, &doy);
+    }
+
+    return n_ok;
+}
+
+/* --------------------------------------------------------------------------
+ * Engine entry point (standard + civil, via the kernel)
+ * -------------------------------------------------------------------------- */
+bool solar_fixed_compute(
+    uint16_t year,
+    uint8_t  month,
+    uint8_t  day,
+    int32_t  lat_e4,
+    int32_t  lon_e4,
+    int8_t   tz,
+    struct solar_times *out)
+{
+    if (!out)
+        return false;
+
+    struct solar_event ev[SOLAR_STD_EVENTS];
+    solar_std_events_init(ev);
+
+    if (solar_fixed_events(year, month, day, lat_e4, lon_e4, tz,
+                           ev, SOLAR_STD_EVENTS) != SOLAR_STD_EVENTS)
+        return false;
+
+    return solar_times_from_events(ev, out);
+}
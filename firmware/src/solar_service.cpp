@@ -0,0 +1,131 @@
+/*
+ * solar_service.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Memoized per-day solar times shared by every consumer
+ *
+ * Notes:
+ *  - Portable: no RTC, no config; callers supply date and location
+ *  - Fixed-size, no heap
+ *
+ * Updated: 2026-10-16
+ */
+
+#include "solar_service.h"
+#include "solar_table.h"
+
+#include <string.h>
+
+struct solar_memo {
+    int      y, mo, d;
+    int32_t  lat_e4, lon_e4;
+    uint16_t requested;         /* SOLAR_Q_* asked for (0 == empty slot) */
+    uint16_t stamp;             /* last use, for replacement */
+    struct solar_times sol;
+};
+
+static struct solar_memo s_memo[SOLAR_SERVICE_SLOTS];
+static uint16_t s_clock;
+static uint32_t s_computes;
+
+/* Cache build owed by 'save' / boot */
+static bool    s_build_queued;
+static int32_t s_build_lat_e4;
+static int32_t s_build_lon_e4;
+
+static bool memo_match(const struct solar_memo *m,
+                       int y, int mo, int d,
+                       int32_t lat_e4, int32_t lon_e4)
+{
+    return m->requested != 0 &&
+           m->y == y && m->mo == mo && m->d == d &&
+           m->lat_e4 == lat_e4 && m->lon_e4 == lon_e4;
+}
+
+uint16_t solar_service_get(int y, int mo, int d,
+                           int32_t lat_e4, int32_t lon_e4,
+                           uint16_t need,
+                           struct solar_times *out)
+{
+    if (!out)
+        return 0;
+
+    struct solar_memo *m = NULL;
+
+    for (uint8_t i = 0; i < SOLAR_SERVICE_SLOTS; i++) {
+        if (memo_match(&s_memo[i], y, mo, d, lat_e4, lon_e4)) {
+            m = &s_memo[i];
+            break;
+        }
+    }
+
+    if (!m) {
+        /* Empty slot first, else least recently used */
+        m = &s_memo[0];
+
+        for (uint8_t i = 0; i < SOLAR_SERVICE_SLOTS; i++) {
+            if (s_memo[i].requested == 0) {
+                m = &s_memo[i];
+                break;
+            }
+            if ((uint16_t)(s_clock - s_memo[i].stamp) >
+                (uint16_t)(s_clock - m->stamp))
+                m = &s_memo[i];
+        }
+
+        memset(m, 0, sizeof(*m));
+        m->y      = y;
+        m->mo     = mo;
+        m->d      = d;
+        m->lat_e4 = lat_e4;
+        m->lon_e4 = lon_e4;
+    }
+
+    m->stamp = ++s_clock;
+
+    /* Recompute only if something new is asked for (once per superset) */
+    if (need & (uint16_t)~m->requested) {
+        uint16_t want = (uint16_t)(m->requested | need);
+
+        solar_table_get_mask((uint16_t)y, (uint8_t)mo, (uint8_t)d,
+                             lat_e4, lon_e4, want, &m->sol);
+
+        m->requested = want;
+        s_computes++;
+    }
+
+    *out = m->sol;
+    return (uint16_t)(m->sol.valid_mask & need);
+}
+
+void solar_service_invalidate(void)
+{
+    memset(s_memo, 0, sizeof(s_memo));
+}
+
+void solar_service_queue_build(int32_t lat_e4, int32_t lon_e4)
+{
+    s_build_queued = true;
+    s_build_lat_e4 = lat_e4;
+    s_build_lon_e4 = lon_e4;
+}
+
+bool solar_service_build_queued(void)
+{
+    if (!s_build_queued)
+        return false;
+
+    /* Once: a fit that cannot be built is not retried every pass */
+    s_build_queued = false;
+
+    if (solar_table_cache_needed(s_build_lat_e4, s_build_lon_e4))
+        (void)solar_table_cache_build(s_build_lat_e4, s_build_lon_e4);
+
+    solar_service_invalidate();
+    return true;
+}
+
+uint32_t solar_service_computes(void)
+{
+    return s_computes;
+}
@@ -0,0 +1,60 @@
+/*
+ * solar_service.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Memoized per-day solar times shared by every consumer
+ *
+ * Notes:
+ *  - Keyed by (UTC date, latitude_e4, longitude_e4)
+ *  - Holds a few days (yesterday / today / tomorrow fit); least
+ *    recently used entry is replaced
+ *  - Each entry remembers which SOLAR_Q_* quantities were requested,
+ *    so a later request for a superset recomputes once and a repeat
+ *    request never recomputes
+ *  - Computation goes through solar_table_get_mask() (baked table,
+ *    EEPROM cache, then runtime math)
+ *  - Invalidated by scheduler_invalidate_solar() (date set, TZ/DST,
+ *    location) and after a solar cache rebuild (save, or a queued
+ *    build); a new location also misses by key
+ *  - UTC only; callers apply TZ/DST for display
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "solar.h"
+
+#define SOLAR_SERVICE_SLOTS 3
+
+/*
+ * Solar times for (y, mo, d) at (lat_e4, lon_e4), at least the
+ * quantities in need (SOLAR_Q_*).
+ *
+ * *out receives the memoized entry; out->valid_mask may hold more
+ * than need if an earlier caller asked for more.
+ *
+ * Returns out->valid_mask & need.
+ */
+uint16_t solar_service_get(int y, int mo, int d,
+                           int32_t lat_e4, int32_t lon_e4,
+                           uint16_t need,
+                           struct solar_times *out);
+
+/* Drop every memoized day */
+void solar_service_invalidate(void);
+
+/*
+ * Solar cache build owed for (lat_e4, lon_e4): 'save' found devices
+ * busy, or the saved location had none at boot. The main loop runs it
+ * with solar_service_build_queued() once devices are idle.
+ */
+void solar_service_queue_build(int32_t lat_e4, int32_t lon_e4);
+
+/* Run a queued build (drops the memo). False if none was queued. */
+bool solar_service_build_queued(void);
+
+/* Number of actual solar evaluations since boot (diagnostics) */
+uint32_t solar_service_computes(void);
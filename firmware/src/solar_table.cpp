@@ -0,0 +1,305 @@
+/*
+ * solar_table.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Precomputed day-of-year solar table
+ *
+ * Notes:
+ *  - Portable: storage comes from solar_table_store_* hooks
+ *  - Lookups never touch floating point
+ *  - Stored header is verified once (checksum over the full table)
+ *    and the result cached until the next build
+ *
+ * Updated: 2026-10-16
+ */
+
+#include "solar_table.h"
+#include "solar_fit.h"
+#include "solar_baked.h"
+#include "solar_engine.h"
+#include "time_dst.h"
+
+#include <stddef.h>
+
+/* Marker for "event does not occur" */
+#define ST_NONE 0x0FFFu
+
+/* Any leap year: covers day-of-year 1..366 */
+#define ST_BUILD_YEAR 2028
+
+/* --------------------------------------------------------------------------
+ * Cached header verification
+ * -------------------------------------------------------------------------- */
+
+enum {
+    ST_UNKNOWN = 0,
+    ST_VALID,
+    ST_INVALID
+};
+
+static uint8_t s_state = ST_UNKNOWN;
+static int32_t s_lat_e4;
+static int32_t s_lon_e4;
+
+/* --------------------------------------------------------------------------
+ * Fletcher-16, incremental (same result as config_fletcher16)
+ * -------------------------------------------------------------------------- */
+static void fletcher_update(uint16_t *s1, uint16_t *s2,
+                            const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    while (len--) {
+        *s1 = (*s1 + *p++) % 255;
+        *s2 = (*s2 + *s1) % 255;
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Day packing: 4 x 12-bit values in 6 bytes
+ * -------------------------------------------------------------------------- */
+static void pack_day(const uint16_t v[4], uint8_t b[SOLAR_TABLE_DAY_BYTES])
+{
+    b[0] = (uint8_t)(v[0]);
+    b[1] = (uint8_t)((v[0] >> 8) | (v[1] << 4));
+    b[2] = (uint8_t)(v[1] >> 4);
+    b[3] = (uint8_t)(v[2]);
+    b[4] = (uint8_t)((v[2] >> 8) | (v[3] << 4));
+    b[5] = (uint8_t)(v[3] >> 4);
+}
+
+static void unpack_day(const uint8_t b[SOLAR_TABLE_DAY_BYTES], uint16_t v[4])
+{
+    v[0] = (uint16_t)(b[0] | ((b[1] & 0x0F) << 8));
+    v[1] = (uint16_t)((b[1] >> 4) | (b[2] << 4));
+    v[2] = (uint16_t)(b[3] | ((b[4] & 0x0F) << 8));
+    v[3] = (uint16_t)((b[4] >> 4) | (b[5] << 4));
+}
+
+/* --------------------------------------------------------------------------
+ * Verify stored table (full checksum pass)
+ * -------------------------------------------------------------------------- */
+static void verify_stored(void)
+{
+    struct solar_table_hdr hdr;
+    solar_table_store_read_hdr(&hdr);
+
+    s_state = ST_INVALID;
+
+    if (hdr.magic != SOLAR_TABLE_MAGIC ||
+        hdr.version != SOLAR_TABLE_VERSION)
+        return;
+
+    uint16_t s1 = 0, s2 = 0;
+    fletcher_update(&s1, &s2, &hdr, offsetof(struct solar_table_hdr, checksum));
+
+    for (uint16_t i = 0; i < SOLAR_TABLE_DAYS; i++) {
+        uint8_t b[SOLAR_TABLE_DAY_BYTES];
+        solar_table_store_read_day(i, b);
+        fletcher_update(&s1, &s2, b, sizeof(b));
+    }
+
+    if (hdr.checksum != (uint16_t)((s2 << 8) | s1))
+        return;
+
+    s_lat_e4 = hdr.latitude_e4;
+    s_lon_e4 = hdr.longitude_e4;
+    s_state  = ST_VALID;
+}
+
+/* --------------------------------------------------------------------------
+ * Public API
+ * -------------------------------------------------------------------------- */
+
+bool solar_table_valid_for(int32_t lat_e4, int32_t lon_e4)
+{
+    if (s_state == ST_UNKNOWN)
+        verify_stored();
+
+    return s_state == ST_VALID &&
+           s_lat_e4 == lat_e4 &&
+           s_lon_e4 == lon_e4;
+}
+
+bool solar_table_build(int32_t lat_e4, int32_t lon_e4)
+{
+    struct solar_table_hdr hdr = {};
+
+    /* Invalidate first: an interrupted build is never trusted */
+    s_state = ST_INVALID;
+    solar_table_store_write_hdr(&hdr);
+
+    hdr.magic        = SOLAR_TABLE_MAGIC;
+    hdr.version      = SOLAR_TABLE_VERSION;
+    hdr.latitude_e4  = lat_e4;
+    hdr.longitude_e4 = lon_e4;
+
+    uint16_t s1 = 0, s2 = 0;
+    fletcher_update(&s1, &s2, &hdr, offsetof(struct solar_table_hdr, checksum));
+
+    uint8_t mo = 1;
+    uint8_t d  = 1;
+
+    for (uint16_t i = 0; i < SOLAR_TABLE_DAYS; i++) {
+
+        struct solar_event ev[SOLAR_STD_EVENTS];
+        solar_std_events_init(ev);
+
+        (void)solar_events_compute(ST_BUILD_YEAR, mo, d,
+                                   lat_e4, lon_e4, 0,
+                                   ev, SOLAR_STD_EVENTS);
+
+        uint16_t v[4];
+        for (uint8_t e = 0; e < 4; e++)
+            v[e] = ev[e].valid ? ev[e].minute : ST_NONE;
+
+        uint8_t b[SOLAR_TABLE_DAY_BYTES];
+        pack_day(v, b);
+
+        solar_table_store_write_day(i, b);
+        fletcher_update(&s1, &s2, b, sizeof(b));
+
+        if (++d > days_in_month(ST_BUILD_YEAR, mo)) {
+            d = 1;
+            mo++;
+        }
+    }
+
+    hdr.checksum = (uint16_t)((s2 << 8) | s1);
+    solar_table_store_write_hdr(&hdr);
+
+    s_lat_e4 = lat_e4;
+    s_lon_e4 = lon_e4;
+    s_state  = ST_VALID;
+
+    return true;
+}
+
+bool solar_table_lookup(uint16_t year,
+                        uint8_t  month,
+                        uint8_t  day,
+                        int32_t  lat_e4,
+                        int32_t  lon_e4,
+                        struct solar_times *out,
+                        bool *have_sol)
+{
+    if (!out || !have_sol)
+        return false;
+
+    if (!solar_table_valid_for(lat_e4, lon_e4))
+        return false;
+
+    int n = solar_day_of_year(year, month, day);
+    if (n < 1 || n > SOLAR_TABLE_DAYS)
+        return false;
+
+    uint8_t b[SOLAR_TABLE_DAY_BYTES];
+    solar_table_store_read_day((uint16_t)(n - 1), b);
+
+    uint16_t v[4];
+    unpack_day(b, v);
+
+    /* Same contract as solar_compute(): all four events or nothing */
+    *have_sol = false;
+
+    for (uint8_t e = 0; e < 4; e++) {
+        if (v[e] >= 1440)
+            return true;
+    }
+
+    solar_times_set_std(out, v[0], v[1], v[2], v[3]);
+
+    *have_sol = true;
+    return true;
+}
+
+bool solar_table_get(uint16_t year,
+                     uint8_t  month,
+                     uint8_t  day,
+                     int32_t  lat_e4,
+                     int32_t  lon_e4,
+                     struct solar_times *out)
+{
+    bool have_sol;
+
+#if defined(SOLAR_BAKED)
+    if (solar_baked_lookup(year, month, day, lat_e4, lon_e4, 0, out, &have_sol))
+        return have_sol;
+#endif
+
+#if defined(SOLAR_MODEL_FIT)
+    if (solar_fit_lookup(year, month, day, lat_e4, lon_e4, out, &have_sol))
+        return have_sol;
+#else
+    if (solar_table_lookup(year, month, day, lat_e4, lon_e4, out, &have_sol))
+        return have_sol;
+#endif
+
+    return solar_compute_e4(year, month, day, lat_e4, lon_e4, 0, out);
+}
+
+bool solar_table_cache_needed(int32_t lat_e4, int32_t lon_e4)
+{
+#if defined(SOLAR_BAKED)
+    if (solar_baked_valid_for(lat_e4, lon_e4))
+        return false;
+#endif
+
+#if defined(SOLAR_MODEL_FIT)
+    return !solar_fit_valid_for(lat_e4, lon_e4);
+#else
+    return !solar_table_valid_for(lat_e4, lon_e4);
+#endif
+}
+
+bool solar_table_cache_build(int32_t lat_e4, int32_t lon_e4)
+{
+#if defined(SOLAR_MODEL_FIT)
+    return solar_fit_build(lat_e4, lon_e4);
+#else
+    return solar_table_build(lat_e4, lon_e4);
+#endif
+}
+
+uint16_t solar_table_get_mask(uint16_t year,
+                              uint8_t  month,
+                              uint8_t  day,
+                              int32_t  lat_e4,
+                              int32_t  lon_e4,
+                              uint16_t need,
+                              struct solar_times *out)
+{
+    if (!out)
+        return 0;
+
+    out->valid_mask = 0;
+
+    /* Standard + civil come from the cache whole, when it has them */
+    if (need & SOLAR_Q_STD_CIV) {
+        bool have_sol = false;
+        bool hit = false;
+
+#if defined(SOLAR_BAKED)
+        hit = solar_baked_lookup(year, month, day, lat_e4, lon_e4, 0,
+                                 out, &have_sol);
+#endif
+
+#if defined(SOLAR_MODEL_FIT)
+        if (!hit)
+            hit = solar_fit_lookup(year, month, day, lat_e4, lon_e4,
+                                   out, &have_sol);
+#else
+        if (!hit)
+            hit = solar_table_lookup(year, month, day, lat_e4, lon_e4,
+                                     out, &have_sol);
+#endif
+        if (hit && have_sol)
+            need &= (uint16_t)~SOLAR_Q_STD_CIV;
+    }
+
+    /* Everything else: only what was asked for */
+    if (need)
+        solar_compute_mask(year, month, day, lat_e4, lon_e4, 0, need, out);
+
+    return out->valid_mask;
+}
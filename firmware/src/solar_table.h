@@ -0,0 +1,129 @@
+/*
+ * solar_table.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Precomputed day-of-year solar table
+ *
+ * Notes:
+ *  - One entry per day-of-year (1..366), UTC minutes (tz = 0)
+ *  - NOAA equations depend only on day-of-year, so one table serves
+ *    every year exactly
+ *  - Built once when a new location is saved; looked up in O(1)
+ *  - Keyed by (lat_e4, lon_e4) and protected by a checksum.
+ *    A table for a different location, or a corrupt one, is never used.
+ *  - Callers fall back to solar_compute_e4() on a miss
+ *
+ * Storage:
+ *  - 4 x 12-bit minutes per day (6 bytes), 0xFFF = event does not occur
+ *  - Backing store is platform-provided (solar_table_store_*)
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "solar.h"
+
+#define SOLAR_TABLE_DAYS       366
+#define SOLAR_TABLE_DAY_BYTES  6
+#define SOLAR_TABLE_DATA_BYTES (SOLAR_TABLE_DAYS * SOLAR_TABLE_DAY_BYTES)
+
+#define SOLAR_TABLE_MAGIC      0x5354u   /* 'ST' */
+#define SOLAR_TABLE_VERSION    1
+
+struct solar_table_hdr {
+    uint16_t magic;
+    uint8_t  version;
+    uint8_t  _pad0;
+    int32_t  latitude_e4;       /* key */
+    int32_t  longitude_e4;      /* key */
+    uint16_t checksum;          /* Fletcher-16 over header fields + data */
+};
+
+/*
+ * True if the stored table was built for (lat_e4, lon_e4) and
+ * passes its checksum. Validation is cached until the next build.
+ */
+bool solar_table_valid_for(int32_t lat_e4, int32_t lon_e4);
+
+/*
+ * Rebuild the table for (lat_e4, lon_e4).
+ *
+ * Slow (366 solar computations + EEPROM writes). Intended for
+ * configuration save only. Safe to interrupt: the header is
+ * invalidated first and rewritten last.
+ */
+bool solar_table_build(int32_t lat_e4, int32_t lon_e4);
+
+/*
+ * Table lookup.
+ *
+ * Returns:
+ *  - true  → table answered; *out filled if the sun rises/sets,
+ *            *have_sol says which
+ *  - false → table missing or stale for this location
+ */
+bool solar_table_lookup(uint16_t year,
+                        uint8_t  month,
+                        uint8_t  day,
+                        int32_t  lat_e4,
+                        int32_t  lon_e4,
+                        struct solar_times *out,
+                        bool *have_sol);
+
+/*
+ * UTC solar times for a day: a baked flash table for this site if one
+ * is built in (solar_baked.h), then the per-location cache (this table,
+ * or the harmonic model with SOLAR_MODEL_FIT), solar_compute_e4() on a
+ * miss.
+ *
+ * Returns false if the sun does not rise/set that day.
+ */
+bool solar_table_get(uint16_t year,
+                     uint8_t  month,
+                     uint8_t  day,
+                     int32_t  lat_e4,
+                     int32_t  lon_e4,
+                     struct solar_times *out);
+
+/*
+ * Lazy variant of solar_table_get() for the scheduler.
+ *
+ * need is a SOLAR_Q_* mask (typically scheduler_solar_needs()).
+ *  - Standard / civil quantities come from the per-location cache
+ *  - Anything else, or a cache miss, is computed via
+ *    solar_compute_mask() for the requested quantities only
+ *  - need == 0 touches neither storage nor solar math
+ *
+ * out is overwritten; quantities that do not occur that day are
+ * absent from the result.
+ *
+ * Returns out->valid_mask.
+ */
+uint16_t solar_table_get_mask(uint16_t year,
+                              uint8_t  month,
+                              uint8_t  day,
+                              int32_t  lat_e4,
+                              int32_t  lon_e4,
+                              uint16_t need,
+                              struct solar_times *out);
+
+/*
+ * Per-location cache of this build: the EEPROM table, or the harmonic
+ * fit with SOLAR_MODEL_FIT. A baked site (solar_baked.h) needs none.
+ *
+ *  - solar_table_cache_needed(): nothing stored answers for the site
+ *  - solar_table_cache_build(): build it. Slow (seconds), callers make
+ *    sure no device is moving. False if the fit could not be built;
+ *    runtime math stays in use.
+ */
+bool solar_table_cache_needed(int32_t lat_e4, int32_t lon_e4);
+bool solar_table_cache_build(int32_t lat_e4, int32_t lon_e4);
+
+/* Platform storage hooks (platform/solar_table_eeprom.cpp) */
+void solar_table_store_read_hdr(struct solar_table_hdr *hdr);
+void solar_table_store_write_hdr(const struct solar_table_hdr *hdr);
+void solar_table_store_read_day(uint16_t index, uint8_t buf[SOLAR_TABLE_DAY_BYTES]);
+void solar_table_store_write_day(uint16_t index, const uint8_t buf[SOLAR_TABLE_DAY_BYTES]);
@@ -66,6 +66,11 @@
 
 #include "state_reducer.h"
 #include "resolve_when.h"
+#include "config_events.h"   /* EVENT_INDEX_MAX_DEVICES */
+
+/* Per-device groups are laid out by the config_events index */
+static_assert(STATE_REDUCER_MAX_DEVICES == EVENT_INDEX_MAX_DEVICES,
+              "reducer and event index must cover the same device IDs");
 
 void state_reducer_run(const Event *events,
                        size_t table_size,
@@ -119,3 +124,73 @@ void state_reducer_run(const Event *events,
         }
     }
 }
+
+bool state_reducer_run_device(const struct ResolvedEvent *events,
+                              size_t count,
+                              uint8_t device_id,
+                              uint16_t now_minute,
+                              uint32_t today_epoch_midnight,
+                              struct reduced_state *out)
+{
+    if (!events || !out || device_id >= STATE_REDUCER_MAX_DEVICES)
+        return false;
+
+    /*
+     * Last entry <= now governs. On equal minutes that is the higher
+     * slot, as in state_reducer_run() ('>=' wins).
+     */
+    size_t i = resolved_upper_bound(events, count, now_minute);
+    if (i == 0)
+        return false;
+
+    const struct ResolvedEvent *ev = &events[i - 1];
+
+    out->action[device_id]     = ev->action;
+    out->has_action[device_id] = true;
+    out->when[device_id] =
+        today_epoch_midnight + ((uint32_t)ev->minute * 60u);
+
+    return true;
+}
+
+void state_reducer_run_indexed(const struct ResolvedEvent *by_device,
+                               const uint8_t *start,
+                               const struct ResolvedEvent *carry,
+                               uint8_t device_mask,
+                               uint16_t now_minute,
+                               uint32_t today_epoch_midnight,
+                               struct reduced_state *out)
+{
+    if (!out)
+        return;
+
+    for (uint8_t d = 0; d < STATE_REDUCER_MAX_DEVICES; d++) {
+
+        if (!(device_mask & (1u << d)))
+            continue;
+
+        /* Clear this device's output */
+        out->has_action[d] = false;
+        out->action[d]     = ACTION_OFF;
+        out->when[d]       = 0;
+
+        if (!by_device || !start)
+            continue;
+
+        if (state_reducer_run_device(&by_device[start[d]],
+                                     (size_t)(start[d + 1] - start[d]),
+                                     d,
+                                     now_minute,
+                                     today_epoch_midnight,
+                                     out))
+            continue;
+
+        /* Nothing yet today: yesterday's last event still governs */
+        if (carry && carry[d].refnum != 0) {
+            out->action[d]     = carry[d].action;
+            out->has_action[d] = true;
+            out->when[d] = today_epoch_midnight - 86400u +
+                           ((uint32_t)carry[d].minute * 60u);
+        }
+    }
+}
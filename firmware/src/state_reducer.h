@@ -18,6 +18,11 @@
  *    event whose resolved minute-of-day is <= now_minute.
  *  - That event becomes the governing event for the device.
  *  - Future events are ignored.
+ *  - The indexed form may fall back to yesterday's last event
+ *    (carry-over) before a device's first event of the day.
+ *  - Calendar qualifiers are applied upstream: the indexed form gets
+ *    only today's events (scheduler timeline). The full-table form
+ *    treats every event as daily.
  *
  * Properties:
  *  - Safe to call at boot
@@ -101,3 +106,48 @@ void state_reducer_run(const Event *events,
                        uint16_t now_minute,
                        uint32_t today_epoch_midnight,
                        struct reduced_state *out);
+
+/*
+ * Same reduction over the per-device compiled timeline
+ * (scheduler_timeline_by_device()).
+ *
+ * Parameters:
+ *  by_device   - each device's resolved events, minute-sorted,
+ *                slot order on ties
+ *  start       - STATE_REDUCER_MAX_DEVICES + 1 offsets into by_device;
+ *                device d owns [start[d], start[d + 1])
+ *  carry       - yesterday's last event per device, refnum == 0 if
+ *                none (scheduler_carry_over()); may be NULL
+ *  device_mask - devices to reduce (bit d → device d); the others
+ *                keep their previous entries in out
+ *  now_minute  - current minute-of-day (0..1439), UTC
+ *  out         - output reduced state (masked entries cleared first)
+ *
+ * Contract:
+ *  - With carry == NULL and all devices in the mask, result equals
+ *    state_reducer_run() on the table the groups were built from
+ *  - A device with no event <= now today is governed by its carry
+ *    entry; when = today_epoch_midnight - 86400 + minute * 60
+ *  - One binary search per device: cost follows events-per-device,
+ *    not table size
+ */
+void state_reducer_run_indexed(const struct ResolvedEvent *by_device,
+                               const uint8_t *start,
+                               const struct ResolvedEvent *carry,
+                               uint8_t device_mask,
+                               uint16_t now_minute,
+                               uint32_t today_epoch_midnight,
+                               struct reduced_state *out);
+
+/*
+ * Reduce a single device (one group of the per-device timeline).
+ *
+ * Returns true and sets out->has_action/action/when[device_id] if an
+ * event <= now_minute exists; otherwise leaves out untouched.
+ */
+bool state_reducer_run_device(const struct ResolvedEvent *events,
+                              size_t count,
+                              uint8_t device_id,
+                              uint16_t now_minute,
+                              uint32_t today_epoch_midnight,
+                              struct reduced_state *out);
@@ -24,4 +24,19 @@
 void system_sleep_until(uint16_t minute);
 
 
+/*
+ * system_idle()
+ *
+ * Purpose:
+ *  - Stop the CPU clock (SLEEP_MODE_IDLE) until the next interrupt
+ *
+ * Contract:
+ *  - Returns after at most one Timer0 tick (1 ms); any enabled
+ *    interrupt (INT0/INT1, UART RX) ends it sooner
+ *  - Timers, UART and I/O keep running, nothing is masked or re-armed
+ *  - Caller owns the deadline: loop until it is due
+ */
+void system_idle(void);
+
+
  void system_sleep_init(void);
@@ -8,8 +8,9 @@
  *  - Offline system
  *  - Deterministic behavior
  *  - No network dependencies
+ *  - Callers pass UTC; the US rule is applied in local time
  *
- * Updated: 2025-12-29
+ * Updated: 2026-10-16
  */
 
 #include <stdbool.h>
@@ -23,7 +24,7 @@
  *  - Ends first Sunday in November at 02:00
  */
 
-static int day_of_week(int y, int m, int d)
+int day_of_week(int y, int m, int d)
 {
     /* Zeller's congruence, 0=Sunday */
     if (m < 3) { m += 12; y--; }
@@ -67,12 +68,55 @@ bool is_us_dst(int y, int m, int d, int h)
 
 int utc_offset_minutes(int y, int mo, int d, int h)
 {
-    int dst = 0;
+    int std = (int)g_cfg.tz * 60;
 
-    if (g_cfg.honor_dst && is_us_dst(y, mo, d, h))
-        dst = 60;
+    if (!g_cfg.honor_dst)
+        return std;
 
-    return g_cfg.tz * 60 + dst;
+    /* UTC hour → local standard hour (and date) */
+    int lh = h + (int)g_cfg.tz;
+
+    while (lh < 0) {
+        lh += 24;
+        date_step(&y, &mo, &d, -1);
+    }
+
+    while (lh >= 24) {
+        lh -= 24;
+        date_step(&y, &mo, &d, +1);
+    }
+
+    /* DST ends at 02:00 daylight time, which is 01:00 standard */
+    if (mo == 11)
+        lh++;
+
+    return is_us_dst(y, mo, d, lh) ? std + 60 : std;
+}
+
+void day_utc_offset_get(int y, int mo, int d, struct day_utc_offset *out)
+{
+    if (!out)
+        return;
+
+    int first = utc_offset_minutes(y, mo, d, 0);
+
+    out->before = (int16_t)first;
+    out->after  = (int16_t)first;
+    out->change = 1440;
+
+    if (!g_cfg.honor_dst)
+        return;
+
+    /* tz is whole hours: a change falls on a UTC hour */
+    for (int h = 1; h < 24; h++) {
+        int o = utc_offset_minutes(y, mo, d, h);
+
+        if (o != first) {
+            out->after  = (int16_t)o;
+            out->change = (uint16_t)(h * 60);
+            return;
+        }
+    }
 }
 
 
@@ -97,3 +141,21 @@ int days_in_month(int y, int mo)
     if (mo == 2 && is_leap_year(y)) return 29;
     return dpm[mo - 1];
 }
+
+void date_step(int *y, int *mo, int *d, int dir)
+{
+    if (!y || !mo || !d)
+        return;
+
+    if (dir > 0) {
+        if (++(*d) > days_in_month(*y, *mo)) {
+            *d = 1;
+            if (++(*mo) > 12) { *mo = 1; (*y)++; }
+        }
+    } else if (dir < 0) {
+        if (--(*d) < 1) {
+            if (--(*mo) < 1) { *mo = 12; (*y)--; }
+            *d = days_in_month(*y, *mo);
+        }
+    }
+}
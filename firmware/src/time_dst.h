@@ -22,8 +22,33 @@
 bool is_us_dst(int y, int m, int d, int h);
 
 
+/*
+ * Offset of local wall-clock time from UTC, minutes (tz + DST).
+ *
+ * y/mo/d/h are UTC. The DST rule is stated in local time, so the UTC
+ * hour is taken to local standard time first: the change lands at
+ * 02:00 local, not at 02:00 UTC.
+ */
 int utc_offset_minutes(int y, int mo, int d, int h);
 
+/*
+ * UTC day (y, mo, d) → its offsets, DST change included.
+ * 24 utc_offset_minutes() calls: once per day, never per wake.
+ */
+struct day_utc_offset;
+void day_utc_offset_get(int y, int mo, int d, struct day_utc_offset *out);
+
 bool is_leap_year(int y);
 
+/* Day of the week, 0 = Sunday .. 6 = Saturday (Gregorian) */
+int day_of_week(int y, int m, int d);
+
 int days_in_month(int y, int mo);
+
+/*
+ * Step a calendar date by one day.
+ *
+ *  dir > 0 → next day, dir < 0 → previous day, 0 → unchanged
+ *  Month and year roll over (Gregorian).
+ */
+void date_step(int *y, int *mo, int *d, int dir);
@@ -9,12 +9,13 @@
  *  - Deterministic behavior
  *  - No network dependencies
  *
- * Updated: 2025-12-29
+ * Updated: 2026-10-16
  */
 
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 // Initialize uptime timebase (firmware). Host may stub.
 void uptime_init(void);
@@ -24,3 +25,7 @@ uint32_t uptime_seconds(void);
 
 // Monotonic milliseconds since boot.
 uint32_t uptime_millis(void);
+
+// True once uptime_millis() has reached deadline_ms (wrap-safe).
+// Cheap enough to poll after every idle wake.
+bool uptime_reached(uint32_t deadline_ms);
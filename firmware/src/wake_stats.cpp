@@ -0,0 +1,63 @@
+/*
+ * wake_stats.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Count main-loop wakeups by cause
+ *
+ * Notes:
+ *  - Counters saturate instead of wrapping
+ *
+ * Updated: 2026-10-16
+ */
+
+#include "wake_stats.h"
+
+#include <string.h>
+
+static struct wake_counts s_today;
+static struct wake_counts s_yesterday;
+static uint32_t s_total;
+
+void wake_stats_record(enum wake_cause cause)
+{
+    if (cause >= WAKE_CAUSE_COUNT)
+        return;
+
+    if (s_today.by_cause[cause] != 0xFFFFu)
+        s_today.by_cause[cause]++;
+
+    s_total++;
+}
+
+void wake_stats_new_day(void)
+{
+    s_yesterday = s_today;
+    memset(&s_today, 0, sizeof(s_today));
+}
+
+const struct wake_counts *wake_stats_today(void)
+{
+    return &s_today;
+}
+
+const struct wake_counts *wake_stats_yesterday(void)
+{
+    return &s_yesterday;
+}
+
+uint32_t wake_stats_total(void)
+{
+    return s_total;
+}
+
+uint16_t wake_counts_sum(const struct wake_counts *c)
+{
+    if (!c)
+        return 0;
+
+    uint32_t n = 0;
+    for (uint8_t i = 0; i < WAKE_CAUSE_COUNT; i++)
+        n += c->by_cause[i];
+
+    return (n > 0xFFFFu) ? 0xFFFFu : (uint16_t)n;
+}
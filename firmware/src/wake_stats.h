@@ -0,0 +1,46 @@
+/*
+ * wake_stats.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Count main-loop wakeups by cause
+ *
+ * Notes:
+ *  - Portable: the main loop classifies each wake and records it here
+ *  - Today's counts roll into "yesterday" at the UTC date change, so a
+ *    full day's wakes are always visible from the console
+ *  - No heap, fixed-size counters
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/* Why the controller left sleep */
+enum wake_cause : uint8_t {
+    WAKE_CAUSE_EVENT = 0,       /* RTC alarm for a scheduled event */
+    WAKE_CAUSE_DAY,             /* RTC alarm at the day boundary (housekeeping) */
+    WAKE_CAUSE_EXTERNAL,        /* door switch / other interrupt */
+    WAKE_CAUSE_CONFIG,          /* config switch: console session began
+                                   (the strap is not an interrupt source) */
+    WAKE_CAUSE_COUNT
+};
+
+struct wake_counts {
+    uint16_t by_cause[WAKE_CAUSE_COUNT];
+};
+
+/* Record one wake */
+void wake_stats_record(enum wake_cause cause);
+
+/* UTC date changed: today's counts become yesterday's */
+void wake_stats_new_day(void);
+
+/* Counters (today since the date change, the previous full day, since boot) */
+const struct wake_counts *wake_stats_today(void);
+const struct wake_counts *wake_stats_yesterday(void);
+uint32_t wake_stats_total(void);
+
+/* Sum over causes */
+uint16_t wake_counts_sum(const struct wake_counts *c);
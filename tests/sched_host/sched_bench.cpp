@@ -0,0 +1,375 @@
+/*
+ * sched_bench.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Scheduling cost vs event table size; packed event encoding
+ *
+ * Notes:
+ *  - Host only (native g++), links the firmware scheduler unchanged
+ *  - Tables of 16 / 32 / 64 / MAX_EVENTS random events (door, LED,
+ *    relays; midnight and every solar reference)
+ *  - Per-wake paths (next wake, devices due, indexed reduce of one
+ *    device) should stay flat as the table grows; the full-table
+ *    reference scans are timed alongside for contrast
+ *  - Per-edit cost (recompile of the timeline) is reported separately
+ *  - Checks: indexed reduction equals the reference at every minute;
+ *    every event (qualifiers included) survives pack / unpack;
+ *    out-of-range events are refused; chained Fletcher-16 equals the
+ *    one-shot sum
+ *  - Events here are daily; calendar qualifiers: sched_days_test
+ *
+ * Updated: 2026-10-16
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "config_events.h"
+#include "scheduler.h"
+#include "state_reducer.h"
+#include "next_event.h"
+#include "solar_service.h"
+#include "solar_table.h"
+#include "solar_fit.h"
+
+/* --------------------------------------------------------------------------
+ * RAM backing store for the solar table / fit (no EEPROM on the host)
+ * -------------------------------------------------------------------------- */
+
+static struct solar_table_hdr ram_hdr;
+static uint8_t ram_data[SOLAR_TABLE_DATA_BYTES];
+static struct solar_fit_model ram_fit;
+
+void solar_table_store_read_hdr(struct solar_table_hdr *hdr)        { *hdr = ram_hdr; }
+void solar_table_store_write_hdr(const struct solar_table_hdr *hdr) { ram_hdr = *hdr; }
+
+void solar_table_store_read_day(uint16_t i, uint8_t buf[SOLAR_TABLE_DAY_BYTES])
+{
+    memcpy(buf, &ram_data[i * SOLAR_TABLE_DAY_BYTES], SOLAR_TABLE_DAY_BYTES);
+}
+
+void solar_table_store_write_day(uint16_t i, const uint8_t buf[SOLAR_TABLE_DAY_BYTES])
+{
+    memcpy(&ram_data[i * SOLAR_TABLE_DAY_BYTES], buf, SOLAR_TABLE_DAY_BYTES);
+}
+
+void solar_fit_store_read(struct solar_fit_model *m)        { *m = ram_fit; }
+void solar_fit_store_write(const struct solar_fit_model *m) { ram_fit = *m; }
+
+/* -------------------------------------------------------------------------- */
+
+static int fails = 0;
+
+#define CHECK(c, ...) do { if (!(c)) { printf("FAIL: " __VA_ARGS__); printf("\n"); fails++; } } while (0)
+
+static volatile uint32_t g_sink;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+#define YEAR  2028
+#define MONTH 6
+#define DAY   21
+#define MIDNIGHT_EPOCH 898473600UL  /* 2028-06-21 00:00 UTC, 2000 base */
+
+static const uint8_t k_devices[] = { 1, 3, 4, 5 };
+
+static struct solar_times s_sol;
+
+static void random_event(Event *ev)
+{
+    memset(ev, 0, sizeof(*ev));
+
+    ev->device_id = k_devices[rand() % 4];
+    ev->action    = (rand() & 1) ? ACTION_ON : ACTION_OFF;
+
+    int r = rand() % 10;            /* 0 → midnight, else a solar ref */
+    if (r == 0) {
+        ev->when.ref = REF_MIDNIGHT;
+        ev->when.offset_minutes = (int16_t)(rand() % 1440);
+    } else {
+        ev->when.ref = (enum TimeRef)(REF_SOLAR_STD_RISE + (r - 1));
+        ev->when.offset_minutes = (int16_t)((rand() % 241) - 120);
+    }
+}
+
+static void fill(int n)
+{
+    config_events_clear();
+
+    for (int i = 0; i < n; i++) {
+        Event ev;
+        random_event(&ev);
+        CHECK(config_events_add(&ev), "add %d", i);
+    }
+
+    scheduler_update_day(YEAR, MONTH, DAY, &s_sol, true, SOLAR_Q_ALL);
+    (void)scheduler_take_dirty();
+}
+
+/* ---- correctness ---------------------------------------------------- */
+
+static void check_reduce(int n)
+{
+    const Event *events = config_events_get(NULL);
+    const uint8_t *start;
+    const struct ResolvedEvent *by_dev = scheduler_timeline_by_device(&start);
+
+    long diff = 0;
+
+    for (uint16_t m = 0; m < 1440; m++) {
+        struct reduced_state a, b;
+
+        state_reducer_run(events, MAX_EVENTS, &s_sol, m, MIDNIGHT_EPOCH, &a);
+
+        memset(&b, 0, sizeof(b));
+        state_reducer_run_indexed(by_dev, start, NULL, SCHED_DIRTY_ALL,
+                                  m, MIDNIGHT_EPOCH, &b);
+
+        for (int d = 0; d < STATE_REDUCER_MAX_DEVICES; d++) {
+            if (a.has_action[d] != b.has_action[d] ||
+                (a.has_action[d] &&
+                 (a.action[d] != b.action[d] || a.when[d] != b.when[d])))
+                diff++;
+        }
+    }
+
+    CHECK(diff == 0, "%d events: indexed reduce differs (%ld)", n, diff);
+}
+
+static void check_pack(void)
+{
+    const Event *events = config_events_get(NULL);
+    long bad = 0;
+
+    for (int i = 0; i < MAX_EVENTS; i++) {
+        uint8_t b[EVENT_PACKED_BYTES];
+        Event back;
+
+        if (!config_event_pack(&events[i], b)) {
+            bad++;
+            continue;
+        }
+
+        config_event_unpack(b, (uint8_t)i, &back);
+        if (memcmp(&back, &events[i], sizeof(back)) != 0)
+            bad++;
+    }
+
+    CHECK(bad == 0, "pack round trip (%ld slots)", bad);
+
+    /* Extremes round trip */
+    static const int16_t offs[] = { EVENT_OFFSET_MIN, -1, 0, 1, 1439, EVENT_OFFSET_MAX };
+
+    for (unsigned i = 0; i < sizeof(offs) / sizeof(offs[0]); i++) {
+        Event ev, back;
+        uint8_t b[EVENT_PACKED_BYTES];
+
+        memset(&ev, 0, sizeof(ev));
+        ev.device_id = EVENT_DEVICE_MAX;
+        ev.action    = ACTION_ON;
+        ev.when.ref  = REF_SOLAR_NOON;
+        ev.when.offset_minutes = offs[i];
+        ev.refnum    = MAX_EVENTS;
+        ev.weekdays  = (uint8_t)(EVENT_DAYS_ALL >> i);
+        ev.from_mo   = 12;
+        ev.from_d    = 31;
+        ev.to_mo     = 2;
+        ev.to_d      = 29;
+
+        CHECK(config_event_pack(&ev, b), "pack offset %d", offs[i]);
+        config_event_unpack(b, MAX_EVENTS - 1, &back);
+        CHECK(memcmp(&back, &ev, sizeof(ev)) == 0, "round trip offset %d", offs[i]);
+    }
+
+    /* Unrepresentable events are refused by the mutators */
+    Event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.device_id = 1;
+    ev.when.ref  = REF_MIDNIGHT;
+
+    ev.when.offset_minutes = EVENT_OFFSET_MAX + 1;
+    CHECK(!config_events_add(&ev), "offset above range accepted");
+
+    ev.when.offset_minutes = 0;
+    ev.device_id = EVENT_DEVICE_MAX + 1;
+    CHECK(!config_events_add(&ev), "device above range accepted");
+
+    ev.device_id = 1;
+    ev.from_mo = 4;
+    ev.from_d  = 31;
+    ev.to_mo   = 5;
+    ev.to_d    = 1;
+    CHECK(!config_events_add(&ev), "04/31 accepted");
+
+    /* Unused slot packs to zeros */
+    uint8_t z[EVENT_PACKED_BYTES];
+    Event empty;
+    memset(&empty, 0, sizeof(empty));
+    CHECK(config_event_pack(&empty, z) && !z[0] && !z[1] && !z[2], "empty slot");
+
+    /* Chained checksum */
+    uint8_t buf[1000];
+    for (unsigned i = 0; i < sizeof(buf); i++)
+        buf[i] = (uint8_t)rand();
+
+    uint16_t one = config_fletcher16(buf, sizeof(buf));
+    uint16_t two = config_fletcher16(buf, 37);
+    two = config_fletcher16_continue(two, buf + 37, 500);
+    two = config_fletcher16_continue(two, buf + 537, sizeof(buf) - 537);
+    CHECK(one == two, "chained fletcher16 %04x vs %04x", one, two);
+}
+
+/* ---- timing --------------------------------------------------------- */
+
+struct bench_row {
+    int    n;
+    double compile_us;      /* per edit */
+    double wake_ns;         /* scheduler_next_wake_minute */
+    double due_ns;          /* scheduler_devices_due */
+    double reduce_ns;       /* indexed, one device */
+    double ref_reduce_ns;   /* state_reducer_run, full table */
+    double ref_next_ns;     /* next_event_today, full table */
+};
+
+static void bench(int n, struct bench_row *row)
+{
+    const int reps = 200;
+    uint32_t acc = 0;
+    double t0, t1;
+
+    row->n = n;
+
+    /* Edit → recompile */
+    t0 = now_sec();
+    for (int r = 0; r < reps * 10; r++) {
+        schedule_touch_devices(1u << k_devices[r % 4]);
+        size_t c;
+        acc += (uint32_t)(uintptr_t)scheduler_timeline(&c) + (uint32_t)c;
+    }
+    t1 = now_sec();
+    row->compile_us = (t1 - t0) * 1e6 / (reps * 10);
+
+    (void)scheduler_take_dirty();
+
+    /* Next wake */
+    t0 = now_sec();
+    for (int r = 0; r < reps; r++) {
+        for (uint16_t m = 0; m < 1440; m++) {
+            uint16_t w = 0;
+            acc += scheduler_next_wake_minute(m, &w, NULL) + w;
+        }
+    }
+    t1 = now_sec();
+    row->wake_ns = (t1 - t0) * 1e9 / (reps * 1440.0);
+
+    /* Devices due on a minute tick */
+    t0 = now_sec();
+    for (int r = 0; r < reps; r++) {
+        for (uint16_t m = 1; m < 1440; m++)
+            acc += scheduler_devices_due((uint16_t)(m - 1), m);
+    }
+    t1 = now_sec();
+    row->due_ns = (t1 - t0) * 1e9 / (reps * 1439.0);
+
+    /* Indexed reduce, one dirty device */
+    const uint8_t *start;
+    const struct ResolvedEvent *by_dev = scheduler_timeline_by_device(&start);
+    const struct ResolvedEvent *carry  = scheduler_carry_over();
+    struct reduced_state rs;
+    memset(&rs, 0, sizeof(rs));
+
+    t0 = now_sec();
+    for (int r = 0; r < reps; r++) {
+        for (uint16_t m = 0; m < 1440; m++) {
+            state_reducer_run_indexed(by_dev, start, carry,
+                                      (uint8_t)(1u << k_devices[m % 4]),
+                                      m, MIDNIGHT_EPOCH, &rs);
+            acc += rs.when[1];
+        }
+    }
+    t1 = now_sec();
+    row->reduce_ns = (t1 - t0) * 1e9 / (reps * 1440.0);
+
+    /* Reference: full-table scans */
+    const Event *events = config_events_get(NULL);
+    const int ref_reps = reps / 10;
+
+    t0 = now_sec();
+    for (int r = 0; r < ref_reps; r++) {
+        for (uint16_t m = 0; m < 1440; m++) {
+            state_reducer_run(events, MAX_EVENTS, &s_sol, m, MIDNIGHT_EPOCH, &rs);
+            acc += rs.when[1];
+        }
+    }
+    t1 = now_sec();
+    row->ref_reduce_ns = (t1 - t0) * 1e9 / (ref_reps * 1440.0);
+
+    t0 = now_sec();
+    for (int r = 0; r < ref_reps; r++) {
+        for (uint16_t m = 0; m < 1440; m++) {
+            size_t idx = 0;
+            uint16_t w = 0;
+            bool tmr = false;
+            acc += next_event_today(events, (size_t)n, &s_sol, m, &idx, &w, &tmr) + w;
+        }
+    }
+    t1 = now_sec();
+    row->ref_next_ns = (t1 - t0) * 1e9 / (ref_reps * 1440.0);
+
+    g_sink = acc;
+}
+
+int main(void)
+{
+    srand(17);
+
+    config_defaults(&g_cfg);
+    scheduler_init();
+
+    uint16_t got = solar_service_get(YEAR, MONTH, DAY,
+                                     g_cfg.latitude_e4, g_cfg.longitude_e4,
+                                     SOLAR_Q_ALL, &s_sol);
+    CHECK(got == SOLAR_Q_ALL, "solar for bench day");
+
+    static const int sizes[] = { 16, 32, 64, MAX_EVENTS };
+    const int nsizes = (int)(sizeof(sizes) / sizeof(sizes[0]));
+    struct bench_row rows[sizeof(sizes) / sizeof(sizes[0])];
+
+    printf("scheduling cost vs table size (%d slots, %d bytes/slot packed)\n",
+           MAX_EVENTS, EVENT_PACKED_BYTES);
+    printf("  events  edit(us)  wake(ns)  due(ns)  reduce1(ns) | ref reduce(ns)  ref next(ns)\n");
+
+    for (int i = 0; i < nsizes; i++) {
+        fill(sizes[i]);
+        check_reduce(sizes[i]);
+        bench(sizes[i], &rows[i]);
+
+        printf("  %6d  %8.2f  %8.1f  %7.1f  %11.1f | %14.1f  %12.1f\n",
+               rows[i].n, rows[i].compile_us, rows[i].wake_ns, rows[i].due_ns,
+               rows[i].reduce_ns, rows[i].ref_reduce_ns, rows[i].ref_next_ns);
+    }
+
+    const struct bench_row *a = &rows[0];
+    const struct bench_row *b = &rows[nsizes - 1];
+
+    printf("  growth %d → %d events: wake x%.1f, due x%.1f, reduce1 x%.1f"
+           " (reference reduce x%.1f)\n",
+           a->n, b->n, b->wake_ns / a->wake_ns, b->due_ns / a->due_ns,
+           b->reduce_ns / a->reduce_ns, b->ref_reduce_ns / a->ref_reduce_ns);
+
+    printf("  EEPROM: %u bytes for the packed table\n",
+           (unsigned)(MAX_EVENTS * EVENT_PACKED_BYTES));
+
+    check_pack();
+
+    printf("\n%s\n", fails ? "FAIL" : "PASS");
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,462 @@
+/*
+ * sched_days_test.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Weekday / season qualifiers in the compiled timeline
+ *
+ * Notes:
+ *  - Host only (native g++), links the firmware scheduler unchanged
+ *  - Random qualified events (weekday sets, seasons that do and do not
+ *    wrap the year end) over every day of 2027-2028
+ *  - Reference is computed independently of the scheduler: weekday
+ *    from a day count since 2000-01-01, season from day-of-year
+ *  - Per day: today's timeline, yesterday's carry-over per device and
+ *    tomorrow's first event must match the reference
+ *  - Editing an event mid-day must take effect without a date change
+ *  - The next-event wrap is flagged as tomorrow's, including when
+ *    tomorrow's first event is later in the day than today's last
+ *  - Local wall-clock events (REF_LOCAL_MIDNIGHT) across the 2027 US DST
+ *    changes: offsets of the day, skipped / repeated local times, and
+ *    the compiled timeline following the date and a TZ change
+ *
+ * Updated: 2026-10-16
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "config_events.h"
+#include "scheduler.h"
+#include "resolve_when.h"
+#include "solar_service.h"
+#include "solar_table.h"
+#include "solar_fit.h"
+#include "time_dst.h"
+
+/* --------------------------------------------------------------------------
+ * RAM backing store for the solar table / fit (no EEPROM on the host)
+ * -------------------------------------------------------------------------- */
+
+static struct solar_table_hdr ram_hdr;
+static uint8_t ram_data[SOLAR_TABLE_DATA_BYTES];
+static struct solar_fit_model ram_fit;
+
+void solar_table_store_read_hdr(struct solar_table_hdr *hdr)        { *hdr = ram_hdr; }
+void solar_table_store_write_hdr(const struct solar_table_hdr *hdr) { ram_hdr = *hdr; }
+
+void solar_table_store_read_day(uint16_t i, uint8_t buf[SOLAR_TABLE_DAY_BYTES])
+{
+    memcpy(buf, &ram_data[i * SOLAR_TABLE_DAY_BYTES], SOLAR_TABLE_DAY_BYTES);
+}
+
+void solar_table_store_write_day(uint16_t i, const uint8_t buf[SOLAR_TABLE_DAY_BYTES])
+{
+    memcpy(&ram_data[i * SOLAR_TABLE_DAY_BYTES], buf, SOLAR_TABLE_DAY_BYTES);
+}
+
+void solar_fit_store_read(struct solar_fit_model *m)        { *m = ram_fit; }
+void solar_fit_store_write(const struct solar_fit_model *m) { ram_fit = *m; }
+
+/* -------------------------------------------------------------------------- */
+
+static int fails = 0;
+
+#define CHECK(c, ...) do { if (!(c)) { printf("FAIL: " __VA_ARGS__); printf("\n"); fails++; } } while (0)
+
+#define NEVENTS 48
+
+static const uint8_t k_devices[] = { 1, 3, 4, 5 };
+
+/* ---- independent calendar ------------------------------------------- */
+
+/* 0 = Sunday; 2000-01-01 was a Saturday */
+static int ref_weekday(int y, int mo, int d)
+{
+    long days = 0;
+
+    for (int yy = 2000; yy < y; yy++)
+        days += is_leap_year(yy) ? 366 : 365;
+    for (int m = 1; m < mo; m++)
+        days += days_in_month(y, m);
+    days += d - 1;
+
+    return (int)((days + 6) % 7);
+}
+
+/* Day of a leap year, 1..366 (season bounds live in a leap calendar) */
+static int leap_ordinal(int mo, int d)
+{
+    int n = d;
+    for (int m = 1; m < mo; m++)
+        n += days_in_month(2028, m);
+    return n;
+}
+
+static bool ref_on_day(const Event *ev, int y, int mo, int d)
+{
+    if (ev->weekdays && !(ev->weekdays & (1u << ref_weekday(y, mo, d))))
+        return false;
+
+    if (ev->from_mo == 0)
+        return true;
+
+    int x = leap_ordinal(mo, d);
+    int a = leap_ordinal(ev->from_mo, ev->from_d);
+    int b = leap_ordinal(ev->to_mo, ev->to_d);
+
+    return (a <= b) ? (x >= a && x <= b) : (x >= a || x <= b);
+}
+
+/* ---- events ---------------------------------------------------------- */
+
+static void random_event(Event *ev)
+{
+    memset(ev, 0, sizeof(*ev));
+
+    ev->device_id = k_devices[rand() % 4];
+    ev->action    = (rand() & 1) ? ACTION_ON : ACTION_OFF;
+
+    if (rand() % 3 == 0) {
+        ev->when.ref = REF_MIDNIGHT;
+        ev->when.offset_minutes = (int16_t)(rand() % 1440);
+    } else {
+        ev->when.ref = (enum TimeRef)(REF_SOLAR_STD_RISE + rand() % 4);
+        ev->when.offset_minutes = (int16_t)((rand() % 121) - 60);
+    }
+
+    if (rand() % 2)
+        ev->weekdays = (uint8_t)(1 + rand() % EVENT_DAYS_ALL);
+
+    if (rand() % 5 < 2) {
+        ev->from_mo = (uint8_t)(1 + rand() % 12);
+        ev->from_d  = (uint8_t)(1 + rand() % days_in_month(2028, ev->from_mo));
+        ev->to_mo   = (uint8_t)(1 + rand() % 12);
+        ev->to_d    = (uint8_t)(1 + rand() % days_in_month(2028, ev->to_mo));
+    }
+}
+
+/* ---- one day --------------------------------------------------------- */
+
+static uint16_t solar_for(int y, int mo, int d, struct solar_times *sol)
+{
+    return solar_service_get(y, mo, d, g_cfg.latitude_e4, g_cfg.longitude_e4,
+                             SOLAR_Q_STD_CIV, sol);
+}
+
+static long s_days, s_bad_days;
+
+static void check_day(int y, int mo, int d)
+{
+    int py = y, pmo = mo, pd = d, ny = y, nmo = mo, nd = d;
+    date_step(&py, &pmo, &pd, -1);
+    date_step(&ny, &nmo, &nd, +1);
+
+    struct solar_times sol, prev, next;
+    bool have      = solar_for(y, mo, d, &sol)     == SOLAR_Q_STD_CIV;
+    bool have_prev = solar_for(py, pmo, pd, &prev) == SOLAR_Q_STD_CIV;
+    bool have_next = solar_for(ny, nmo, nd, &next) == SOLAR_Q_STD_CIV;
+
+    scheduler_update_day(y, mo, d, &sol, have, SOLAR_Q_STD_CIV);
+    scheduler_update_neighbors(&prev, have_prev, &next, have_next);
+
+    const Event *events = config_events_get(NULL);
+    bool bad = false;
+
+    /* Today: slot order on equal minutes */
+    size_t n = 0;
+    const struct ResolvedEvent *tl = scheduler_timeline(&n);
+    size_t k = 0;
+
+    for (uint16_t m = 0; m < 1440 && !bad; m++) {
+        for (size_t i = 0; i < MAX_EVENTS; i++) {
+            const Event *ev = &events[i];
+            uint16_t r;
+
+            if (ev->refnum == 0 || !ref_on_day(ev, y, mo, d) ||
+                !resolve_when(&ev->when, have ? &sol : NULL, &r) || r != m)
+                continue;
+
+            if (k >= n || tl[k].refnum != ev->refnum || tl[k].minute != m)
+                bad = true;
+            k++;
+        }
+    }
+
+    if (k != n)
+        bad = true;
+
+    /* Yesterday's last per device, tomorrow's first */
+    struct ResolvedEvent carry[EVENT_INDEX_MAX_DEVICES];
+    memset(carry, 0, sizeof(carry));
+    bool have_first = false;
+    uint16_t first = 0;
+
+    for (size_t i = 0; i < MAX_EVENTS; i++) {
+        const Event *ev = &events[i];
+        uint16_t r;
+
+        if (ev->refnum == 0)
+            continue;
+
+        if (ref_on_day(ev, py, pmo, pd) &&
+            resolve_when(&ev->when, have_prev ? &prev : NULL, &r)) {
+            struct ResolvedEvent *c = &carry[ev->device_id];
+            if (c->refnum == 0 || r >= c->minute) {
+                c->refnum = ev->refnum;
+                c->minute = r;
+            }
+        }
+
+        if (ref_on_day(ev, ny, nmo, nd) &&
+            resolve_when(&ev->when, have_next ? &next : NULL, &r)) {
+            if (!have_first || r < first) {
+                first = r;
+                have_first = true;
+            }
+        }
+    }
+
+    const struct ResolvedEvent *sc = scheduler_carry_over();
+    for (int dv = 0; dv < EVENT_INDEX_MAX_DEVICES; dv++) {
+        if (sc[dv].refnum != carry[dv].refnum ||
+            (carry[dv].refnum && sc[dv].minute != carry[dv].minute))
+            bad = true;
+    }
+
+    /* After the last event of today the query wraps to tomorrow */
+    uint16_t after = n ? tl[n - 1].minute : 0;
+    uint16_t got = 0;
+    bool tomorrow = false;
+    bool have_got = scheduler_next_event_minute(n ? after : 1439, &got,
+                                                &tomorrow);
+
+    if (have_first != have_got || (have_first && got != first) ||
+        tomorrow != have_got)
+        bad = true;
+
+    s_days++;
+    if (bad) {
+        s_bad_days++;
+        if (s_bad_days <= 5)
+            printf("  mismatch %04d-%02d-%02d\n", y, mo, d);
+    }
+}
+
+/* ---- tomorrow later than today --------------------------------------- */
+
+/*
+ * One civil-dawn event in autumn: each day's dawn is later than the
+ * last, so after today's event the wrap target (tomorrow's dawn) is a
+ * later minute than now and must be flagged as tomorrow's.
+ */
+static void check_wrap_later(void)
+{
+    config_events_clear();
+
+    Event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.device_id = 1;
+    ev.action    = ACTION_ON;
+    ev.when.ref  = REF_SOLAR_CIV_RISE;
+    CHECK(config_events_add(&ev), "add dawn");
+
+    check_day(2027, 10, 20);
+
+    size_t n = 0;
+    const struct ResolvedEvent *tl = scheduler_timeline(&n);
+    CHECK(n == 1, "one dawn today");
+    if (n != 1)
+        return;
+
+    uint16_t now = tl[0].minute;
+    uint16_t m = 0, w = 0;
+    bool t_ev = false, t_wake = false;
+
+    CHECK(scheduler_next_event_minute(now, &m, &t_ev) && t_ev && m > now,
+          "next event: tomorrow's dawn %u after today's %u", m, now);
+    CHECK(scheduler_next_wake_minute(now, &w, &t_wake) && t_wake && w == m,
+          "next wake: tomorrow's dawn %u", w);
+
+    /* Before today's dawn the answer is today's */
+    CHECK(scheduler_next_event_minute((uint16_t)(now - 1), &m, &t_ev) &&
+          !t_ev && m == now, "next event: today's dawn");
+
+    printf("wrap: dawn %u today, %u tomorrow\n", now, w);
+}
+
+/* ---- local wall-clock events ---------------------------------------- */
+
+/* 06:30 local, single event table; timeline minute on a UTC day */
+static int local_minute_on(int y, int mo, int d)
+{
+    scheduler_update_day(y, mo, d, NULL, false, 0);
+    scheduler_update_neighbors(NULL, false, NULL, false);
+
+    size_t n = 0;
+    const struct ResolvedEvent *tl = scheduler_timeline(&n);
+
+    return (n == 1) ? tl[0].minute : -1;
+}
+
+static void check_local(void)
+{
+    /* Eastern; 2027: DST from Sun 03-14 07:00 UTC to Sun 11-07 06:00 UTC */
+    g_cfg.tz = -5;
+    g_cfg.honor_dst = 1;
+
+    CHECK(utc_offset_minutes(2027, 3, 14, 6) == -300 &&
+          utc_offset_minutes(2027, 3, 14, 7) == -240, "spring change at 07 UTC");
+    CHECK(utc_offset_minutes(2027, 11, 7, 5) == -240 &&
+          utc_offset_minutes(2027, 11, 7, 6) == -300, "fall change at 06 UTC");
+    CHECK(utc_offset_minutes(2027, 3, 14, 3) == -300, "03-13 evening local is EST");
+
+    struct day_utc_offset off;
+
+    day_utc_offset_get(2027, 3, 14, &off);
+    CHECK(off.before == -300 && off.after == -240 && off.change == 420,
+          "spring day %d %d %u", off.before, off.after, (unsigned)off.change);
+
+    day_utc_offset_get(2027, 7, 1, &off);
+    CHECK(off.before == -240 && off.after == -240 && off.change == 1440, "summer day");
+
+    struct When w;
+    memset(&w, 0, sizeof(w));
+    w.ref = REF_LOCAL_MIDNIGHT;
+
+    uint16_t m = 0;
+
+    day_utc_offset_get(2027, 3, 14, &off);
+    w.offset_minutes = 150;                       /* 02:30 does not exist */
+    CHECK(resolve_when_day(&w, NULL, &off, &m) && m == 420, "skipped -> change (%u)", m);
+    w.offset_minutes = 21 * 60;                   /* 21:00 EST of 03-13 */
+    CHECK(resolve_when_day(&w, NULL, &off, &m) && m == 120, "evening before change (%u)", m);
+
+    day_utc_offset_get(2027, 11, 7, &off);
+    w.offset_minutes = 90;                        /* 01:30 happens twice */
+    CHECK(resolve_when_day(&w, NULL, &off, &m) && m == 330, "repeated -> first (%u)", m);
+    w.offset_minutes = 180;
+    CHECK(resolve_when_day(&w, NULL, &off, &m) && m == 480, "after fall change (%u)", m);
+
+    /* Without offsets a local When is UTC */
+    CHECK(resolve_when(&w, NULL, &m) && m == 180, "no offsets");
+
+    /* Stored as REF_MIDNIGHT + the local bit */
+    Event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.device_id = 1;
+    ev.refnum = 1;
+    ev.when = w;
+
+    uint8_t b[EVENT_PACKED_BYTES];
+    Event back;
+    CHECK(config_event_pack(&ev, b), "pack local");
+    config_event_unpack(b, 0, &back);
+    CHECK((b[0] & 0x0Fu) == REF_MIDNIGHT && (b[5] & 0x40u), "local bit");
+    CHECK(back.when.ref == REF_LOCAL_MIDNIGHT && back.when.offset_minutes == 180,
+          "unpack local");
+
+    ev.when.ref = REF_MIDNIGHT;
+    CHECK(config_event_pack(&ev, b) && !(b[5] & 0x40u), "utc midnight");
+    config_event_unpack(b, 0, &back);
+    CHECK(back.when.ref == REF_MIDNIGHT, "unpack utc midnight");
+
+    /* Scheduler: one 06:30 local event over the spring change */
+    config_events_clear();
+    ev.when.ref = REF_LOCAL_MIDNIGHT;
+    ev.when.offset_minutes = 6 * 60 + 30;
+    ev.refnum = 0;
+    CHECK(config_events_add(&ev), "add local");
+
+    CHECK(local_minute_on(2027, 3, 13) == 690, "06:30 EST");
+    CHECK(local_minute_on(2027, 3, 14) == 630, "06:30 EDT on the change day");
+    CHECK(local_minute_on(2027, 3, 15) == 630, "06:30 EDT");
+
+    /* TZ change re-resolves without a date change */
+    (void)scheduler_take_dirty();
+    g_cfg.tz = -6;
+    scheduler_invalidate_solar();
+    size_t n = 0;
+    const struct ResolvedEvent *tl = scheduler_timeline(&n);
+    CHECK(n == 1 && tl[0].minute == 690, "06:30 CDT after tz change");
+    CHECK(scheduler_take_dirty() == (1u << 1), "tz change dirties the local device only");
+
+    printf("local wall-clock: DST change days\n");
+}
+
+int main(void)
+{
+    srand(23);
+
+    config_defaults(&g_cfg);
+    scheduler_init();
+
+    /* Weekday bits: 2028-06-21 is a Wednesday */
+    Event w;
+    memset(&w, 0, sizeof(w));
+    w.weekdays = EVENT_DAY_WED;
+    CHECK(event_on_day(&w, (uint8_t)day_of_week(2028, 6, 21), 6, 21), "wednesday");
+    w.weekdays = EVENT_DAY_SAT | EVENT_DAY_SUN;
+    CHECK(!event_on_day(&w, (uint8_t)day_of_week(2028, 6, 21), 6, 21), "weekend");
+
+    /* Season wrapping the year end: Nov through Feb */
+    w.weekdays = 0;
+    w.from_mo = 11; w.from_d = 1; w.to_mo = 2; w.to_d = 29;
+    CHECK(event_on_day(&w, 0, 1, 15) && event_on_day(&w, 0, 11, 1) &&
+          event_on_day(&w, 0, 2, 29) && !event_on_day(&w, 0, 3, 1) &&
+          !event_on_day(&w, 0, 10, 31), "wrapped season");
+
+    for (int i = 0; i < NEVENTS; i++) {
+        Event ev;
+        random_event(&ev);
+        CHECK(config_events_add(&ev), "add %d", i);
+    }
+
+    int y = 2027, mo = 1, d = 1;
+    while (y < 2029) {
+        check_day(y, mo, d);
+        date_step(&y, &mo, &d, +1);
+    }
+
+    printf("calendar qualifiers: %d events, %ld days, %ld mismatched\n",
+           NEVENTS, s_days, s_bad_days);
+    CHECK(s_bad_days == 0, "timeline vs reference");
+
+    /* Edit without a date change: today's mask is rebuilt */
+    check_day(2028, 6, 21);
+    size_t before = 0;
+    (void)scheduler_timeline(&before);
+
+    Event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.device_id = 1;
+    ev.action = ACTION_ON;
+    ev.when.ref = REF_MIDNIGHT;
+    ev.when.offset_minutes = 600;
+    ev.weekdays = EVENT_DAY_THU;            /* not today */
+    CHECK(config_events_add(&ev), "add thursday");
+
+    size_t after = 0;
+    (void)scheduler_timeline(&after);
+    CHECK(after == before, "thursday event not in wednesday timeline");
+
+    const Event *events = config_events_get(NULL);
+    refnum_t ref = 0;
+    for (size_t i = 0; i < MAX_EVENTS; i++)
+        if (events[i].refnum && events[i].weekdays == EVENT_DAY_THU &&
+            events[i].when.offset_minutes == 600)
+            ref = events[i].refnum;
+
+    ev.weekdays = EVENT_DAY_WED;
+    CHECK(config_events_update_by_refnum(ref, &ev), "update to wednesday");
+    (void)scheduler_timeline(&after);
+    CHECK(after == before + 1, "edited event appears today (%zu vs %zu)",
+          after, before + 1);
+
+    check_wrap_later();
+    check_local();
+
+    printf("\n%s\n", fails ? "FAIL" : "PASS");
+    return fails ? 1 : 0;
+}
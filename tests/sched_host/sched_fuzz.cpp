@@ -0,0 +1,467 @@
+/*
+ * sched_fuzz.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Differential fuzzing: scheduler fast paths vs frozen reference
+ *
+ * Notes:
+ *  - Host only (native g++), links the firmware scheduler unchanged
+ *  - Reference: sched_reference.cpp (frozen full-table scans)
+ *  - Each scenario: random sparse table (mutator-built or loaded
+ *    wholesale like config_load), random date, random solar for
+ *    yesterday / today / tomorrow with random valid masks (or none),
+ *    every device ID, every reference, offsets over the full packed
+ *    range, random calendar qualifiers
+ *  - Queried at 0, 1439, every event minute and its neighbours, and
+ *    random minutes; then one random edit without a date change and
+ *    the same queries again (ETag / index invalidation)
+ *  - Compared: resolve_when, state_reducer_run, next_event_today
+ *    against their frozen copies; indexed reduction with carry-over
+ *    and scheduler_next_event_minute against the composites;
+ *    next_wake == next_event with coalescing off
+ *  - Throughput: decisions (one reduction + one next-event query) per
+ *    second for both paths; the fast path includes its compile
+ *
+ *    ./sched_fuzz [seed=N] [scenarios=N]
+ *
+ * Updated: 2026-10-16
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "config_events.h"
+#include "scheduler.h"
+#include "state_reducer.h"
+#include "next_event.h"
+#include "resolve_when.h"
+#include "solar_table.h"
+#include "solar_fit.h"
+
+#include "sched_reference.h"
+
+/* --------------------------------------------------------------------------
+ * RAM backing store for the solar table / fit (no EEPROM on the host)
+ * -------------------------------------------------------------------------- */
+
+static struct solar_table_hdr ram_hdr;
+static uint8_t ram_data[SOLAR_TABLE_DATA_BYTES];
+static struct solar_fit_model ram_fit;
+
+void solar_table_store_read_hdr(struct solar_table_hdr *hdr)        { *hdr = ram_hdr; }
+void solar_table_store_write_hdr(const struct solar_table_hdr *hdr) { ram_hdr = *hdr; }
+
+void solar_table_store_read_day(uint16_t i, uint8_t buf[SOLAR_TABLE_DAY_BYTES])
+{
+    memcpy(buf, &ram_data[i * SOLAR_TABLE_DAY_BYTES], SOLAR_TABLE_DAY_BYTES);
+}
+
+void solar_table_store_write_day(uint16_t i, const uint8_t buf[SOLAR_TABLE_DAY_BYTES])
+{
+    memcpy(&ram_data[i * SOLAR_TABLE_DAY_BYTES], buf, SOLAR_TABLE_DAY_BYTES);
+}
+
+void solar_fit_store_read(struct solar_fit_model *m)        { *m = ram_fit; }
+void solar_fit_store_write(const struct solar_fit_model *m) { ram_fit = *m; }
+
+/* -------------------------------------------------------------------------- */
+
+static long fails = 0;
+
+#define CHECK(c, ...) do { if (!(c)) { if (fails < 20) { printf("FAIL: " __VA_ARGS__); printf("\n"); } fails++; } } while (0)
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* Own PRNG: same sequence on every libc */
+static uint32_t s_rng;
+
+static uint32_t rnd(uint32_t n)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return n ? s_rng % n : 0;
+}
+
+static int month_days(int y, int m)
+{
+    static const int md[12] = { 31,28,31,30,31,30,31,31,30,31,30,31 };
+    bool leap = (y % 4 == 0 && y % 100 != 0) || (y % 400 == 0);
+    return (m == 2 && leap) ? 29 : md[m - 1];
+}
+
+/* --------------------------------------------------------------------------
+ * Scenario generation
+ * -------------------------------------------------------------------------- */
+
+struct scenario {
+    int y, mo, d;
+    uint32_t midnight;
+
+    struct solar_times sol[3];      /* yesterday, today, tomorrow */
+    bool have[3];
+};
+
+static void random_event(Event *ev)
+{
+    memset(ev, 0, sizeof(*ev));
+
+    ev->device_id = (uint8_t)rnd(EVENT_DEVICE_MAX + 1);
+    ev->action    = rnd(2) ? ACTION_ON : ACTION_OFF;
+
+    /* Mostly real refs; now and then disabled or unknown ones */
+    uint32_t r = rnd(16);
+    ev->when.ref = (enum TimeRef)(r < 13 ? 1 + r % 10 : r);
+
+    switch (rnd(4)) {
+    case 0:  ev->when.offset_minutes = (int16_t)(EVENT_OFFSET_MIN +
+                 (int32_t)rnd(EVENT_OFFSET_MAX - EVENT_OFFSET_MIN + 1)); break;
+    case 1:  ev->when.offset_minutes = (int16_t)rnd(1440);               break;
+    default: ev->when.offset_minutes = (int16_t)((int32_t)rnd(241) - 120); break;
+    }
+
+    if (rnd(4) == 0)
+        ev->weekdays = (uint8_t)(1 + rnd(EVENT_DAYS_ALL));
+
+    if (rnd(4) == 0) {
+        ev->from_mo = (uint8_t)(1 + rnd(12));
+        ev->from_d  = (uint8_t)(1 + rnd(month_days(2028, ev->from_mo)));
+        ev->to_mo   = (uint8_t)(1 + rnd(12));
+        ev->to_d    = (uint8_t)(1 + rnd(month_days(2028, ev->to_mo)));
+    }
+}
+
+static void random_solar(struct solar_times *s)
+{
+    uint16_t *f = &s->sunrise_std;
+
+    /* Every minute field, then the mask */
+    for (size_t i = 0; i < offsetof(struct solar_times, valid_mask) / sizeof(uint16_t); i++)
+        f[i] = (uint16_t)rnd(1440);
+
+    s->valid_mask = rnd(3) ? SOLAR_Q_ALL : (uint16_t)rnd(SOLAR_Q_ALL + 1);
+}
+
+static void random_table(void)
+{
+    uint32_t shape = rnd(4);
+    uint32_t n = (shape == 0) ? rnd(9) :
+                 (shape == 1) ? MAX_EVENTS - rnd(9) :
+                                rnd(MAX_EVENTS + 1);
+
+    if (rnd(2)) {
+        /* Console path: mutators, then holes */
+        config_events_clear();
+
+        for (uint32_t i = 0; i < n; i++) {
+            Event ev;
+            random_event(&ev);
+            CHECK(config_events_add(&ev), "add");
+        }
+
+        for (uint32_t k = rnd(n / 2 + 1); k > 0; k--)
+            (void)config_events_delete_by_refnum((refnum_t)(1 + rnd(MAX_EVENTS)));
+    } else {
+        /* Boot path: table loaded wholesale, index rebuilt lazily */
+        memset(g_cfg.events, 0, sizeof(g_cfg.events));
+
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t slot = rnd(MAX_EVENTS);
+            random_event(&g_cfg.events[slot]);
+            g_cfg.events[slot].refnum = (refnum_t)(slot + 1);
+        }
+
+        config_events_reindex();
+        schedule_touch();
+    }
+}
+
+static void random_day(struct scenario *sc)
+{
+    sc->y  = 2027 + (int)rnd(3);
+    sc->mo = 1 + (int)rnd(12);
+    sc->d  = 1 + (int)rnd((uint32_t)month_days(sc->y, sc->mo));
+
+    /* Any day boundary will do for the phase identity */
+    sc->midnight = 86400u * (uint32_t)(9000 + rnd(2000));
+
+    for (int k = 0; k < 3; k++) {
+        random_solar(&sc->sol[k]);
+        sc->have[k] = rnd(8) != 0;
+    }
+}
+
+static void scheduler_load(const struct scenario *sc)
+{
+    scheduler_init();
+    scheduler_set_coalesce(0, SCHED_COALESCE_LATE);
+
+    scheduler_update_day(sc->y, sc->mo, sc->d,
+                         sc->have[1] ? &sc->sol[1] : NULL, sc->have[1],
+                         sc->have[1] ? sc->sol[1].valid_mask : 0);
+
+    scheduler_update_neighbors(sc->have[0] ? &sc->sol[0] : NULL, sc->have[0],
+                               sc->have[2] ? &sc->sol[2] : NULL, sc->have[2]);
+}
+
+/* --------------------------------------------------------------------------
+ * Comparison
+ * -------------------------------------------------------------------------- */
+
+#define MAX_QUERIES (3 * MAX_EVENTS + 40)
+
+struct decision {
+    struct reduced_state rs;
+    bool     have_next;
+    uint16_t next;
+};
+
+static bool same_state(const struct reduced_state *a, const struct reduced_state *b)
+{
+    for (int d = 0; d < STATE_REDUCER_MAX_DEVICES; d++) {
+        if (a->has_action[d] != b->has_action[d])
+            return false;
+        if (a->has_action[d] &&
+            (a->action[d] != b->action[d] || a->when[d] != b->when[d]))
+            return false;
+    }
+
+    return true;
+}
+
+static size_t query_minutes(const struct scenario *sc, uint16_t *q)
+{
+    const Event *events = config_events_get(NULL);
+    const struct solar_times *sol = sc->have[1] ? &sc->sol[1] : NULL;
+    size_t n = 0;
+
+    q[n++] = 0;
+    q[n++] = 1439;
+
+    for (size_t i = 0; i < MAX_EVENTS && n + 3 <= MAX_QUERIES - 32; i++) {
+        uint16_t m;
+
+        if (events[i].refnum == 0 || !ref_resolve_when(&events[i].when, sol, &m))
+            continue;
+
+        q[n++] = m;
+        q[n++] = (uint16_t)((m + 1439) % 1440);
+        q[n++] = (uint16_t)((m + 1) % 1440);
+    }
+
+    for (int k = 0; k < 32; k++)
+        q[n++] = (uint16_t)rnd(1440);
+
+    return n;
+}
+
+/* Frozen functions themselves, on the unfiltered table */
+static void check_frozen(const struct scenario *sc, const uint16_t *q, size_t nq)
+{
+    const Event *events = config_events_get(NULL);
+
+    for (int k = 0; k < 4; k++) {
+        const struct solar_times *sol =
+            (k < 3 && sc->have[k]) ? &sc->sol[k] : NULL;
+
+        for (size_t i = 0; i < MAX_EVENTS; i++) {
+            uint16_t a = 0xFFFF, b = 0xFFFF;
+            bool ra = resolve_when(&events[i].when, sol, &a);
+            bool rb = ref_resolve_when(&events[i].when, sol, &b);
+
+            CHECK(ra == rb && (!ra || a == b), "resolve_when slot %zu", i);
+        }
+    }
+
+    for (size_t i = 0; i < MAX_EVENTS; i++) {
+        for (uint8_t wd = 0; wd < 7; wd++) {
+            uint8_t mo = (uint8_t)(1 + rnd(12));
+            uint8_t d  = (uint8_t)(1 + rnd(31));
+
+            CHECK(event_on_day(&events[i], wd, mo, d) ==
+                  ref_event_on_day(&events[i], wd, mo, d),
+                  "event_on_day slot %zu", i);
+        }
+    }
+
+    const struct solar_times *sol = sc->have[1] ? &sc->sol[1] : NULL;
+
+    for (size_t k = 0; k < nq; k++) {
+        struct reduced_state a, b;
+
+        state_reducer_run(events, MAX_EVENTS, sol, q[k], sc->midnight, &a);
+        ref_state_reducer_run(events, MAX_EVENTS, sol, q[k], sc->midnight, &b);
+        CHECK(same_state(&a, &b), "state_reducer_run minute %u", q[k]);
+
+        size_t ia = 0, ib = 0;
+        uint16_t ma = 0, mb = 0;
+        bool ta = false, tb = false;
+
+        bool fa = next_event_today(events, 0, sol, q[k], &ia, &ma, &ta);
+        bool fb = ref_next_event_today(events, 0, sol, q[k], &ib, &mb, &tb);
+
+        CHECK(fa == fb && (!fa || (ia == ib && ma == mb && ta == tb)),
+              "next_event_today minute %u", q[k]);
+    }
+}
+
+static double s_ref_sec, s_fast_sec;
+static long   s_decisions;
+
+/* Scheduler fast path vs composites, timed */
+static void check_fast(const struct scenario *sc, const uint16_t *q, size_t nq,
+                       const char *phase)
+{
+    static struct decision ref[MAX_QUERIES];
+    static struct decision fast[MAX_QUERIES];
+
+    const Event *events = config_events_get(NULL);
+    const struct solar_times *sp = sc->have[0] ? &sc->sol[0] : NULL;
+    const struct solar_times *st = sc->have[1] ? &sc->sol[1] : NULL;
+    const struct solar_times *sn = sc->have[2] ? &sc->sol[2] : NULL;
+
+    double t0 = now_sec();
+
+    for (size_t k = 0; k < nq; k++) {
+        ref_reduce_day(events, sc->y, sc->mo, sc->d, sp, st,
+                       q[k], sc->midnight, &ref[k].rs);
+        ref[k].have_next = ref_next_event_minute(events, sc->y, sc->mo, sc->d,
+                                                 st, sn, q[k], &ref[k].next);
+    }
+
+    double t1 = now_sec();
+
+    for (size_t k = 0; k < nq; k++) {
+        const uint8_t *start = NULL;
+        const struct ResolvedEvent *by_dev = scheduler_timeline_by_device(&start);
+
+        state_reducer_run_indexed(by_dev, start, scheduler_carry_over(),
+                                  SCHED_DIRTY_ALL, q[k], sc->midnight,
+                                  &fast[k].rs);
+        fast[k].have_next = scheduler_next_event_minute(q[k], &fast[k].next, NULL);
+    }
+
+    double t2 = now_sec();
+
+    s_ref_sec   += t1 - t0;
+    s_fast_sec  += t2 - t1;
+    s_decisions += (long)nq;
+
+    for (size_t k = 0; k < nq; k++) {
+        CHECK(same_state(&ref[k].rs, &fast[k].rs),
+              "%s: reduce %04d-%02d-%02d minute %u", phase,
+              sc->y, sc->mo, sc->d, q[k]);
+
+        CHECK(ref[k].have_next == fast[k].have_next &&
+              (!ref[k].have_next || ref[k].next == fast[k].next),
+              "%s: next event %04d-%02d-%02d minute %u: %d/%u vs %d/%u", phase,
+              sc->y, sc->mo, sc->d, q[k],
+              ref[k].have_next, ref[k].next, fast[k].have_next, fast[k].next);
+
+        uint16_t w = 0;
+        bool hw = scheduler_next_wake_minute(q[k], &w, NULL);
+
+        CHECK(hw == fast[k].have_next && (!hw || w == fast[k].next),
+              "%s: next wake (no coalescing) minute %u", phase, q[k]);
+    }
+}
+
+/* One edit without a date change: the caches must follow */
+static void random_edit(void)
+{
+    size_t used = 0;
+    const Event *events = config_events_get(&used);
+
+    if (used == 0 || rnd(3) == 0) {
+        Event ev;
+        random_event(&ev);
+        (void)config_events_add(&ev);
+        return;
+    }
+
+    /* Pick a used slot */
+    size_t slot = rnd(MAX_EVENTS);
+    while (events[slot].refnum == 0)
+        slot = (slot + 1) % MAX_EVENTS;
+
+    if (rnd(2)) {
+        (void)config_events_delete_by_refnum(events[slot].refnum);
+    } else {
+        Event ev;
+        random_event(&ev);
+        CHECK(config_events_update_by_refnum(events[slot].refnum, &ev), "update");
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    uint32_t seed = 20261016u;
+    long scenarios = 3000;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "seed=", 5) == 0)
+            seed = (uint32_t)strtoul(argv[i] + 5, NULL, 0);
+        else if (strncmp(argv[i], "scenarios=", 10) == 0)
+            scenarios = strtol(argv[i] + 10, NULL, 0);
+        else {
+            printf("usage: sched_fuzz [seed=N] [scenarios=N]\n");
+            return 2;
+        }
+    }
+
+    s_rng = seed ? seed : 1u;
+
+    printf("scheduler differential fuzz: seed %lu, %ld scenarios\n",
+           (unsigned long)seed, scenarios);
+
+    static uint16_t q[MAX_QUERIES];
+    long used_total = 0;
+
+    for (long s = 0; s < scenarios; s++) {
+        struct scenario sc;
+
+        random_table();
+        random_day(&sc);
+        scheduler_load(&sc);
+
+        size_t used = 0;
+        (void)config_events_get(&used);
+        used_total += (long)used;
+
+        size_t nq = query_minutes(&sc, q);
+
+        check_frozen(&sc, q, nq);
+        check_fast(&sc, q, nq, "fresh");
+
+        random_edit();
+
+        nq = query_minutes(&sc, q);
+        check_fast(&sc, q, nq, "after edit");
+
+        if (fails >= 20) {
+            printf("  stopping at scenario %ld (reproduce: seed=%lu scenarios=%ld)\n",
+                   s, (unsigned long)seed, s + 1);
+            break;
+        }
+    }
+
+    printf("  %ld decisions, %.1f events per table on average\n",
+           s_decisions, scenarios ? (double)used_total / scenarios : 0.0);
+    printf("  reference  %10.0f decisions/s\n", s_decisions / s_ref_sec);
+    printf("  scheduler  %10.0f decisions/s (%.1fx, compile included)\n",
+           s_decisions / s_fast_sec, s_ref_sec / s_fast_sec);
+
+    printf("\n%s\n", fails ? "FAIL" : "PASS");
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,399 @@
+/*
+ * sched_reference.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Frozen reference scheduling path for differential tests
+ *
+ * Notes:
+ *  - See sched_reference.h. Everything above "Composites" is copied
+ *    from resolve_when.cpp, state_reducer.cpp and next_event.cpp and
+ *    must stay as it is
+ *  - The calendar helpers are local so the reference does not move
+ *    with time_dst.cpp either
+ *
+ * Updated: 2026-10-16
+ */
+
+#include "sched_reference.h"
+#include "config_events.h"   /* MAX_EVENTS */
+
+#include <string.h>
+
+/* --------------------------------------------------------------------------
+ * resolve_when.cpp
+ * -------------------------------------------------------------------------- */
+
+static inline bool sol_has(const struct solar_times *sol, uint16_t q)
+{
+    return sol && (sol->valid_mask & q);
+}
+
+bool ref_resolve_when(const struct When* when,
+                      const struct solar_times* sol,
+                      uint16_t* out_minute)
+{
+    if (!when || !out_minute)
+        return false;
+
+    int32_t base;
+
+    switch (when->ref) {
+
+    case REF_NONE:
+        return false;
+
+    case REF_MIDNIGHT:
+        base = 0;
+        break;
+
+    case REF_SOLAR_STD_RISE:
+        if (!sol_has(sol, SOLAR_Q_STD_RISE)) return false;
+        base = sol->sunrise_std;
+        break;
+
+    case REF_SOLAR_STD_SET:
+        if (!sol_has(sol, SOLAR_Q_STD_SET)) return false;
+        base = sol->sunset_std;
+        break;
+
+    case REF_SOLAR_CIV_RISE:
+        if (!sol_has(sol, SOLAR_Q_CIV_RISE)) return false;
+        base = sol->sunrise_civ;
+        break;
+
+    case REF_SOLAR_CIV_SET:
+        if (!sol_has(sol, SOLAR_Q_CIV_SET)) return false;
+        base = sol->sunset_civ;
+        break;
+
+    case REF_SOLAR_NAUT_RISE:
+        if (!sol_has(sol, SOLAR_Q_NAUT_RISE)) return false;
+        base = sol->sunrise_naut;
+        break;
+
+    case REF_SOLAR_NAUT_SET:
+        if (!sol_has(sol, SOLAR_Q_NAUT_SET)) return false;
+        base = sol->sunset_naut;
+        break;
+
+    case REF_SOLAR_ASTRO_RISE:
+        if (!sol_has(sol, SOLAR_Q_ASTRO_RISE)) return false;
+        base = sol->sunrise_astro;
+        break;
+
+    case REF_SOLAR_ASTRO_SET:
+        if (!sol_has(sol, SOLAR_Q_ASTRO_SET)) return false;
+        base = sol->sunset_astro;
+        break;
+
+    case REF_SOLAR_NOON:
+        if (!sol_has(sol, SOLAR_Q_NOON)) return false;
+        base = sol->noon;
+        break;
+
+    default:
+        return false;
+    }
+
+    int32_t t = base + when->offset_minutes;
+
+    /* Normalize to 0–1439 UTC (modular day) */
+    t %= 1440;
+    if (t < 0)
+        t += 1440;
+
+    *out_minute = (uint16_t)t;
+    return true;
+}
+
+bool ref_event_on_day(const struct Event *ev,
+                      uint8_t weekday, uint8_t month, uint8_t day)
+{
+    if (!ev || weekday > 6)
+        return false;
+
+    if (ev->weekdays && !(ev->weekdays & (1u << weekday)))
+        return false;
+
+    if (ev->from_mo == 0)
+        return true;
+
+    /* Compare as month * 32 + day: order-preserving, no calendar math */
+    uint16_t md   = (uint16_t)(month * 32u + day);
+    uint16_t from = (uint16_t)(ev->from_mo * 32u + ev->from_d);
+    uint16_t to   = (uint16_t)(ev->to_mo * 32u + ev->to_d);
+
+    if (from <= to)
+        return md >= from && md <= to;
+
+    /* Wraps the year end */
+    return md >= from || md <= to;
+}
+
+/* --------------------------------------------------------------------------
+ * state_reducer.cpp
+ * -------------------------------------------------------------------------- */
+
+void ref_state_reducer_run(const Event *events,
+                           size_t table_size,
+                           const struct solar_times *sol,
+                           uint16_t now_minute,
+                           uint32_t today_epoch_midnight,
+                           struct reduced_state *out)
+{
+    if (!events || !out)
+        return;
+
+    /* Clear output */
+    memset(out, 0, sizeof(*out));
+
+    uint16_t best_minute[STATE_REDUCER_MAX_DEVICES];
+    bool     have_minute[STATE_REDUCER_MAX_DEVICES];
+
+    memset(have_minute, 0, sizeof(have_minute));
+
+    for (size_t i = 0; i < table_size; i++) {
+        const Event *ev = &events[i];
+
+        /* Skip unused slots */
+        if (ev->refnum == 0)
+            continue;
+
+        if (ev->device_id >= STATE_REDUCER_MAX_DEVICES)
+            continue;
+
+        uint16_t minute;
+        if (!ref_resolve_when(&ev->when, sol, &minute))
+            continue;
+
+        /* Ignore future intent */
+        if (minute > now_minute)
+            continue;
+
+        /* Latest event <= now wins */
+        if (!have_minute[ev->device_id] ||
+            minute >= best_minute[ev->device_id]) {
+
+            best_minute[ev->device_id] = minute;
+            out->action[ev->device_id] = ev->action;
+            out->has_action[ev->device_id] = true;
+
+            out->when[ev->device_id] =
+                today_epoch_midnight + ((uint32_t)minute * 60u);
+
+            have_minute[ev->device_id] = true;
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * next_event.cpp
+ * -------------------------------------------------------------------------- */
+
+bool ref_next_event_today(const Event *events,
+                          size_t count,
+                          const struct solar_times *sol,
+                          uint16_t now_minute,
+                          size_t *out_index,
+                          uint16_t *out_minute,
+                          bool *out_tomorrow)
+{
+    (void)count; /* informational only */
+
+    if (!events || !out_index || !out_minute || !out_tomorrow)
+        return false;
+
+    bool found = false;
+    uint16_t best_minute = 0;
+    size_t best_index = 0;
+
+    /* ------------------------------------------------------------
+     * First pass: today (strictly after now)
+     * ------------------------------------------------------------ */
+    for (size_t i = 0; i < MAX_EVENTS; i++) {
+        if (events[i].refnum == 0)
+            continue;
+
+        uint16_t minute;
+        if (!ref_resolve_when(&events[i].when, sol, &minute))
+            continue;
+
+        if (minute <= now_minute)
+            continue;
+
+        if (!found || minute < best_minute ||
+            (minute == best_minute && i < best_index)) {
+            found = true;
+            best_minute = minute;
+            best_index = i;
+        }
+    }
+
+    if (found) {
+        *out_index = best_index;
+        *out_minute = best_minute;
+        *out_tomorrow = false;
+        return true;
+    }
+
+    /* ------------------------------------------------------------
+     * Second pass: tomorrow (wrap to earliest valid event)
+     * ------------------------------------------------------------ */
+    found = false;
+    best_minute = 0;
+    best_index = 0;
+
+    for (size_t i = 0; i < MAX_EVENTS; i++) {
+        if (events[i].refnum == 0)
+            continue;
+
+        uint16_t minute;
+        if (!ref_resolve_when(&events[i].when, sol, &minute))
+            continue;
+
+        if (!found || minute < best_minute ||
+            (minute == best_minute && i < best_index)) {
+            found = true;
+            best_minute = minute;
+            best_index = i;
+        }
+    }
+
+    if (!found)
+        return false;
+
+    *out_index = best_index;
+    *out_minute = best_minute;
+    *out_tomorrow = true;
+    return true;
+}
+
+/* --------------------------------------------------------------------------
+ * Composites
+ * -------------------------------------------------------------------------- */
+
+static bool leap(int y)
+{
+    return (y % 4 == 0 && y % 100 != 0) || (y % 400 == 0);
+}
+
+static int month_days(int y, int m)
+{
+    static const int md[12] = { 31,28,31,30,31,30,31,31,30,31,30,31 };
+    return (m == 2 && leap(y)) ? 29 : md[m - 1];
+}
+
+/* Sakamoto: 0 = Sunday */
+static int weekday(int y, int m, int d)
+{
+    static const int t[12] = { 0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4 };
+
+    if (m < 3)
+        y -= 1;
+
+    return (y + y / 4 - y / 100 + y / 400 + t[m - 1] + d) % 7;
+}
+
+static void step_day(int *y, int *m, int *d, int delta)
+{
+    *d += delta;
+
+    if (*d < 1) {
+        if (--*m < 1) { *m = 12; --*y; }
+        *d = month_days(*y, *m);
+    } else if (*d > month_days(*y, *m)) {
+        *d = 1;
+        if (++*m > 12) { *m = 1; ++*y; }
+    }
+}
+
+void ref_day_filter(const Event *events, int y, int mo, int d, Event *out)
+{
+    bool known = (mo >= 1 && mo <= 12);
+
+    for (size_t i = 0; i < MAX_EVENTS; i++) {
+        out[i] = events[i];
+
+        if (out[i].refnum == 0)
+            continue;
+
+        bool on = known
+            ? ref_event_on_day(&out[i], (uint8_t)weekday(y, mo, d),
+                               (uint8_t)mo, (uint8_t)d)
+            : (out[i].weekdays == 0 && out[i].from_mo == 0);
+
+        if (!on)
+            out[i].refnum = 0;
+    }
+}
+
+void ref_reduce_day(const Event *events,
+                    int y, int mo, int d,
+                    const struct solar_times *sol_prev,
+                    const struct solar_times *sol,
+                    uint16_t now_minute,
+                    uint32_t today_epoch_midnight,
+                    struct reduced_state *out)
+{
+    static Event today[MAX_EVENTS];
+    static Event prev[MAX_EVENTS];
+
+    int py = y, pmo = mo, pd = d;
+    if (mo >= 1 && mo <= 12)
+        step_day(&py, &pmo, &pd, -1);
+
+    ref_day_filter(events, y, mo, d, today);
+    ref_day_filter(events, py, pmo, pd, prev);
+
+    ref_state_reducer_run(today, MAX_EVENTS, sol, now_minute,
+                          today_epoch_midnight, out);
+
+    /* Yesterday's last event governs devices with none yet today */
+    struct reduced_state carry;
+    ref_state_reducer_run(prev, MAX_EVENTS, sol_prev, 1439,
+                          today_epoch_midnight - 86400u, &carry);
+
+    for (int id = 0; id < STATE_REDUCER_MAX_DEVICES; id++) {
+        if (!out->has_action[id] && carry.has_action[id]) {
+            out->has_action[id] = true;
+            out->action[id]     = carry.action[id];
+            out->when[id]       = carry.when[id];
+        }
+    }
+}
+
+bool ref_next_event_minute(const Event *events,
+                           int y, int mo, int d,
+                           const struct solar_times *sol,
+                           const struct solar_times *sol_next,
+                           uint16_t now_minute,
+                           uint16_t *out_minute)
+{
+    static Event today[MAX_EVENTS];
+    static Event next[MAX_EVENTS];
+
+    int ny = y, nmo = mo, nd = d;
+    if (mo >= 1 && mo <= 12)
+        step_day(&ny, &nmo, &nd, +1);
+
+    ref_day_filter(events, y, mo, d, today);
+    ref_day_filter(events, ny, nmo, nd, next);
+
+    size_t idx;
+    uint16_t minute;
+    bool tomorrow;
+
+    if (ref_next_event_today(today, 0, sol, now_minute,
+                             &idx, &minute, &tomorrow) && !tomorrow) {
+        *out_minute = minute;
+        return true;
+    }
+
+    /* Nothing left today: tomorrow's earliest, with tomorrow's solar */
+    if (!ref_next_event_today(next, 0, sol_next, 1439,
+                              &idx, &minute, &tomorrow))
+        return false;
+
+    *out_minute = minute;
+    return true;
+}
@@ -0,0 +1,86 @@
+/*
+ * sched_reference.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Frozen reference scheduling path for differential tests
+ *
+ * Notes:
+ *  - Host only, never linked into firmware
+ *  - Verbatim copies of resolve_when(), event_on_day(),
+ *    state_reducer_run() and next_event_today() as of the compiled
+ *    timeline work (2026-10-16), renamed ref_*. They are the contract:
+ *    do not "fix" or speed them up here; change the firmware and let
+ *    sched_fuzz show the difference
+ *  - ref_day_filter() and the two composites below restate, with
+ *    full-table scans only, what the scheduler answers from its
+ *    compiled timeline (calendar qualifiers, carry-over, wrap)
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "events.h"
+#include "solar.h"
+#include "state_reducer.h"
+
+/* ---- frozen copies ------------------------------------------------------ */
+
+bool ref_resolve_when(const struct When *when,
+                      const struct solar_times *sol,
+                      uint16_t *out_minute);
+
+bool ref_event_on_day(const struct Event *ev,
+                      uint8_t weekday, uint8_t month, uint8_t day);
+
+void ref_state_reducer_run(const Event *events,
+                           size_t table_size,
+                           const struct solar_times *sol,
+                           uint16_t now_minute,
+                           uint32_t today_epoch_midnight,
+                           struct reduced_state *out);
+
+bool ref_next_event_today(const Event *events,
+                          size_t count,
+                          const struct solar_times *sol,
+                          uint16_t now_minute,
+                          size_t *out_index,
+                          uint16_t *out_minute,
+                          bool *out_tomorrow);
+
+/* ---- composites --------------------------------------------------------- */
+
+/*
+ * Copy of events[0..MAX_EVENTS) with every slot that does not run on
+ * (y, mo, d) marked unused. mo == 0 (date unknown): only unqualified
+ * events run.
+ */
+void ref_day_filter(const Event *events, int y, int mo, int d, Event *out);
+
+/*
+ * Governing event per device at now_minute, yesterday's last event
+ * filling in for devices with none yet today
+ * (scheduler_timeline_by_device() + scheduler_carry_over() +
+ * state_reducer_run_indexed()).
+ */
+void ref_reduce_day(const Event *events,
+                    int y, int mo, int d,
+                    const struct solar_times *sol_prev,
+                    const struct solar_times *sol,
+                    uint16_t now_minute,
+                    uint32_t today_epoch_midnight,
+                    struct reduced_state *out);
+
+/*
+ * Next event minute strictly after now_minute today, else tomorrow's
+ * first resolved with tomorrow's solar (scheduler_next_event_minute()).
+ */
+bool ref_next_event_minute(const Event *events,
+                           int y, int mo, int d,
+                           const struct solar_times *sol,
+                           const struct solar_times *sol_next,
+                           uint16_t now_minute,
+                           uint16_t *out_minute);
@@ -0,0 +1,308 @@
+/*
+ * coop_sim.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Run the real firmware over simulated months on the host
+ *
+ * Notes:
+ *  - HOST ONLY (native g++), hardware in sim_hw.cpp
+ *  - main_firmware.cpp and all of src/ and platform/ (except the I2C,
+ *    UART and Timer0 drivers) are the firmware sources, unchanged
+ *  - The installation is written to EEPROM the way the console 'save'
+ *    leaves it (config image + solar cache), then the MCU powers on at
+ *    00:00:00 UTC of the start date with the RTC set and the config
+ *    strap in RUN (console=MIN leaves it open that long after power-on)
+ *  - Arguments are key=value (see usage()); currents are a per-state
+ *    model: sleep is the whole board asleep, idle is the CPU in
+ *    SLEEP_MODE_IDLE, the others add to awake
+ *
+ * Updated: 2026-10-16
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim_hw.h"
+
+#include "config.h"
+#include "events.h"
+#include "solar_table.h"
+#include "solar_fit.h"
+#include "solar_baked.h"
+#include "wake_stats.h"
+#include "energy_stats.h"
+
+/* --------------------------------------------------------------------------
+ * Parameters
+ * -------------------------------------------------------------------------- */
+
+struct sim_params {
+    int      y, mo, d;          /* start date (UTC) */
+    uint32_t days;
+
+    double   lat, lon;
+    uint8_t  coalesce;
+    uint8_t  early;
+
+    struct sim_timing timing;
+
+    uint32_t console_min;       /* config strap open after power-on */
+
+    /* Current model */
+    double   sleep_ua;
+    double   idle_ma;
+    double   awake_ma;
+    double   motor_ma;
+    double   lock_ma;
+    double   relay_ma;
+    double   led_ma;
+    double   battery_mah;
+
+    const char *log;
+};
+
+static void usage(void)
+{
+    printf("usage: coop_sim [key=value ...]\n"
+           "  start=YYYY-MM-DD days=N          run window (UTC)\n"
+           "  lat=DEG lon=DEG                  site\n"
+           "  coalesce=MIN early=0|1           wake coalescing\n"
+           "  loop_us=N i2c_byte_us=N          awake cost model\n"
+           "  console=MIN                      strap open after power-on\n"
+           "  sleep_ua= idle_ma= awake_ma= motor_ma= lock_ma= relay_ma= led_ma=\n"
+           "  battery_mah=N                    usable capacity\n"
+           "  log=FILE|-                       device transitions\n");
+}
+
+static bool parse_arg(struct sim_params *p, const char *arg)
+{
+    const char *eq = strchr(arg, '=');
+    if (!eq)
+        return false;
+
+    size_t klen = (size_t)(eq - arg);
+    const char *v = eq + 1;
+
+#define KEY(k) (klen == sizeof(k) - 1 && strncmp(arg, k, klen) == 0)
+
+    if (KEY("start"))
+        return sscanf(v, "%d-%d-%d", &p->y, &p->mo, &p->d) == 3;
+    if (KEY("days"))        { p->days = (uint32_t)strtoul(v, NULL, 10); return p->days > 0; }
+    if (KEY("lat"))         { p->lat = atof(v); return true; }
+    if (KEY("lon"))         { p->lon = atof(v); return true; }
+    if (KEY("coalesce"))    { p->coalesce = (uint8_t)atoi(v); return true; }
+    if (KEY("early"))       { p->early = (uint8_t)(atoi(v) != 0); return true; }
+    if (KEY("loop_us"))     { p->timing.loop_us = (uint32_t)strtoul(v, NULL, 10); return true; }
+    if (KEY("i2c_byte_us")) { p->timing.i2c_byte_us = (uint32_t)strtoul(v, NULL, 10); return true; }
+    if (KEY("console"))     { p->console_min = (uint32_t)strtoul(v, NULL, 10); return true; }
+    if (KEY("sleep_ua"))    { p->sleep_ua = atof(v); return true; }
+    if (KEY("idle_ma"))     { p->idle_ma = atof(v); return true; }
+    if (KEY("awake_ma"))    { p->awake_ma = atof(v); return true; }
+    if (KEY("motor_ma"))    { p->motor_ma = atof(v); return true; }
+    if (KEY("lock_ma"))     { p->lock_ma = atof(v); return true; }
+    if (KEY("relay_ma"))    { p->relay_ma = atof(v); return true; }
+    if (KEY("led_ma"))      { p->led_ma = atof(v); return true; }
+    if (KEY("battery_mah")) { p->battery_mah = atof(v); return true; }
+    if (KEY("log"))         { p->log = v; return true; }
+
+#undef KEY
+
+    return false;
+}
+
+/* --------------------------------------------------------------------------
+ * Installation
+ * -------------------------------------------------------------------------- */
+
+static void add_event(struct config *cfg, uint8_t *n,
+                      uint8_t device_id, enum Action action,
+                      enum TimeRef ref, int16_t offset)
+{
+    Event *ev = &cfg->events[*n];
+
+    memset(ev, 0, sizeof(*ev));
+    ev->device_id           = device_id;
+    ev->action              = action;
+    ev->when.ref            = ref;
+    ev->when.offset_minutes = offset;
+    ev->refnum              = (refnum_t)(*n + 1);
+
+    (*n)++;
+}
+
+/*
+ * Typical coop: door opens at civil dawn and closes 15 minutes after
+ * civil dusk; relay1 runs a coop light for three hours from sunset.
+ */
+static void install(const struct sim_params *p)
+{
+    static struct config cfg;
+    uint8_t n = 0;
+
+    config_defaults(&cfg);
+
+    cfg.latitude_e4      = (int32_t)(p->lat * 10000.0 + (p->lat < 0 ? -0.5 : 0.5));
+    cfg.longitude_e4     = (int32_t)(p->lon * 10000.0 + (p->lon < 0 ? -0.5 : 0.5));
+    cfg.coalesce_minutes = p->coalesce;
+    cfg.coalesce_early   = p->early;
+
+    add_event(&cfg, &n, 1, ACTION_ON,  REF_SOLAR_CIV_RISE, 0);
+    add_event(&cfg, &n, 1, ACTION_OFF, REF_SOLAR_CIV_SET,  15);
+    add_event(&cfg, &n, 4, ACTION_ON,  REF_SOLAR_STD_SET,  0);
+    add_event(&cfg, &n, 4, ACTION_OFF, REF_SOLAR_STD_SET,  180);
+
+    config_save(&cfg);
+
+    /* What 'save' builds for a new location */
+#if defined(SOLAR_MODEL_FIT)
+    if (!solar_baked_valid_for(cfg.latitude_e4, cfg.longitude_e4))
+        (void)solar_fit_build(cfg.latitude_e4, cfg.longitude_e4);
+#else
+    if (!solar_baked_valid_for(cfg.latitude_e4, cfg.longitude_e4))
+        solar_table_build(cfg.latitude_e4, cfg.longitude_e4);
+#endif
+
+    printf("site %.4f %.4f, %u events, coalesce %u min (%s)\n",
+           p->lat, p->lon, (unsigned)n, (unsigned)p->coalesce,
+           p->early ? "early" : "late");
+}
+
+/* --------------------------------------------------------------------------
+ * Report
+ * -------------------------------------------------------------------------- */
+
+/* mA x microseconds -> mAh */
+static double mah(double ma, uint64_t us)
+{
+    return ma * (double)us / 3.6e9;
+}
+
+static void report(const struct sim_params *p, const struct sim_stats *s)
+{
+    double days = (double)p->days;
+
+    struct row { const char *name; uint64_t us; double ma; } rows[] = {
+        { "sleep",      s->sleep_us, p->sleep_ua / 1000.0 },
+        { "idle",       s->idle_us,  p->idle_ma  },
+        { "awake",      s->awake_us, p->awake_ma },
+        { "door motor", s->motor_us, p->motor_ma },
+        { "lock",       s->lock_us,  p->lock_ma  },
+        { "relay coil", s->relay_us, p->relay_ma },
+        { "led",        s->led_us,   p->led_ma   },
+    };
+
+    printf("\n%-12s %14s %10s %12s\n", "state", "ms/day", "mA", "mAh/day");
+
+    double total = 0.0;
+
+    for (unsigned i = 0; i < sizeof(rows) / sizeof(rows[0]); i++) {
+        double per_day = mah(rows[i].ma, rows[i].us) / days;
+        total += per_day;
+
+        printf("%-12s %14.1f %10.3f %12.4f\n", rows[i].name,
+               (double)rows[i].us / 1000.0 / days, rows[i].ma, per_day);
+    }
+
+    printf("%-12s %14s %10s %12.4f\n", "total", "", "", total);
+
+    printf("\nwakes/day      %.2f (rtc %u, other %u, skipped sleeps %u)\n",
+           (s->wakes_rtc + s->wakes_other) / days,
+           (unsigned)s->wakes_rtc, (unsigned)s->wakes_other,
+           (unsigned)s->sleep_skips);
+    printf("fw wake count  %lu\n", (unsigned long)wake_stats_total());
+    printf("awake ms/wake  %.1f\n",
+           (s->wakes_rtc + s->wakes_other)
+               ? (double)s->awake_us / 1000.0 / (s->wakes_rtc + s->wakes_other)
+               : 0.0);
+    printf("loop passes    %.0f/day\n", (double)s->loop_passes / days);
+    printf("console        %.1f min\n", (double)s->console_us / 60e6);
+    printf("motor runs     %u (%.1f ms each)\n", (unsigned)s->motor_runs,
+           s->motor_runs ? (double)s->motor_us / 1000.0 / s->motor_runs : 0.0);
+    printf("lock pulses    %u\n", (unsigned)s->lock_pulses);
+    printf("relay pulses   %u\n", (unsigned)s->relay_pulses);
+    printf("transitions    %u\n", (unsigned)s->transitions);
+    printf("i2c transfers  %u\n", (unsigned)s->i2c_xfers);
+    printf("eeprom writes  %u bytes\n", (unsigned)s->eeprom_writes);
+    printf("uart tx        %u bytes\n", (unsigned)s->uart_tx);
+
+    printf("\nbattery        %.0f mAh -> %.0f days\n", p->battery_mah,
+           total > 0.0 ? p->battery_mah / total : 0.0);
+
+    /* The firmware's own counters ('energy'), last full UTC day */
+    const struct energy_day *fw = energy_yesterday();
+    uint32_t fw_sum = 0;
+
+    printf("\nfirmware energy, last full day (ms)\n");
+    for (uint8_t i = 0; i < ENERGY_STATE_COUNT; i++) {
+        printf("  %-8s %10lu\n", energy_state_name(i), (unsigned long)fw->ms[i]);
+        if (i <= ENERGY_ACTIVE)
+            fw_sum += fw->ms[i];
+    }
+    printf("  cpu total %9lu (day %lu)\n", (unsigned long)fw_sum, 86400000ul);
+    printf("  %.4f mAh at the firmware's default currents\n",
+           energy_day_uah(fw, g_cfg.energy_ua) / 1000.0);
+}
+
+/* --------------------------------------------------------------------------
+ * main
+ * -------------------------------------------------------------------------- */
+
+int main(int argc, char **argv)
+{
+    struct sim_params p;
+
+    memset(&p, 0, sizeof(p));
+    p.y = 2027; p.mo = 1; p.d = 1;
+    p.days = 365;
+    p.lat  = 42.5;
+    p.lon  = -83.0;
+
+    p.timing.loop_us     = 200;
+    p.timing.i2c_byte_us = 90;
+
+    p.sleep_ua    = 30.0;
+    p.idle_ma     = 1.2;
+    p.awake_ma    = 4.0;
+    p.motor_ma    = 900.0;
+    p.lock_ma     = 600.0;
+    p.relay_ma    = 75.0;
+    p.led_ma      = 8.0;
+    p.battery_mah = 7000.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!parse_arg(&p, argv[i])) {
+            printf("bad argument: %s\n", argv[i]);
+            usage();
+            return 2;
+        }
+    }
+
+    FILE *log = NULL;
+
+    if (p.log) {
+        log = strcmp(p.log, "-") == 0 ? stdout : fopen(p.log, "w");
+        if (!log) {
+            perror(p.log);
+            return 2;
+        }
+    }
+
+    install(&p);
+
+    uint64_t start = sim_days_from_civil(p.y, p.mo, p.d) * 86400u;
+
+    printf("simulating %u days from %04d-%02d-%02d\n",
+           (unsigned)p.days, p.y, p.mo, p.d);
+
+    sim_set_log(log);
+    sim_set_console(p.console_min * 60u);
+    sim_begin(start, start + (uint64_t)p.days * 86400u, &p.timing);
+    sim_run();
+
+    if (log && log != stdout)
+        fclose(log);
+
+    report(&p, sim_get_stats());
+    return 0;
+}
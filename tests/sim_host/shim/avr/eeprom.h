@@ -0,0 +1,26 @@
+/*
+ * avr/eeprom.h (host simulator shim)
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: EEMEM objects live in host RAM and act as the EEPROM cells
+ *
+ * Notes:
+ *  - HOST ONLY (tests/sim_host)
+ *  - update_* only writes bytes that differ and counts them, so the
+ *    report shows real EEPROM wear
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#define EEMEM
+
+void     eeprom_read_block(void *dst, const void *src, size_t n);
+void     eeprom_update_block(const void *src, void *dst, size_t n);
+uint8_t  eeprom_read_byte(const uint8_t *p);
+void     eeprom_update_byte(uint8_t *p, uint8_t v);
+uint16_t eeprom_read_word(const uint16_t *p);
+void     eeprom_update_word(uint16_t *p, uint16_t v);
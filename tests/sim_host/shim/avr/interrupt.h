@@ -0,0 +1,24 @@
+/*
+ * avr/interrupt.h (host simulator shim)
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: ISRs as plain functions, global enable as a simulator flag
+ *
+ * Notes:
+ *  - HOST ONLY (tests/sim_host)
+ *  - The simulator calls INT0_vect / INT1_vect while the global flag
+ *    is set and the line is low with its EIMSK bit enabled
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <avr/io.h>
+
+void sim_sei(void);
+void sim_cli(void);
+
+#define ISR(v) extern "C" void v(void); void v(void)
+
+static inline void sei(void) { sim_sei(); }
+static inline void cli(void) { sim_cli(); }
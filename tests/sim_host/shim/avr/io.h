@@ -0,0 +1,60 @@
+/*
+ * avr/io.h (host simulator shim)
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: ATmega1284P registers as plain host variables
+ *
+ * Notes:
+ *  - HOST ONLY (tests/sim_host)
+ *  - Only the registers and bit names the firmware touches
+ *  - Ports are sampled by the simulator whenever simulated time
+ *    advances (sim_hw.cpp); PIND carries the RTC INT and door lines
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stdint.h>
+
+extern volatile uint8_t DDRA, DDRB, DDRC, DDRD;
+extern volatile uint8_t PORTA, PORTB, PORTC, PORTD;
+extern volatile uint8_t PINA, PINB, PINC, PIND;
+
+extern volatile uint8_t EICRA, EIFR, EIMSK;
+extern volatile uint8_t MCUCR, MCUSR, SREG, SMCR;
+
+/* Port bits */
+#define PA0 0
+#define PA1 1
+#define PA2 2
+#define PA3 3
+#define PA4 4
+#define PA5 5
+#define PA6 6
+#define PA7 7
+#define PC6 6
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+
+/* MCUSR / MCUCR */
+#define PORF  0
+#define EXTRF 1
+#define BORF  2
+#define WDRF  3
+#define JTD   7
+
+/* External interrupts */
+#define INT0  0
+#define INT1  1
+#define INTF0 0
+#define INTF1 1
+#define ISC00 0
+#define ISC01 1
+#define ISC10 2
+#define ISC11 3
+
+#define _BV(b) (1u << (b))
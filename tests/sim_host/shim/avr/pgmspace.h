@@ -0,0 +1,26 @@
+/*
+ * avr/pgmspace.h (host simulator shim)
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Flash data is ordinary host memory
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stdint.h>
+#include <avr/io.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P            const char *
+#define PSTR(s)          (s)
+
+#define pgm_read_byte(p)  (*(const uint8_t  *)(p))
+#define pgm_read_word(p)  (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+
+#define memcpy_P   memcpy
+#define strcpy_P   strcpy
+#define strlen_P   strlen
+#define strcmp_P   strcmp
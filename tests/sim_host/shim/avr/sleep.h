@@ -0,0 +1,29 @@
+/*
+ * avr/sleep.h (host simulator shim)
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: sleep_cpu() fast-forwards simulated time
+ *
+ * Notes:
+ *  - HOST ONLY (tests/sim_host)
+ *  - PWR_DOWN jumps to the next RTC alarm match (or the end of the
+ *    run); other modes sleep until the next 1 ms timer tick
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stdint.h>
+#include <avr/io.h>
+
+#define SLEEP_MODE_IDLE     0
+#define SLEEP_MODE_PWR_DOWN 4
+#define SLEEP_MODE_PWR_SAVE 6
+
+void sim_set_sleep_mode(uint8_t mode);
+void sim_sleep_cpu(void);
+
+static inline void set_sleep_mode(uint8_t mode) { sim_set_sleep_mode(mode); }
+static inline void sleep_enable(void)  {}
+static inline void sleep_disable(void) {}
+static inline void sleep_cpu(void)     { sim_sleep_cpu(); }
@@ -0,0 +1,12 @@
+/*
+ * avr/wdt.h (host simulator shim)
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Watchdog is not simulated
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+
+static inline void wdt_disable(void) {}
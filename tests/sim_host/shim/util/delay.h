@@ -0,0 +1,17 @@
+/*
+ * util/delay.h (host simulator shim)
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Busy-wait delays advance simulated (awake) time
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stdint.h>
+#include <avr/io.h>
+
+void sim_delay_us(uint32_t us);
+
+static inline void _delay_ms(double ms) { sim_delay_us((uint32_t)(ms * 1000.0)); }
+static inline void _delay_us(double us) { sim_delay_us((uint32_t)us); }
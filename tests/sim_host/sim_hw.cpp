@@ -0,0 +1,671 @@
+/*
+ * sim_hw.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Simulated ATmega1284P + DS3231 for the host firmware run
+ *
+ * Notes:
+ *  - HOST ONLY (tests/sim_host)
+ *  - Provides: AVR registers, sei/cli, sleep_cpu, _delay_*, EEPROM
+ *    cells, uptime, UART (TX counted, RX empty) and the I2C bus with
+ *    a DS3231 on it (time, Alarm1 in h:m:s match mode, INTCN/A1IE,
+ *    A1F, OSF)
+ *  - RTC INT is open drain to PD2: low while A1F && A1IE && INTCN
+ *  - Level-triggered INT0/INT1 run their ISR whenever global
+ *    interrupts are on, the EIMSK bit is set and the line is low
+ *  - PWR_DOWN ends only on an enabled, unmasked line; with nothing
+ *    armed the CPU sleeps to the end of the run (and that is reported)
+ *
+ * Updated: 2026-10-16
+ */
+
+#include "sim_hw.h"
+
+#include <setjmp.h>
+#include <string.h>
+
+#include <avr/io.h>
+#include <avr/sleep.h>
+#include <avr/eeprom.h>
+
+#include "platform/gpio_avr.h"
+#include "platform/i2c.h"
+#include "platform/uart.h"
+#include "uptime.h"
+
+extern "C" void INT0_vect(void);
+extern "C" void INT1_vect(void);
+
+int firmware_main(void);
+
+/* --------------------------------------------------------------------------
+ * Registers
+ * -------------------------------------------------------------------------- */
+
+volatile uint8_t DDRA, DDRB, DDRC, DDRD;
+volatile uint8_t PORTA, PORTB, PORTC, PORTD;
+volatile uint8_t PINA, PINB, PINC, PIND;
+
+volatile uint8_t EICRA, EIFR, EIMSK;
+volatile uint8_t MCUCR, MCUSR, SREG, SMCR;
+
+#define LED_PINS    ((1u << LED_IN1_BIT) | (1u << LED_IN2_BIT))
+#define RELAY_PINS  ((1u << RELAY1_SET_BIT) | (1u << RELAY1_RESET_BIT) | \
+                     (1u << RELAY2_SET_BIT) | (1u << RELAY2_RESET_BIT))
+
+/* --------------------------------------------------------------------------
+ * Simulator state
+ * -------------------------------------------------------------------------- */
+
+static uint64_t s_now_us;
+static uint64_t s_start_us;
+static uint64_t s_end_us;
+static uint64_t s_boot_us;
+static uint64_t s_boot_sleep_us;    /* sleep_us at uptime_init() */
+
+static struct sim_timing s_timing;
+static struct sim_stats  s_stats;
+
+static bool     s_irq_on;
+static bool     s_sleeping;
+static bool     s_idling;
+static uint8_t  s_sleep_mode = SLEEP_MODE_IDLE;
+
+static uint8_t  s_prev_a;
+static uint8_t  s_prev_d;
+static uint64_t s_motor_on_us;
+
+static uint32_t s_console_s;
+
+static FILE    *s_log;
+static FILE    *s_uart;
+static jmp_buf  s_done;
+
+/* --------------------------------------------------------------------------
+ * Calendar (days since 2000-01-01)
+ * -------------------------------------------------------------------------- */
+
+static int64_t civil_days(int y, int m, int d)
+{
+    y -= m <= 2;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - 719468;
+}
+
+uint64_t sim_days_from_civil(int y, int m, int d)
+{
+    return (uint64_t)(civil_days(y, m, d) - civil_days(2000, 1, 1));
+}
+
+void sim_civil_from_days(uint64_t days, int *y, int *m, int *d)
+{
+    int64_t z = (int64_t)days + civil_days(2000, 1, 1) + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp  = (5 * doy + 2) / 153;
+
+    *d = (int)(doy - (153 * mp + 2) / 5 + 1);
+    *m = (int)(mp < 10 ? mp + 3 : mp - 9);
+    *y = (int)(yoe + era * 400 + (*m <= 2));
+}
+
+/* --------------------------------------------------------------------------
+ * Transition log
+ * -------------------------------------------------------------------------- */
+
+static void log_event(const char *what, const char *detail)
+{
+    if (!s_log)
+        return;
+
+    uint64_t s  = s_now_us / 1000000u;
+    unsigned ms = (unsigned)((s_now_us / 1000u) % 1000u);
+    int y, mo, d;
+
+    sim_civil_from_days(s / 86400u, &y, &mo, &d);
+
+    unsigned sod = (unsigned)(s % 86400u);
+
+    fprintf(s_log, "%04d-%02d-%02d %02u:%02u:%02u.%03u  %-12s %s\n",
+            y, mo, d, sod / 3600u, (sod / 60u) % 60u, sod % 60u, ms,
+            what, detail);
+}
+
+/* --------------------------------------------------------------------------
+ * DS3231
+ * -------------------------------------------------------------------------- */
+
+#define DS3231_ADDR7   0x68
+#define DS_REGS        0x13
+
+#define DS_A1_SEC      0x07
+#define DS_A1_DAY      0x0A
+#define DS_CONTROL     0x0E
+#define DS_STATUS      0x0F
+
+#define DS_A1IE        (1u << 0)
+#define DS_INTCN       (1u << 2)
+#define DS_A1F         (1u << 0)
+#define DS_OSF         (1u << 7)
+
+static uint8_t s_ds[DS_REGS];
+static int64_t s_rtc_offset_s;      /* RTC seconds - simulated seconds */
+
+static uint8_t bcd(uint8_t v)   { return (uint8_t)(((v / 10u) << 4) | (v % 10u)); }
+static uint8_t unbcd(uint8_t v) { return (uint8_t)((v >> 4) * 10u + (v & 0x0Fu)); }
+
+static int64_t rtc_seconds(void)
+{
+    return (int64_t)(s_now_us / 1000000u) + s_rtc_offset_s;
+}
+
+static void ds_time_regs(uint8_t r[7])
+{
+    int64_t t = rtc_seconds();
+    int y, mo, d;
+
+    sim_civil_from_days((uint64_t)(t / 86400), &y, &mo, &d);
+
+    unsigned sod = (unsigned)(t % 86400);
+
+    r[0] = bcd((uint8_t)(sod % 60u));
+    r[1] = bcd((uint8_t)((sod / 60u) % 60u));
+    r[2] = bcd((uint8_t)(sod / 3600u));
+    r[3] = (uint8_t)((t / 86400 + 6) % 7 + 1);     /* 2000-01-01 was a Saturday */
+    r[4] = bcd((uint8_t)d);
+    r[5] = bcd((uint8_t)mo);
+    r[6] = bcd((uint8_t)(y % 100));
+}
+
+static void ds_set_time(const uint8_t r[7])
+{
+    int64_t days = (int64_t)sim_days_from_civil(2000 + unbcd(r[6]),
+                                                unbcd(r[5] & 0x1F),
+                                                unbcd(r[4] & 0x3F));
+    int64_t t = days * 86400 +
+                unbcd(r[2] & 0x3F) * 3600 +
+                unbcd(r[1] & 0x7F) * 60 +
+                unbcd(r[0] & 0x7F);
+
+    s_rtc_offset_s = t - (int64_t)(s_now_us / 1000000u);
+}
+
+static bool ds_int_asserted(void)
+{
+    return (s_ds[DS_STATUS] & DS_A1F) &&
+           (s_ds[DS_CONTROL] & DS_A1IE) &&
+           (s_ds[DS_CONTROL] & DS_INTCN);
+}
+
+/* Seconds-of-day Alarm1 matches, or -1 if not in h:m:s match mode */
+static int32_t ds_alarm_sod(void)
+{
+    const uint8_t *a = &s_ds[DS_A1_SEC];
+
+    if ((a[0] | a[1] | a[2]) & 0x80)
+        return -1;
+    if (!(a[3] & 0x80))
+        return -1;
+
+    return unbcd(a[2] & 0x3F) * 3600 + unbcd(a[1]) * 60 + unbcd(a[0]);
+}
+
+/* Simulated instant of the next Alarm1 match after now, 0 = none */
+static uint64_t ds_next_match_us(void)
+{
+    int32_t a = ds_alarm_sod();
+    if (a < 0)
+        return 0;
+
+    int64_t t    = rtc_seconds();
+    int64_t cand = (t / 86400) * 86400 + a;
+
+    if (cand <= t)
+        cand += 86400;
+
+    return (uint64_t)(cand - s_rtc_offset_s) * 1000000u;
+}
+
+static void pins_update(void)
+{
+    if (ds_int_asserted())
+        PIND &= (uint8_t)~(1u << RTC_INT_BIT);
+    else
+        PIND |= (uint8_t)(1u << RTC_INT_BIT);
+}
+
+/* Config strap: open (PC6 high) for the installer's session */
+static void strap_update(void)
+{
+    if (s_now_us < s_start_us + (uint64_t)s_console_s * 1000000u)
+        PINC |= (uint8_t)(1u << CONFIG_SW_BIT);
+    else
+        PINC &= (uint8_t)~(1u << CONFIG_SW_BIT);
+}
+
+/* --------------------------------------------------------------------------
+ * Interrupts
+ * -------------------------------------------------------------------------- */
+
+void sim_sei(void) { s_irq_on = true;  }
+void sim_cli(void) { s_irq_on = false; }
+
+static bool irq_pending(void)
+{
+    if (!s_irq_on)
+        return false;
+
+    if ((EIMSK & (1u << INT0)) && !(PIND & (1u << RTC_INT_BIT)))
+        return true;
+
+    return (EIMSK & (1u << INT1)) && !(PIND & (1u << DOOR_SW_BIT));
+}
+
+static void irq_dispatch(void)
+{
+    if (!s_irq_on)
+        return;
+
+    if ((EIMSK & (1u << INT0)) && !(PIND & (1u << RTC_INT_BIT)))
+        INT0_vect();
+
+    if ((EIMSK & (1u << INT1)) && !(PIND & (1u << DOOR_SW_BIT)))
+        INT1_vect();
+}
+
+/* --------------------------------------------------------------------------
+ * Time
+ * -------------------------------------------------------------------------- */
+
+/* Edges on the output ports since the last step */
+static void pins_sample(void)
+{
+    uint8_t a = PORTA, d = PORTD;
+    uint8_t rise_a = (uint8_t)(a & ~s_prev_a);
+    uint8_t fall_a = (uint8_t)(~a & s_prev_a);
+    uint8_t rise_d = (uint8_t)(d & ~s_prev_d);
+    char buf[48];
+
+    if (rise_a & (1u << DOOR_EN_BIT)) {
+        s_stats.motor_runs++;
+        s_stats.transitions++;
+        s_motor_on_us = s_now_us;
+        log_event("door", (a & (1u << DOOR_INA_BIT)) ? "motor on, opening" :
+                          (a & (1u << DOOR_INB_BIT)) ? "motor on, closing" :
+                                                       "motor on, no direction");
+    }
+
+    if (fall_a & (1u << DOOR_EN_BIT)) {
+        snprintf(buf, sizeof(buf), "motor off after %llu ms",
+                 (unsigned long long)((s_now_us - s_motor_on_us) / 1000u));
+        s_stats.transitions++;
+        log_event("door", buf);
+    }
+
+    if (rise_a & (1u << LOCK_EN_BIT)) {
+        s_stats.lock_pulses++;
+        s_stats.transitions++;
+        log_event("lock", (a & (1u << LOCK_INA_BIT)) ? "engage pulse" : "release pulse");
+    }
+
+    static const struct { uint8_t bit; const char *what; const char *detail; } coils[] = {
+        { RELAY1_SET_BIT,   "relay1", "set (on)"    },
+        { RELAY1_RESET_BIT, "relay1", "reset (off)" },
+        { RELAY2_SET_BIT,   "relay2", "set (on)"    },
+        { RELAY2_RESET_BIT, "relay2", "reset (off)" },
+    };
+
+    for (unsigned i = 0; i < sizeof(coils) / sizeof(coils[0]); i++) {
+        if (rise_d & (1u << coils[i].bit)) {
+            s_stats.relay_pulses++;
+            s_stats.transitions++;
+            log_event(coils[i].what, coils[i].detail);
+        }
+    }
+
+    s_prev_a = a;
+    s_prev_d = d;
+}
+
+static void step(uint64_t dt)
+{
+    pins_sample();
+
+    uint64_t to = s_now_us + dt;
+    if (to > s_end_us)
+        to = s_end_us;
+
+    dt = to - s_now_us;
+
+    if (s_sleeping)
+        s_stats.sleep_us += dt;
+    else if (s_idling)
+        s_stats.idle_us += dt;
+    else
+        s_stats.awake_us += dt;
+
+    if (PINC & (1u << CONFIG_SW_BIT)) s_stats.console_us += dt;
+
+    if (PORTA & (1u << DOOR_EN_BIT))  s_stats.motor_us += dt;
+    if (PORTA & (1u << LOCK_EN_BIT))  s_stats.lock_us  += dt;
+    if (PORTA & LED_PINS)             s_stats.led_us   += dt;
+    if (PORTD & RELAY_PINS)           s_stats.relay_us += dt;
+
+    /* Alarm1 fires when the seconds counter reaches the match */
+    uint64_t match = ds_next_match_us();
+
+    s_now_us = to;
+
+    if (match && match <= to) {
+        s_ds[DS_STATUS] |= DS_A1F;
+        pins_update();
+    }
+
+    strap_update();
+
+    if (s_now_us >= s_end_us)
+        sim_stop();
+
+    irq_dispatch();
+}
+
+void sim_advance_us(uint64_t us)
+{
+    step(us);
+}
+
+void sim_delay_us(uint32_t us)
+{
+    step(us);
+}
+
+uint64_t sim_now_us(void)
+{
+    return s_now_us;
+}
+
+void sim_set_sleep_mode(uint8_t mode)
+{
+    s_sleep_mode = mode;
+}
+
+void sim_sleep_cpu(void)
+{
+    /* Level interrupt already pending: no sleep at all */
+    if (irq_pending()) {
+        if (s_sleep_mode == SLEEP_MODE_PWR_DOWN)
+            s_stats.sleep_skips++;
+        irq_dispatch();
+        return;
+    }
+
+    /* Timer0 keeps running: back at the next 1 ms tick of uptime */
+    if (s_sleep_mode != SLEEP_MODE_PWR_DOWN) {
+        uint64_t up = s_now_us - s_boot_us - (s_stats.sleep_us - s_boot_sleep_us);
+
+        s_idling = true;
+        step(1000u - (up % 1000u));
+        s_idling = false;
+        return;
+    }
+
+    /* Only an unmasked RTC line can end the sleep in the simulation */
+    uint64_t target = s_end_us;
+
+    if (s_irq_on && (EIMSK & (1u << INT0))) {
+        uint64_t match = ds_next_match_us();
+        if (match && (s_ds[DS_CONTROL] & DS_A1IE) && (s_ds[DS_CONTROL] & DS_INTCN))
+            target = match;
+    }
+
+    if (target == s_end_us)
+        log_event("sleep", "no armed wake source; sleeping to end of run");
+
+    s_sleeping = true;
+    step(target - s_now_us);
+    s_sleeping = false;
+
+    if (!(PIND & (1u << RTC_INT_BIT)))
+        s_stats.wakes_rtc++;
+    else
+        s_stats.wakes_other++;
+}
+
+/* --------------------------------------------------------------------------
+ * uptime.h (Timer0 is not modelled: a loop pass costs loop_us; like
+ * Timer0, uptime does not advance in PWR_DOWN)
+ * -------------------------------------------------------------------------- */
+
+static uint32_t uptime_now(void)
+{
+    uint64_t slept = s_stats.sleep_us - s_boot_sleep_us;
+    return (uint32_t)((s_now_us - s_boot_us - slept) / 1000u);
+}
+
+void uptime_init(void)
+{
+    s_boot_us       = s_now_us;
+    s_boot_sleep_us = s_stats.sleep_us;
+}
+
+uint32_t uptime_millis(void)
+{
+    s_stats.loop_passes++;
+    step(s_timing.loop_us);
+    return uptime_now();
+}
+
+/* Polled inside the idle loop: not a loop pass */
+bool uptime_reached(uint32_t deadline_ms)
+{
+    return (int32_t)(uptime_now() - deadline_ms) >= 0;
+}
+
+uint32_t uptime_seconds(void)
+{
+    return uptime_millis() / 1000u;
+}
+
+/* --------------------------------------------------------------------------
+ * uart.h (console output only: sim_set_uart())
+ * -------------------------------------------------------------------------- */
+
+void uart_init(void)      {}
+void uart_shutdown(void)  {}
+void uart_flush_tx(void)  {}
+int  uart_getc(void)      { return -1; }
+void uart_rx_wake_arm(void) {}
+bool uart_rx_ready(void)  { return false; }
+void uart_putc(char c)
+{
+    s_stats.uart_tx++;
+    if (s_uart)
+        fputc(c, s_uart);
+}
+
+/* --------------------------------------------------------------------------
+ * i2c.h: one DS3231 on the bus
+ * -------------------------------------------------------------------------- */
+
+bool i2c_init(uint32_t)
+{
+    return true;
+}
+
+bool i2c_ping(uint8_t addr7)
+{
+    step(s_timing.i2c_byte_us);
+    return addr7 == DS3231_ADDR7;
+}
+
+bool i2c_read(uint8_t addr7, uint8_t reg, uint8_t *buf, uint8_t len)
+{
+    if (addr7 != DS3231_ADDR7 || !buf)
+        return false;
+
+    /* addr+W, reg, addr+R, data */
+    step((uint64_t)(3u + len) * s_timing.i2c_byte_us);
+    s_stats.i2c_xfers++;
+
+    uint8_t t[7];
+    ds_time_regs(t);
+
+    for (uint8_t i = 0; i < len; i++) {
+        uint8_t r = (uint8_t)((reg + i) % DS_REGS);
+        buf[i] = (r < 7) ? t[r] : s_ds[r];
+    }
+
+    return true;
+}
+
+bool i2c_write(uint8_t addr7, uint8_t reg, const uint8_t *buf, uint8_t len)
+{
+    if (addr7 != DS3231_ADDR7 || (!buf && len))
+        return false;
+
+    /* addr+W, reg, data */
+    step((uint64_t)(2u + len) * s_timing.i2c_byte_us);
+    s_stats.i2c_xfers++;
+
+    uint8_t t[7];
+    bool time_written = false;
+
+    ds_time_regs(t);
+
+    for (uint8_t i = 0; i < len; i++) {
+        uint8_t r = (uint8_t)((reg + i) % DS_REGS);
+
+        if (r < 7) {
+            t[r] = buf[i];
+            time_written = true;
+        } else if (r == DS_STATUS) {
+            /* Flags clear on 0, writing 1 leaves them as they are */
+            s_ds[r] = (uint8_t)((buf[i] & ~(DS_A1F | DS_OSF)) |
+                                (s_ds[r] & buf[i] & (DS_A1F | DS_OSF)));
+        } else {
+            s_ds[r] = buf[i];
+        }
+    }
+
+    if (time_written)
+        ds_set_time(t);
+
+    pins_update();
+    return true;
+}
+
+/* --------------------------------------------------------------------------
+ * avr/eeprom.h: EEMEM objects are the cells
+ * -------------------------------------------------------------------------- */
+
+void eeprom_read_block(void *dst, const void *src, size_t n)
+{
+    memcpy(dst, src, n);
+}
+
+void eeprom_update_block(const void *src, void *dst, size_t n)
+{
+    const uint8_t *s = (const uint8_t *)src;
+    uint8_t *d = (uint8_t *)dst;
+
+    for (size_t i = 0; i < n; i++) {
+        if (d[i] != s[i]) {
+            d[i] = s[i];
+            s_stats.eeprom_writes++;
+        }
+    }
+}
+
+uint8_t eeprom_read_byte(const uint8_t *p)
+{
+    return *p;
+}
+
+void eeprom_update_byte(uint8_t *p, uint8_t v)
+{
+    eeprom_update_block(&v, p, 1);
+}
+
+uint16_t eeprom_read_word(const uint16_t *p)
+{
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+void eeprom_update_word(uint16_t *p, uint16_t v)
+{
+    eeprom_update_block(&v, p, sizeof(v));
+}
+
+/* --------------------------------------------------------------------------
+ * Run control
+ * -------------------------------------------------------------------------- */
+
+void sim_begin(uint64_t start_s, uint64_t end_s, const struct sim_timing *t)
+{
+    s_now_us  = start_s * 1000000u;
+    s_start_us = s_now_us;
+    s_end_us  = end_s * 1000000u;
+    s_boot_us = s_now_us;
+    s_boot_sleep_us = 0;
+    s_timing  = *t;
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    memset(s_ds, 0, sizeof(s_ds));
+    s_rtc_offset_s = 0;
+
+    /* Power-on reset; config strap closed (RUN); door switch released */
+    MCUSR = (uint8_t)_BV(PORF);
+    PINC  = 0;
+    PIND  = (uint8_t)((1u << RTC_INT_BIT) | (1u << DOOR_SW_BIT));
+    PORTA = PORTD = 0;
+
+    s_prev_a = s_prev_d = 0;
+    s_irq_on = false;
+    s_sleeping = s_idling = false;
+
+    strap_update();
+}
+
+void sim_set_console(uint32_t secs)
+{
+    s_console_s = secs;
+}
+
+void sim_set_log(FILE *f)
+{
+    s_log = f;
+}
+
+void sim_set_uart(FILE *f)
+{
+    s_uart = f;
+}
+
+void sim_rtc_lost(void)
+{
+    s_ds[DS_STATUS] |= DS_OSF;
+}
+
+void sim_stop(void)
+{
+    longjmp(s_done, 1);
+}
+
+void sim_run(void)
+{
+    if (setjmp(s_done) == 0)
+        (void)firmware_main();
+}
+
+const struct sim_stats *sim_get_stats(void)
+{
+    return &s_stats;
+}
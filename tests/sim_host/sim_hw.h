@@ -0,0 +1,106 @@
+/*
+ * sim_hw.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Simulated ATmega1284P + DS3231 for the host firmware run
+ *
+ * Notes:
+ *  - HOST ONLY (tests/sim_host)
+ *  - Replaces exactly the drivers that touch silicon the host does not
+ *    have: i2c_avr.cpp (a DS3231 register model answers instead),
+ *    uptime.cpp, uart.cpp, and the <avr/...> headers (shim/)
+ *  - Everything else, platform drivers included, is the real code
+ *  - Time only moves when the firmware spends it: a main-loop pass
+ *    (uptime_millis), an I2C transfer, a _delay_ms, or sleep_cpu()
+ *  - SLEEP_MODE_IDLE is accounted apart from awake time; the Timer0
+ *    tick that ends it is not charged
+ *  - Port pins are sampled at every time step; on-time and edges of
+ *    the motor, lock, relay and LED outputs are accounted from them
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+
+/* Simulated seconds are counted from 2000-01-01 00:00:00 UTC */
+uint64_t sim_days_from_civil(int y, int m, int d);
+void     sim_civil_from_days(uint64_t days, int *y, int *m, int *d);
+
+/* Cost model for awake time (microseconds) */
+struct sim_timing {
+    uint32_t loop_us;       /* CPU per uptime_millis() call (one loop pass) */
+    uint32_t i2c_byte_us;   /* one byte on the bus, 9 clocks at 100 kHz */
+};
+
+/* Everything the run accumulates */
+struct sim_stats {
+    uint64_t sleep_us;
+    uint64_t idle_us;       /* SLEEP_MODE_IDLE: CPU stopped, Timer0 running */
+    uint64_t awake_us;
+
+    uint64_t motor_us;      /* door H-bridge enabled */
+    uint64_t lock_us;       /* lock H-bridge enabled */
+    uint64_t relay_us;      /* any relay coil energized */
+    uint64_t led_us;        /* either LED pin high */
+
+    uint32_t wakes_rtc;     /* sleep ended by the RTC alarm */
+    uint32_t wakes_other;   /* sleep ended by anything else */
+    uint32_t sleep_skips;   /* sleep_cpu() returned at once */
+
+    uint32_t motor_runs;
+    uint32_t lock_pulses;
+    uint32_t relay_pulses;
+    uint32_t transitions;
+
+    uint64_t loop_passes;   /* uptime_millis() calls */
+    uint64_t console_us;    /* config strap open (console attached) */
+
+    uint32_t i2c_xfers;
+    uint32_t eeprom_writes; /* bytes actually changed */
+    uint32_t uart_tx;
+};
+
+/*
+ * Start the clock at start_s (seconds since 2000-01-01 UTC) with the
+ * RTC set to that time. The run ends, via sim_stop(), the first time
+ * simulated time reaches end_s.
+ */
+void sim_begin(uint64_t start_s, uint64_t end_s, const struct sim_timing *t);
+
+/*
+ * Power on with the config strap open (console mode) and close it
+ * secs seconds later, the way an installer leaves it; 0 = closed.
+ * Call before sim_begin().
+ */
+void sim_set_console(uint32_t secs);
+
+/* Device transitions go here, one line each (NULL = not logged) */
+void sim_set_log(FILE *f);
+
+/* Console output goes here (NULL = counted only) */
+void sim_set_uart(FILE *f);
+
+/*
+ * Set the DS3231 oscillator-stop flag, as after a battery-less power
+ * loss: rtc_time_is_set() reports false. Call after sim_begin().
+ */
+void sim_rtc_lost(void);
+
+/* Current simulated time */
+uint64_t sim_now_us(void);
+
+/* Spend awake time */
+void sim_advance_us(uint64_t us);
+
+/* Finish the run: jumps back to the sim_run() caller */
+[[noreturn]] void sim_stop(void);
+
+/*
+ * Boot the firmware (main_firmware.cpp built with -Dmain=firmware_main)
+ * and return when the run ends.
+ */
+void sim_run(void);
+
+const struct sim_stats *sim_get_stats(void);
@@ -0,0 +1,28 @@
+/*
+ * avr_size_main.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Minimal AVR caller used to size the solar engines
+ *
+ * Notes:
+ *  - Linked once per engine by "make avr-size"
+ *  - volatile inputs keep the call from being folded away
+ *
+ * Updated: 2026-10-16
+ */
+
+#include "solar.h"
+
+volatile int32_t g_lat_e4 = 425000;
+volatile int32_t g_lon_e4 = -830000;
+volatile uint16_t g_sink;
+
+int main(void)
+{
+    struct solar_times sol;
+
+    if (solar_compute_e4(2026, 6, 21, g_lat_e4, g_lon_e4, 0, &sol))
+        g_sink = sol.sunrise_std;
+
+    for (;;) { }
+}
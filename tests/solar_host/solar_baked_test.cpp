@@ -0,0 +1,116 @@
+/*
+ * solar_baked_test.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Verify the compile-time (baked) solar table
+ *
+ * Notes:
+ *  - Host only (native g++)
+ *  - Built once per site with -DSOLAR_BAKED_LAT_E4 / -DSOLAR_BAKED_LON_E4
+ *    (see makefile); the table is produced by the compiler
+ *  - Every day of a leap and a common year is compared against the
+ *    runtime NOAA engine: at most one minute apart, same existence
+ *  - A different location must miss and fall through to runtime math
+ *  - tz shifts must match the engine's own tz handling
+ *
+ * Updated: 2026-10-16
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "solar_baked.h"
+#include "solar_engine.h"
+#include "time_dst.h"
+
+static int fails = 0;
+
+#define CHECK(c, ...) do { if (!(c)) { printf("FAIL: " __VA_ARGS__); printf("\n"); fails++; } } while (0)
+
+static int minute_delta(uint16_t a, uint16_t b)
+{
+    int d = (int)a - (int)b;
+
+    if (d >  720) d -= 1440;
+    if (d < -720) d += 1440;
+
+    return d < 0 ? -d : d;
+}
+
+int main(void)
+{
+    const int32_t lat_e4 = SOLAR_BAKED_LAT_E4;
+    const int32_t lon_e4 = SOLAR_BAKED_LON_E4;
+
+    printf("baked solar table: lat %.4f lon %.4f\n",
+           lat_e4 / 10000.0, lon_e4 / 10000.0);
+
+    CHECK(solar_baked_valid_for(lat_e4, lon_e4), "valid for baked site");
+
+    static const int years[] = { 2027, 2028 };
+    static const int8_t tzs[] = { 0, -5, 9 };
+
+    long days = 0, none = 0, hist[3] = { 0, 0, 0 };
+
+    for (unsigned yi = 0; yi < sizeof(years) / sizeof(years[0]); yi++) {
+        for (unsigned ti = 0; ti < sizeof(tzs) / sizeof(tzs[0]); ti++) {
+            int y = years[yi];
+            int8_t tz = tzs[ti];
+
+            for (int mo = 1; mo <= 12; mo++) {
+                for (int d = 1; d <= days_in_month(y, mo); d++) {
+
+                    struct solar_times a, b;
+                    bool have_a = false;
+
+                    bool hit = solar_baked_lookup(y, mo, d, lat_e4, lon_e4, tz,
+                                                  &a, &have_a);
+                    bool have_b = solar_noaa_compute(y, mo, d,
+                                                     lat_e4 / 10000.0,
+                                                     lon_e4 / 10000.0,
+                                                     tz, &b);
+
+                    CHECK(hit, "lookup hit %d-%02d-%02d", y, mo, d);
+                    CHECK(have_a == have_b, "existence %d-%02d-%02d tz %d",
+                          y, mo, d, tz);
+
+                    days++;
+                    if (!have_a || !have_b) {
+                        none++;
+                        continue;
+                    }
+
+                    const uint16_t va[4] = { a.sunrise_std, a.sunset_std,
+                                             a.sunrise_civ, a.sunset_civ };
+                    const uint16_t vb[4] = { b.sunrise_std, b.sunset_std,
+                                             b.sunrise_civ, b.sunset_civ };
+
+                    for (int e = 0; e < 4; e++) {
+                        int dm = minute_delta(va[e], vb[e]);
+                        hist[dm > 1 ? 2 : dm]++;
+                        CHECK(dm <= 1, "%d-%02d-%02d tz %d event %d: %u vs %u",
+                              y, mo, d, tz, e, va[e], vb[e]);
+                    }
+
+                    CHECK(a.valid_mask == SOLAR_Q_STD_CIV, "valid_mask");
+                }
+            }
+        }
+    }
+
+    printf("  %ld days (%ld without all events): events exact %ld, "
+           "1 min %ld, worse %ld\n", days, none, hist[0], hist[1], hist[2]);
+
+    /* Location changed from the console: baked table must not answer */
+    struct solar_times s;
+    bool have = true;
+    CHECK(!solar_baked_valid_for(lat_e4 + 1, lon_e4), "other lat not valid");
+    CHECK(!solar_baked_lookup(2028, 6, 1, lat_e4, lon_e4 + 1, 0, &s, &have),
+          "other lon misses");
+
+    /* Runtime fallback still computes for another location */
+    CHECK(solar_compute_e4(2028, 6, 1, 0, 0, 0, &s), "runtime fallback");
+
+    printf("\n%s\n", fails ? "FAIL" : "PASS");
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,208 @@
+/*
+ * solar_batch_test.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Host batch solar API must equal the scalar path, and be faster
+ *
+ * Notes:
+ *  - Host only (native g++, pthreads)
+ *  - Site grid: lat -65..+65 step 2.5, lon full circle step 5
+ *    (3816 sites) x one full leap year = ~1.4M (site, day) pairs
+ *  - Every pair is compared against solar_compute_e4(): validity and
+ *    all four minutes must match exactly
+ *  - A second, unordered site list (mixed longitudes, duplicates)
+ *    checks grouping does not depend on input order
+ *  - Reports scalar vs batch (1 thread, all threads) wall time
+ *
+ * Updated: 2026-10-16
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "solar_batch.h"
+
+#define YEAR   2028
+#define NDAYS  366
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+struct results {
+    uint16_t *rs, *ss, *rc, *sc;
+    bool     *ok;
+};
+
+static void results_alloc(struct results *r, size_t n)
+{
+    r->rs = (uint16_t *)calloc(n, sizeof(uint16_t));
+    r->ss = (uint16_t *)calloc(n, sizeof(uint16_t));
+    r->rc = (uint16_t *)calloc(n, sizeof(uint16_t));
+    r->sc = (uint16_t *)calloc(n, sizeof(uint16_t));
+    r->ok = (bool *)calloc(n, sizeof(bool));
+}
+
+static void results_free(struct results *r)
+{
+    free(r->rs); free(r->ss); free(r->rc); free(r->sc); free(r->ok);
+}
+
+static void batch_bind(struct solar_batch *b, struct results *r,
+                       const int32_t *lat, const int32_t *lon, size_t nsites)
+{
+    memset(b, 0, sizeof(*b));
+
+    b->nsites = nsites;
+    b->lat_e4 = lat;
+    b->lon_e4 = lon;
+    b->year   = YEAR;
+    b->month  = 1;
+    b->day    = 1;
+    b->ndays  = NDAYS;
+    b->tz     = 0;
+
+    b->sunrise_std = r->rs;
+    b->sunset_std  = r->ss;
+    b->sunrise_civ = r->rc;
+    b->sunset_civ  = r->sc;
+    b->valid       = r->ok;
+}
+
+/* Scalar reference into the same layout; returns valid count */
+static size_t scalar_run(const int32_t *lat, const int32_t *lon, size_t nsites,
+                         struct results *r)
+{
+    size_t n_ok = 0;
+
+    for (size_t s = 0; s < nsites; s++) {
+        uint8_t mo = 1, d = 1;
+        static const uint8_t mdays[12] = { 31,29,31,30,31,30,31,31,30,31,30,31 };
+
+        for (int i = 0; i < NDAYS; i++) {
+            struct solar_times t;
+            size_t k = s * NDAYS + i;
+
+            r->ok[k] = solar_compute_e4(YEAR, mo, d, lat[s], lon[s], 0, &t);
+            if (r->ok[k]) {
+                r->rs[k] = t.sunrise_std;
+                r->ss[k] = t.sunset_std;
+                r->rc[k] = t.sunrise_civ;
+                r->sc[k] = t.sunset_civ;
+                n_ok++;
+            }
+
+            if (++d > mdays[mo - 1]) { d = 1; mo++; }
+        }
+    }
+
+    return n_ok;
+}
+
+static long compare(const struct results *ref, const struct results *got, size_t n)
+{
+    long diff = 0;
+
+    for (size_t k = 0; k < n; k++) {
+        if (ref->ok[k] != got->ok[k]) {
+            diff++;
+            continue;
+        }
+        if (!ref->ok[k])
+            continue;
+
+        if (ref->rs[k] != got->rs[k] || ref->ss[k] != got->ss[k] ||
+            ref->rc[k] != got->rc[k] || ref->sc[k] != got->sc[k])
+            diff++;
+    }
+
+    return diff;
+}
+
+int main(void)
+{
+    bool pass = true;
+
+    /* ---- grid ------------------------------------------------------- */
+
+    size_t nsites = 0;
+    static int32_t lat[4096], lon[4096];
+
+    for (int32_t la = -650000; la <= 650000; la += 25000) {
+        for (int32_t lo = -1800000; lo < 1800000; lo += 50000) {
+            lat[nsites] = la;
+            lon[nsites] = lo;
+            nsites++;
+        }
+    }
+
+    const size_t n = nsites * NDAYS;
+
+    struct results ref, one, all;
+    results_alloc(&ref, n);
+    results_alloc(&one, n);
+    results_alloc(&all, n);
+
+    double t0 = now_sec();
+    size_t ok_ref = scalar_run(lat, lon, nsites, &ref);
+    double t1 = now_sec();
+
+    struct solar_batch b;
+
+    batch_bind(&b, &one, lat, lon, nsites);
+    size_t ok_one = solar_batch_compute(&b, 1);
+    double t2 = now_sec();
+
+    batch_bind(&b, &all, lat, lon, nsites);
+    size_t ok_all = solar_batch_compute(&b, 0);
+    double t3 = now_sec();
+
+    long d_one = compare(&ref, &one, n);
+    long d_all = compare(&ref, &all, n);
+
+    printf("solar batch vs scalar: %zu sites x %d days = %zu pairs\n",
+           nsites, NDAYS, n);
+    printf("  scalar          %7.3f s  (%zu valid)\n", t1 - t0, ok_ref);
+    printf("  batch 1 thread  %7.3f s  (%zu valid)  %ld differences\n",
+           t2 - t1, ok_one, d_one);
+    printf("  batch threads   %7.3f s  (%zu valid)  %ld differences\n",
+           t3 - t2, ok_all, d_all);
+
+    if (d_one || d_all || ok_one != ok_ref || ok_all != ok_ref)
+        pass = false;
+
+    /* ---- unordered sites, repeated longitudes --------------------- */
+
+    static int32_t lat2[257], lon2[257];
+    const size_t n2 = sizeof(lat2) / sizeof(lat2[0]);
+
+    srand(7);
+    for (size_t s = 0; s < n2; s++) {
+        lat2[s] = (rand() % 1300001) - 650000;
+        lon2[s] = ((rand() % 9) - 4) * 400000 + (s % 3);   /* few meridians */
+    }
+
+    struct results ref2, got2;
+    results_alloc(&ref2, n2 * NDAYS);
+    results_alloc(&got2, n2 * NDAYS);
+
+    scalar_run(lat2, lon2, n2, &ref2);
+    batch_bind(&b, &got2, lat2, lon2, n2);
+    solar_batch_compute(&b, 3);
+
+    long d2 = compare(&ref2, &got2, n2 * NDAYS);
+    printf("  unordered sites (%zu)          %ld differences\n", n2, d2);
+    if (d2)
+        pass = false;
+
+    results_free(&ref);  results_free(&one);  results_free(&all);
+    results_free(&ref2); results_free(&got2);
+
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,250 @@
+/*
+ * solar_bench.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Solar accuracy + throughput benchmark against a reference
+ *
+ * Notes:
+ *  - Host only (native g++)
+ *  - Reference: solar_reference.cpp (Meeus, iterated rise/set)
+ *  - Sweeps a lat/lon grid over every day of several years
+ *  - For each engine reports, per event type:
+ *      max / mean absolute error, mean bias, share within 1 minute,
+ *      and days where the engine and reference disagree on existence
+ *  - Throughput is calls/sec of one full struct solar_times per call
+ *  - The NOAA engine runs in double here; on AVR it runs in 32-bit
+ *    float, so treat its row as a best case for the target
+ *  - This is the baseline any faster engine has to match
+ *
+ * Updated: 2026-10-16
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "solar_engine.h"
+#include "solar_fit.h"
+#include "time_dst.h"
+#include "solar_reference.h"
+
+/* RAM-backed storage hook for the harmonic model */
+static struct solar_fit_model ram_model;
+
+void solar_fit_store_read(struct solar_fit_model *m)        { *m = ram_model; }
+void solar_fit_store_write(const struct solar_fit_model *m) { ram_model = *m; }
+
+/* --------------------------------------------------------------------------
+ * Sweep
+ * -------------------------------------------------------------------------- */
+
+static const int years[] = { 2025, 2035, 2045, 2060 };
+
+#define LAT_MIN   (-60)
+#define LAT_MAX   ( 60)
+#define LAT_STEP  ( 10)
+#define LON_STEP  ( 30)
+
+enum { ENG_NOAA, ENG_FIXED, ENG_FIT, ENG_COUNT };
+
+static const char *engine_names[ENG_COUNT] = { "noaa_float", "fixed", "fit" };
+static const char *event_names[4] = { "rise_std", "set_std", "rise_civ", "set_civ" };
+
+struct acc {
+    long   n;
+    double sum_abs;
+    double sum_signed;
+    double max_abs;
+    long   within1;
+    long   exist_mismatch;
+};
+
+static struct acc g_acc[ENG_COUNT][4];
+static long g_fit_refused;
+
+static double circ_err(double engine, double ref)
+{
+    double d = engine - ref;
+
+    if (d >  720.0) d -= 1440.0;
+    if (d < -720.0) d += 1440.0;
+
+    return d;
+}
+
+static bool run_engine(int eng, int y, int mo, int d,
+                       int32_t lat_e4, int32_t lon_e4,
+                       struct solar_event ev[4])
+{
+    solar_std_events_init(ev);
+
+    switch (eng) {
+    case ENG_NOAA:
+        solar_noaa_events(y, mo, d, lat_e4 / 10000.0, lon_e4 / 10000.0, 0, ev, 4);
+        return true;
+
+    case ENG_FIXED:
+        solar_fixed_events(y, mo, d, lat_e4, lon_e4, 0, ev, 4);
+        return true;
+
+    case ENG_FIT: {
+        struct solar_times t;
+        bool have;
+
+        if (!solar_fit_lookup(y, mo, d, lat_e4, lon_e4, &t, &have))
+            return false;
+
+        const uint16_t v[4] = { t.sunrise_std, t.sunset_std, t.sunrise_civ, t.sunset_civ };
+        for (int e = 0; e < 4; e++) {
+            ev[e].valid  = true;
+            ev[e].minute = v[e];
+        }
+        return true;
+    }
+    }
+
+    return false;
+}
+
+static void sweep(void)
+{
+    static const double altitude[4] = { -0.833, -0.833, -6.0, -6.0 };
+    static const bool   rising[4]   = { true, false, true, false };
+
+    for (int lat = LAT_MIN; lat <= LAT_MAX; lat += LAT_STEP) {
+        for (int lon = -180; lon < 180; lon += LON_STEP) {
+
+            int32_t lat_e4 = lat * 10000;
+            int32_t lon_e4 = lon * 10000;
+
+            bool fit_ok = solar_fit_build(lat_e4, lon_e4);
+            if (!fit_ok)
+                g_fit_refused++;
+
+            for (unsigned yi = 0; yi < sizeof(years) / sizeof(years[0]); yi++) {
+                int y = years[yi];
+
+                for (int mo = 1; mo <= 12; mo++) {
+                    for (int d = 1; d <= days_in_month(y, mo); d++) {
+
+                        double ref[4];
+                        bool   ref_ok[4];
+
+                        for (int e = 0; e < 4; e++)
+                            ref_ok[e] = solar_ref_event(y, mo, d, lat, lon,
+                                                        altitude[e], rising[e],
+                                                        &ref[e]);
+
+                        for (int eng = 0; eng < ENG_COUNT; eng++) {
+
+                            if (eng == ENG_FIT && !fit_ok)
+                                continue;
+
+                            struct solar_event ev[4];
+                            if (!run_engine(eng, y, mo, d, lat_e4, lon_e4, ev))
+                                continue;
+
+                            for (int e = 0; e < 4; e++) {
+                                struct acc *a = &g_acc[eng][e];
+
+                                if (ev[e].valid != ref_ok[e]) {
+                                    a->exist_mismatch++;
+                                    continue;
+                                }
+                                if (!ref_ok[e])
+                                    continue;
+
+                                double err = circ_err(ev[e].minute, ref[e]);
+
+                                a->n++;
+                                a->sum_abs    += fabs(err);
+                                a->sum_signed += err;
+                                if (fabs(err) > a->max_abs) a->max_abs = fabs(err);
+                                if (fabs(err) <= 1.0) a->within1++;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Throughput
+ * -------------------------------------------------------------------------- */
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static double calls_per_sec(int eng)
+{
+    const long iters = 300000;
+    volatile uint16_t sink = 0;
+    struct solar_times t;
+    bool have;
+
+    solar_fit_build(425000, -830000);
+
+    double t0 = now_sec();
+
+    for (long i = 0; i < iters; i++) {
+        uint8_t mo = (uint8_t)(1 + i % 12);
+        uint8_t d  = (uint8_t)(1 + i % 28);
+
+        switch (eng) {
+        case ENG_NOAA:  solar_noaa_compute(2026, mo, d, 42.5, -83.0, 0, &t); break;
+        case ENG_FIXED: solar_fixed_compute(2026, mo, d, 425000, -830000, 0, &t); break;
+        case ENG_FIT:   solar_fit_lookup(2026, mo, d, 425000, -830000, &t, &have); break;
+        }
+        sink = sink + t.sunrise_std;
+    }
+
+    return iters / (now_sec() - t0);
+}
+
+/* -------------------------------------------------------------------------- */
+
+int main(void)
+{
+    printf("solar accuracy vs Meeus reference\n");
+    printf("  lat %d..%d step %d, lon -180..%d step %d, years",
+           LAT_MIN, LAT_MAX, LAT_STEP, 180 - LON_STEP, LON_STEP);
+    for (unsigned i = 0; i < sizeof(years) / sizeof(years[0]); i++)
+        printf(" %d", years[i]);
+    printf(", every day\n\n");
+
+    sweep();
+
+    printf("  %-10s %-9s %8s %8s %8s %8s %8s %8s\n",
+           "engine", "event", "n", "max", "mean", "bias", "<=1min", "exist!=");
+
+    for (int eng = 0; eng < ENG_COUNT; eng++) {
+        for (int e = 0; e < 4; e++) {
+            const struct acc *a = &g_acc[eng][e];
+
+            printf("  %-10s %-9s %8ld %8.2f %8.3f %+8.3f %7.2f%% %8ld\n",
+                   engine_names[eng], event_names[e], a->n,
+                   a->max_abs,
+                   a->n ? a->sum_abs / a->n : 0.0,
+                   a->n ? a->sum_signed / a->n : 0.0,
+                   a->n ? 100.0 * a->within1 / a->n : 0.0,
+                   a->exist_mismatch);
+        }
+    }
+
+    if (g_fit_refused)
+        printf("\n  fit refused at %ld grid locations (no model; firmware falls back)\n",
+               g_fit_refused);
+
+    printf("\nthroughput (full solar_times per call, host)\n");
+    for (int eng = 0; eng < ENG_COUNT; eng++)
+        printf("  %-10s %12.0f calls/sec\n", engine_names[eng], calls_per_sec(eng));
+
+    return 0;
+}
@@ -0,0 +1,306 @@
+/*
+ * solar_engine_test.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Compare fixed-point solar engine against the NOAA float engine
+ *
+ * Notes:
+ *  - Host only (native g++)
+ *  - NOAA equations depend only on day-of-year, so one leap year
+ *    covers every calendar day
+ *  - Sweeps latitude -65..+65 and the full longitude range
+ *  - Fails if any event differs by more than one minute, or if the
+ *    engines disagree about whether an event exists
+ *  - Multi-day walks (solar_*_range) must equal per-day computation,
+ *    including across a year end
+ *  - Requested subsets (solar_compute_mask) must equal the full set,
+ *    and solar noon must sit midway between sunrise and sunset
+ *  - Speed is reported as host ns/call; AVR flash cost comes from
+ *    "make avr-size"
+ *
+ * Updated: 2026-10-16
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "solar_engine.h"
+
+#define LAT_MIN_E4     (-650000)
+#define LAT_MAX_E4     ( 650000)
+#define LAT_STEP_E4    (  12500)     /* 1.25 deg */
+#define LON_STEP_E4    ( 150000)     /* 15 deg   */
+
+#define MAX_DELTA_MIN  1
+
+static const char *event_names[4] = {
+    "sunrise_std", "sunset_std", "sunrise_civ", "sunset_civ"
+};
+
+struct stats {
+    long     n;
+    long     sum;
+    int      max;
+    long     hist[4];                /* |delta| 0, 1, 2, >2 */
+    int32_t  worst_lat, worst_lon;
+    int      worst_doy;
+};
+
+/* Circular minute difference (handles midnight wrap) */
+static int minute_delta(uint16_t a, uint16_t b)
+{
+    int d = (int)a - (int)b;
+
+    if (d >  720) d -= 1440;
+    if (d < -720) d += 1440;
+
+    return d < 0 ? -d : d;
+}
+
+static void date_from_doy(int doy, uint8_t *mo, uint8_t *d)
+{
+    static const uint8_t mdays[12] =
+        { 31,29,31,30,31,30,31,31,30,31,30,31 };
+
+    uint8_t m = 0;
+    while (doy > mdays[m]) {
+        doy -= mdays[m];
+        m++;
+    }
+
+    *mo = (uint8_t)(m + 1);
+    *d  = (uint8_t)doy;
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(void)
+{
+    const uint16_t year = 2028;      /* leap year: all 366 days */
+
+    struct stats st[4] = {};
+    long   cases      = 0;
+    long   polar_both = 0;
+    long   polar_diff = 0;
+
+    for (int32_t lat = LAT_MIN_E4; lat <= LAT_MAX_E4; lat += LAT_STEP_E4) {
+        for (int32_t lon = -1800000; lon < 1800000; lon += LON_STEP_E4) {
+            for (int doy = 1; doy <= 366; doy++) {
+
+                uint8_t mo, d;
+                date_from_doy(doy, &mo, &d);
+
+                struct solar_times a, b;
+
+                bool ok_f = solar_noaa_compute(year, mo, d,
+                                               lat / 10000.0,
+                                               lon / 10000.0,
+                                               0, &a);
+                bool ok_x = solar_fixed_compute(year, mo, d,
+                                                lat, lon, 0, &b);
+                cases++;
+
+                if (ok_f != ok_x) {
+                    polar_diff++;
+                    continue;
+                }
+                if (!ok_f) {
+                    polar_both++;
+                    continue;
+                }
+
+                const uint16_t fa[4] = {
+                    a.sunrise_std, a.sunset_std, a.sunrise_civ, a.sunset_civ
+                };
+                const uint16_t fb[4] = {
+                    b.sunrise_std, b.sunset_std, b.sunrise_civ, b.sunset_civ
+                };
+
+                for (int e = 0; e < 4; e++) {
+                    int dm = minute_delta(fa[e], fb[e]);
+
+                    st[e].n++;
+                    st[e].sum += dm;
+                    st[e].hist[dm > 2 ? 3 : dm]++;
+
+                    if (dm > st[e].max) {
+                        st[e].max       = dm;
+                        st[e].worst_lat = lat;
+                        st[e].worst_lon = lon;
+                        st[e].worst_doy = doy;
+                    }
+                }
+            }
+        }
+    }
+
+    printf("solar engine comparison: fixed vs NOAA float\n");
+    printf("  lat %+d..%+d deg, all longitudes, 366 days, %ld cases\n",
+           LAT_MIN_E4 / 10000, LAT_MAX_E4 / 10000, cases);
+    printf("  no event (both): %ld   existence mismatch: %ld\n\n",
+           polar_both, polar_diff);
+
+    printf("  %-12s %9s %8s %5s   %9s %9s %9s %6s\n",
+           "event", "n", "mean", "max", "=0", "=1", "=2", ">2");
+
+    bool pass = (polar_diff == 0);
+
+    for (int e = 0; e < 4; e++) {
+        printf("  %-12s %9ld %8.5f %5d   %9ld %9ld %9ld %6ld\n",
+               event_names[e], st[e].n,
+               st[e].n ? (double)st[e].sum / st[e].n : 0.0,
+               st[e].max,
+               st[e].hist[0], st[e].hist[1], st[e].hist[2], st[e].hist[3]);
+
+        if (st[e].max > MAX_DELTA_MIN) {
+            printf("    worst: lat %.4f lon %.4f doy %d\n",
+                   st[e].worst_lat / 10000.0,
+                   st[e].worst_lon / 10000.0,
+                   st[e].worst_doy);
+            pass = false;
+        }
+    }
+
+    /* ---- multi-day walk == per-day ---------------------------------- */
+
+    long range_diff = 0;
+
+    for (int32_t lat = -600000; lat <= 600000; lat += 150000) {
+        for (int32_t lon = -1800000; lon < 1800000; lon += 450000) {
+
+            struct solar_times rn[90], rx[90];
+            bool vn[90], vx[90];
+
+            solar_noaa_range(2027, 11, 15, 90, lat / 10000.0, lon / 10000.0,
+                             0, rn, vn);
+            solar_fixed_range(2027, 11, 15, 90, lat, lon, 0, rx, vx);
+
+            uint16_t y  = 2027;
+            uint8_t  mo = 11, d = 15;
+
+            for (int i = 0; i < 90; i++) {
+                struct solar_times a, b;
+                bool ok_n = solar_noaa_compute(y, mo, d, lat / 10000.0,
+                                               lon / 10000.0, 0, &a);
+                bool ok_x = solar_fixed_compute(y, mo, d, lat, lon, 0, &b);
+
+                if (ok_n != vn[i] || (ok_n && memcmp(&a, &rn[i], sizeof(a))))
+                    range_diff++;
+                if (ok_x != vx[i] || (ok_x && memcmp(&b, &rx[i], sizeof(b))))
+                    range_diff++;
+
+                static const uint8_t mdays[12] =
+                    { 31,28,31,30,31,30,31,31,30,31,30,31 };
+                if (++d > mdays[mo - 1]) {
+                    d = 1;
+                    if (++mo > 12) { mo = 1; y++; }
+                }
+            }
+        }
+    }
+
+    printf("\n  range walk vs per-day (90 days over a year end): %ld differences\n",
+           range_diff);
+    if (range_diff)
+        pass = false;
+
+    /* ---- requested subsets (solar_compute_mask) -------------------- */
+
+    long mask_diff = 0;
+    int  noon_worst = 0;
+
+    for (int32_t lat = -600000; lat <= 600000; lat += 150000) {
+        for (int32_t lon = -1800000; lon < 1800000; lon += 450000) {
+            for (int doy = 1; doy <= 366; doy += 7) {
+                uint8_t mo, d;
+                date_from_doy(doy, &mo, &d);
+
+                struct solar_times all, one, std;
+                memset(&all, 0, sizeof(all));
+                solar_compute_mask(year, mo, d, lat, lon, 0, SOLAR_Q_ALL, &all);
+
+                /* Standard + civil agree with the full computation */
+                if (solar_compute_e4(year, mo, d, lat, lon, 0, &std) &&
+                    ((all.valid_mask & SOLAR_Q_STD_CIV) != SOLAR_Q_STD_CIV ||
+                     all.sunrise_std != std.sunrise_std ||
+                     all.sunset_std  != std.sunset_std  ||
+                     all.sunrise_civ != std.sunrise_civ ||
+                     all.sunset_civ  != std.sunset_civ))
+                    mask_diff++;
+
+                /* Each quantity alone equals its value in the full set */
+                for (uint16_t q = 1; q <= SOLAR_Q_NOON; q <<= 1) {
+                    memset(&one, 0xA5, sizeof(one));
+                    one.valid_mask = 0;
+
+                    uint16_t got = solar_compute_mask(year, mo, d, lat, lon,
+                                                      0, q, &one);
+                    if (got != (all.valid_mask & q))
+                        mask_diff++;
+                }
+
+                /* Nothing requested: nothing touched */
+                memset(&one, 0x5A, sizeof(one));
+                struct solar_times before = one;
+                solar_compute_mask(year, mo, d, lat, lon, 0, 0, &one);
+                if (memcmp(&one, &before, sizeof(one)))
+                    mask_diff++;
+
+                /* Noon always exists and sits midway between rise and set */
+                if (!(all.valid_mask & SOLAR_Q_NOON)) {
+                    mask_diff++;
+                } else if ((all.valid_mask & (SOLAR_Q_STD_RISE | SOLAR_Q_STD_SET)) ==
+                           (SOLAR_Q_STD_RISE | SOLAR_Q_STD_SET)) {
+                    uint16_t mid = (uint16_t)((all.sunrise_std + all.day_length / 2) % 1440);
+                    int dm = minute_delta(all.noon, mid);
+                    if (dm > noon_worst)
+                        noon_worst = dm;
+                }
+            }
+        }
+    }
+
+    printf("\n  requested subsets vs full set: %ld differences, "
+           "noon vs rise/set midpoint max %d min\n", mask_diff, noon_worst);
+    if (mask_diff || noon_worst > 2)
+        pass = false;
+
+    /* ---- speed ---------------------------------------------------- */
+
+    const int iters = 200000;
+    volatile uint16_t sink = 0;
+    struct solar_times s;
+
+    double t0 = now_sec();
+    for (int i = 0; i < iters; i++) {
+        uint8_t mo, d;
+        date_from_doy(1 + i % 366, &mo, &d);
+        solar_noaa_compute(year, mo, d, 42.5 + (i & 7) * 0.01, -83.0,
+                           0, &s);
+        sink = sink + s.sunrise_std;
+    }
+    double t1 = now_sec();
+    for (int i = 0; i < iters; i++) {
+        uint8_t mo, d;
+        date_from_doy(1 + i % 366, &mo, &d);
+        solar_fixed_compute(year, mo, d, 425000 + (i & 7) * 100, -830000,
+                            0, &s);
+        sink = sink + s.sunrise_std;
+    }
+    double t2 = now_sec();
+
+    printf("\n  host speed: float %.0f ns/call, fixed %.0f ns/call\n",
+           (t1 - t0) * 1e9 / iters, (t2 - t1) * 1e9 / iters);
+    printf("  (target cost: run \"make avr-size\"; AVR has no FPU, so the\n"
+           "   float engine pays for soft-float + libm on every call)\n");
+
+    printf("\n%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
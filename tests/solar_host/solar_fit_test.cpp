@@ -0,0 +1,127 @@
+/*
+ * solar_fit_test.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Validate the harmonic solar model against solar_compute()
+ *
+ * Notes:
+ *  - Host only (native g++)
+ *  - Fits a model per location (RAM-backed storage hook), then compares
+ *    every date 2025..2060 against solar_compute_e4()
+ *  - Reports worst-case / mean error per event and model size
+ *  - Locations where some day lacks an event must refuse to fit
+ *
+ * Updated: 2026-10-16
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "solar_fit.h"
+#include "time_dst.h"
+
+/* RAM-backed storage hook */
+static struct solar_fit_model ram_model;
+
+void solar_fit_store_read(struct solar_fit_model *m)        { *m = ram_model; }
+void solar_fit_store_write(const struct solar_fit_model *m) { ram_model = *m; }
+
+/* Pass bound: worst-case error over 2025..2060 */
+#define MAX_ERR_MIN 2
+
+static int minute_delta(uint16_t a, uint16_t b)
+{
+    int d = (int)a - (int)b;
+
+    if (d >  720) d -= 1440;
+    if (d < -720) d += 1440;
+
+    return d < 0 ? -d : d;
+}
+
+int main(void)
+{
+    static const int32_t lats[] = {
+        -550000, -450000, -338688, -200000, 0, 200000,
+        344653, 400000, 450000, 500000, 550000
+    };
+    static const int32_t lons[] = { -1799999, -933628, -5000, 0, 1512093 };
+
+    int  fails = 0;
+    int  worst_all[4] = { 0, 0, 0, 0 };
+
+    printf("harmonic model (K=%d, %u bytes EEPROM) vs solar_compute_e4, 2025..2060\n\n",
+           SOLAR_FIT_HARMONICS, (unsigned)sizeof(struct solar_fit_model));
+    printf("  %8s %9s   %-15s %-15s %-15s %-15s\n", "lat", "lon",
+           "rise_std", "set_std", "rise_civ", "set_civ");
+
+    for (unsigned a = 0; a < sizeof(lats) / sizeof(lats[0]); a++) {
+        for (unsigned o = 0; o < sizeof(lons) / sizeof(lons[0]); o++) {
+
+            int32_t lat = lats[a], lon = lons[o];
+
+            if (!solar_fit_build(lat, lon)) {
+                printf("  %8.4f %9.4f   FIT REFUSED\n", lat / 1e4, lon / 1e4);
+                fails++;
+                continue;
+            }
+
+            int  worst[4] = { 0, 0, 0, 0 };
+            long sum[4]   = { 0, 0, 0, 0 };
+            long n        = 0;
+
+            for (int y = 2025; y <= 2060; y++) {
+                for (int mo = 1; mo <= 12; mo++) {
+                    for (int d = 1; d <= days_in_month(y, mo); d++) {
+
+                        struct solar_times f, c;
+                        bool have;
+
+                        if (!solar_fit_lookup(y, mo, d, lat, lon, &f, &have) ||
+                            !solar_compute_e4(y, mo, d, lat, lon, 0, &c)) {
+                            fails++;
+                            continue;
+                        }
+
+                        const int dm[4] = {
+                            minute_delta(f.sunrise_std, c.sunrise_std),
+                            minute_delta(f.sunset_std,  c.sunset_std),
+                            minute_delta(f.sunrise_civ, c.sunrise_civ),
+                            minute_delta(f.sunset_civ,  c.sunset_civ),
+                        };
+
+                        for (int e = 0; e < 4; e++) {
+                            sum[e] += dm[e];
+                            if (dm[e] > worst[e]) worst[e] = dm[e];
+                        }
+                        n++;
+                    }
+                }
+            }
+
+            printf("  %8.4f %9.4f  ", lat / 1e4, lon / 1e4);
+            for (int e = 0; e < 4; e++) {
+                printf(" max %d mean %.2f ", worst[e], (double)sum[e] / n);
+                if (worst[e] > worst_all[e]) worst_all[e] = worst[e];
+                if (worst[e] > MAX_ERR_MIN) fails++;
+            }
+            printf("\n");
+        }
+    }
+
+    printf("\n  worst: rise_std %d  set_std %d  rise_civ %d  set_civ %d (minutes)\n",
+           worst_all[0], worst_all[1], worst_all[2], worst_all[3]);
+
+    /* No civil dusk around the June solstice: must refuse */
+    if (solar_fit_build(645000, -1478000)) {
+        printf("FAIL: fitted a location without year-round events\n");
+        fails++;
+    }
+    if (solar_fit_valid_for(645000, -1478000)) {
+        printf("FAIL: refused model reported valid\n");
+        fails++;
+    }
+
+    printf("\n%s\n", fails ? "FAIL" : "PASS");
+    return fails ? 1 : 0;
+}
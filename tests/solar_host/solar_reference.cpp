@@ -0,0 +1,138 @@
+/*
+ * solar_reference.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: High-precision solar reference for host-side accuracy tests
+ *
+ * Notes:
+ *  - See solar_reference.h
+ *  - Delta T fixed at 69 s (2025 value; drifts < 1 s/yr, far below
+ *    the minute resolution under test)
+ *
+ * Updated: 2026-10-16
+ */
+
+#include "solar_reference.h"
+#include <math.h>
+
+static constexpr double PI      = 3.14159265358979323846;
+static constexpr double DEG2RAD = PI / 180.0;
+static constexpr double RAD2DEG = 180.0 / PI;
+
+static constexpr double DELTA_T_DAYS = 69.0 / 86400.0;
+
+/* Normalize degrees to [0, 360) */
+static double norm360(double a)
+{
+    a = fmod(a, 360.0);
+    return (a < 0.0) ? a + 360.0 : a;
+}
+
+/* Normalize degrees to [-180, 180) */
+static double norm180(double a)
+{
+    a = norm360(a + 180.0);
+    return a - 180.0;
+}
+
+/* Julian day of 0h UT for a Gregorian civil date (Meeus ch. 7) */
+static double julian_day(int y, int m, int d)
+{
+    if (m <= 2) {
+        y -= 1;
+        m += 12;
+    }
+
+    int A = y / 100;
+    int B = 2 - A + A / 4;
+
+    return floor(365.25 * (y + 4716)) +
+           floor(30.6001 * (m + 1)) +
+           d + B - 1524.5;
+}
+
+/* Apparent right ascension / declination (degrees) at JDE (Meeus ch. 25) */
+static void sun_position(double jde, double *ra, double *dec)
+{
+    double T = (jde - 2451545.0) / 36525.0;
+
+    double L0 = norm360(280.46646 + 36000.76983 * T + 0.0003032 * T * T);
+    double M  = norm360(357.52911 + 35999.05029 * T - 0.0001537 * T * T);
+    double Mr = M * DEG2RAD;
+
+    double C = (1.914602 - 0.004817 * T - 0.000014 * T * T) * sin(Mr)
+             + (0.019993 - 0.000101 * T) * sin(2.0 * Mr)
+             + 0.000289 * sin(3.0 * Mr);
+
+    double theta = L0 + C;
+
+    double omega  = (125.04 - 1934.136 * T) * DEG2RAD;
+    double lambda = (theta - 0.00569 - 0.00478 * sin(omega)) * DEG2RAD;
+
+    double eps0 = 23.0 + (26.0 + (21.448 - T * (46.8150 + T * (0.00059 - T * 0.001813))) / 60.0) / 60.0;
+    double eps  = (eps0 + 0.00256 * cos(omega)) * DEG2RAD;
+
+    *ra  = norm360(RAD2DEG * atan2(cos(eps) * sin(lambda), cos(lambda)));
+    *dec = RAD2DEG * asin(sin(eps) * sin(lambda));
+}
+
+/* Greenwich mean sidereal time (degrees) at JD (UT) (Meeus ch. 12) */
+static double gmst(double jd)
+{
+    double T = (jd - 2451545.0) / 36525.0;
+
+    return norm360(280.46061837 +
+                   360.98564736629 * (jd - 2451545.0) +
+                   T * T * (0.000387933 - T / 38710000.0));
+}
+
+bool solar_ref_event(int year, int month, int day,
+                     double lat, double lon,
+                     double altitude_deg,
+                     bool sunrise,
+                     double *minute_out)
+{
+    double jd0 = julian_day(year, month, day);
+
+    /* Start at local 06:00 / 18:00 mean solar time, in UT */
+    double jd = jd0 + ((sunrise ? 6.0 : 18.0) - lon / 15.0) / 24.0;
+
+    double sin_h0  = sin(altitude_deg * DEG2RAD);
+    double sin_lat = sin(lat * DEG2RAD);
+    double cos_lat = cos(lat * DEG2RAD);
+
+    for (int iter = 0; iter < 20; iter++) {
+
+        double ra, dec;
+        sun_position(jd + DELTA_T_DAYS, &ra, &dec);
+
+        double cosH = (sin_h0 - sin_lat * sin(dec * DEG2RAD)) /
+                      (cos_lat * cos(dec * DEG2RAD));
+
+        if (cosH > 1.0 || cosH < -1.0)
+            return false;
+
+        double H_req = RAD2DEG * acos(cosH);
+        if (sunrise)
+            H_req = -H_req;
+
+        /* Current local hour angle */
+        double H = norm180(gmst(jd) + lon - ra);
+
+        /* Sidereal degrees → days */
+        double dt = norm180(H_req - H) / 360.98564736629;
+
+        jd += dt;
+
+        if (fabs(dt) < 1.0 / 864000.0)
+            break;
+    }
+
+    double m = (jd - floor(jd + 0.5) + 0.5) * 1440.0;
+
+    if (m < 0.0)     m += 1440.0;
+    if (m >= 1440.0) m -= 1440.0;
+
+    *minute_out = m;
+    return true;
+}
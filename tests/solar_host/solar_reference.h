@@ -0,0 +1,39 @@
+/*
+ * solar_reference.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: High-precision solar reference for host-side accuracy tests
+ *
+ * Notes:
+ *  - Host only, double precision, never linked into firmware
+ *  - Sun position per Meeus, "Astronomical Algorithms" ch. 25
+ *    (apparent longitude with nutation + aberration, ~0.01 deg),
+ *    sidereal time per ch. 12
+ *  - Rise/set found by iterating the hour angle to convergence
+ *    (< 0.1 s), not by a single fixed anchor like NOAA
+ *  - Same altitude thresholds as solar.cpp:
+ *      -0.833 deg  official sunrise/sunset
+ *      -6.0   deg  civil dawn/dusk
+ *
+ * Updated: 2026-10-16
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * One rise or set event for the given civil date at (lat, lon),
+ * nearest to local 06:00 (rise) or 18:00 (set) mean solar time —
+ * the same event solar_compute() reports for that date.
+ *
+ * Output:
+ *  - minute_out: UTC minute-of-day, fractional (0 <= m < 1440)
+ *
+ * Returns false if the sun does not reach the altitude.
+ */
+bool solar_ref_event(int year, int month, int day,
+                     double lat, double lon,
+                     double altitude_deg,
+                     bool sunrise,
+                     double *minute_out);
@@ -0,0 +1,136 @@
+/*
+ * solar_table_test.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Verify the day-of-year solar table against direct computation
+ *
+ * Notes:
+ *  - Host only (native g++)
+ *  - Storage hooks are backed by a RAM image of the EEPROM region
+ *  - Checks every date 2025..2060 at several locations, including a
+ *    high latitude with days that have no civil twilight
+ *  - Checks a table for another location is never used
+ *  - Checks the solar service memo: repeat gets and subsets do not
+ *    recompute, a superset recomputes once, invalidate/location miss
+ *
+ * Updated: 2026-10-16
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "solar_service.h"
+#include "solar_table.h"
+#include "time_dst.h"
+
+/* --------------------------------------------------------------------------
+ * RAM-backed storage hooks
+ * -------------------------------------------------------------------------- */
+
+static struct solar_table_hdr ram_hdr;
+static uint8_t ram_data[SOLAR_TABLE_DATA_BYTES];
+
+void solar_table_store_read_hdr(struct solar_table_hdr *hdr)        { *hdr = ram_hdr; }
+void solar_table_store_write_hdr(const struct solar_table_hdr *hdr) { ram_hdr = *hdr; }
+
+void solar_table_store_read_day(uint16_t i, uint8_t buf[SOLAR_TABLE_DAY_BYTES])
+{
+    memcpy(buf, &ram_data[i * SOLAR_TABLE_DAY_BYTES], SOLAR_TABLE_DAY_BYTES);
+}
+
+void solar_table_store_write_day(uint16_t i, const uint8_t buf[SOLAR_TABLE_DAY_BYTES])
+{
+    memcpy(&ram_data[i * SOLAR_TABLE_DAY_BYTES], buf, SOLAR_TABLE_DAY_BYTES);
+}
+
+/* -------------------------------------------------------------------------- */
+
+static int fails = 0;
+
+#define CHECK(c, ...) do { if (!(c)) { printf("FAIL: " __VA_ARGS__); printf("\n"); fails++; } } while (0)
+
+static void check_location(int32_t lat_e4, int32_t lon_e4)
+{
+    solar_table_build(lat_e4, lon_e4);
+    CHECK(solar_table_valid_for(lat_e4, lon_e4), "valid after build");
+
+    long days = 0, none = 0;
+
+    for (int y = 2025; y <= 2060; y++) {
+        for (int mo = 1; mo <= 12; mo++) {
+            for (int d = 1; d <= days_in_month(y, mo); d++) {
+
+                struct solar_times a, b;
+                bool have_t;
+
+                bool hit = solar_table_lookup(y, mo, d, lat_e4, lon_e4,
+                                              &a, &have_t);
+                bool have_c = solar_compute_e4(y, mo, d, lat_e4, lon_e4,
+                                               0, &b);
+
+                CHECK(hit, "lookup hit %d-%d-%d", y, mo, d);
+                CHECK(have_t == have_c, "existence %d-%d-%d lat %ld (table %d)", y, mo, d, (long)lat_e4, have_t);
+
+                if (have_t && have_c)
+                    CHECK(memcmp(&a, &b, sizeof(a)) == 0,
+                          "times %d-%d-%d lat %ld", y, mo, d, (long)lat_e4);
+
+                days++;
+                if (!have_c) none++;
+            }
+        }
+    }
+
+    printf("  lat %8.4f lon %9.4f: %ld days, %ld without events\n",
+           lat_e4 / 10000.0, lon_e4 / 10000.0, days, none);
+}
+
+int main(void)
+{
+    printf("solar table vs solar_compute_e4 (2025..2060)\n");
+
+    check_location( 344653,  -933628);   /* default config */
+    check_location(-338688,  1512093);   /* southern hemisphere */
+    check_location( 645000, -1478000);   /* no civil dusk near solstice */
+    check_location(      0,  1799999);   /* equator, date line */
+
+    /* Stale key must miss */
+    solar_table_build(344653, -933628);
+    struct solar_times s;
+    bool have;
+    CHECK(!solar_table_valid_for(344654, -933628), "key mismatch rejected");
+    CHECK(!solar_table_lookup(2026, 6, 1, 344654, -933628, &s, &have),
+          "stale lookup misses");
+
+    /* Fallback path still answers */
+    CHECK(solar_table_get(2026, 6, 1, 344654, -933628, &s), "fallback compute");
+
+    /* Solar service memo */
+    struct solar_times m;
+    uint32_t c0 = solar_service_computes();
+
+    CHECK(solar_service_get(2026, 6, 1, 344653, -933628, SOLAR_Q_STD_CIV, &m)
+          == SOLAR_Q_STD_CIV, "service std/civ");
+    CHECK(solar_table_get(2026, 6, 1, 344653, -933628, &s) &&
+          memcmp(&m, &s, sizeof(m)) == 0, "service equals table");
+    solar_service_get(2026, 6, 1, 344653, -933628, SOLAR_Q_STD_CIV, &m);
+    solar_service_get(2026, 6, 1, 344653, -933628, SOLAR_Q_STD_RISE, &m);
+    CHECK(solar_service_computes() == c0 + 1, "repeat/subset memoized");
+
+    CHECK(solar_service_get(2026, 6, 1, 344653, -933628, SOLAR_Q_NOON, &m)
+          == SOLAR_Q_NOON, "service noon");
+    CHECK((m.valid_mask & SOLAR_Q_STD_CIV) == SOLAR_Q_STD_CIV, "superset kept");
+    solar_service_get(2026, 6, 1, 344653, -933628, SOLAR_Q_ALL, &m);
+    solar_service_get(2026, 6, 1, 344653, -933628, SOLAR_Q_NOON, &m);
+    CHECK(solar_service_computes() == c0 + 3, "superset once");
+
+    solar_service_get(2026, 6, 1, 344654, -933628, SOLAR_Q_STD_CIV, &m);
+    CHECK(solar_service_computes() == c0 + 4, "location change misses");
+
+    solar_service_invalidate();
+    solar_service_get(2026, 6, 1, 344653, -933628, SOLAR_Q_STD_CIV, &m);
+    CHECK(solar_service_computes() == c0 + 5, "invalidate misses");
+
+    printf("\n%s\n", fails ? "FAIL" : "PASS");
+    return fails ? 1 : 0;
+}